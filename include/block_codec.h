@@ -0,0 +1,36 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Block Codec
+//
+// A small LZ77 byte codec in the LZ4 block layout: each sequence is a token
+// (literal length : match length - 4, four bits each, 15 = more bytes
+// follow), the literals, then a 16-bit little-endian match offset.  The
+// final sequence is literals only.  Matches are found through a 4-byte
+// hash table with a single candidate per bucket, so compression is one
+// forward pass with no entropy stage: built for speed on journal blocks,
+// whose records repeat symbols, ids and (mostly empty) padding.
+//
+// Blocks are compressed independently, at most 64 KiB apart per match, so
+// any block decodes on its own.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MarketMicroStructure
+{
+/// @brief Largest output blockCompress() can produce for @p bytes of input.
+constexpr std::size_t blockCompressBound( std::size_t bytes )
+{
+    return bytes + bytes / 255 + 16;
+}
+
+/// @brief Compresses @p size bytes from @p src into @p dst.  Returns the
+/// compressed size, or 0 if it would not fit in @p capacity.
+std::size_t blockCompress( const std::uint8_t* src, std::size_t size, std::uint8_t* dst, std::size_t capacity );
+
+/// @brief Decodes @p size bytes from @p src into exactly @p raw_size bytes
+/// at @p dst.  False if the input is malformed or decodes to another size.
+bool blockDecompress( const std::uint8_t* src, std::size_t size, std::uint8_t* dst, std::size_t raw_size );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,124 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Mapped Book File
+//
+// A file-backed MAP_SHARED region that SimMatchingEngine keeps its books,
+// order index and counters in, so a restarted process gets the exact book
+// state back by mapping the file: no replay, no deserialisation, and a
+// restart cost that does not depend on how many orders rest.
+//
+//   - The region is a std::pmr::memory_resource handing out power-of-two
+//     blocks (64 bytes and up) from a bump pointer, with one free list per
+//     size.  Free-list links, the bump pointer and the root are offsets
+//     from the start of the mapping, so the allocator's own state survives
+//     a remap at another address like everything else in it.
+//   - The file is created sparse at its full capacity and never remapped,
+//     so the base is stable for the process; pages are faulted in as the
+//     books reach them, on restart as well.
+//   - The header records a layout signature of the persisted types.  A
+//     file written by a build with a different layout is refused rather
+//     than misread.
+//
+// Writes reach the page cache as they happen, so the state survives the
+// process being killed; flush() (msync) is what makes it survive the
+// machine.  The region is not thread-safe: it belongs to the matching thread.
+// Allocation past the capacity throws std::bad_alloc, so the owner checks
+// fits() before any step that may grow a structure; SimMatchingEngine
+// rejects an order whose worst-case growth the file could not hold.  The
+// header also counts the bytes live blocks were asked for, so the cost of
+// rounding every request up to a power of two can be reported.
+// ============================================================================
+
+#include <book_storage.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+namespace MarketMicroStructure
+{
+class MappedBookFile : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t DefaultCapacity = std::size_t{ 1 } << 30;
+
+    /// @brief Maps @p path, creating it with room for @p capacity bytes if
+    /// it does not exist.  An existing file keeps its own capacity and must
+    /// carry @p layout.
+    static std::expected<std::unique_ptr<MappedBookFile>, std::string> open( const std::string& path, std::uint64_t layout,
+                                                                            std::size_t capacity = DefaultCapacity );
+
+    ~MappedBookFile() override;
+
+    MappedBookFile( const MappedBookFile& )            = delete;
+    MappedBookFile& operator=( const MappedBookFile& ) = delete;
+
+    /// @brief True if the file existed: root() points at the state of the
+    /// process that wrote it.
+    bool restored() const { return restored_; }
+
+    /// @brief Offset of the owner's root object, 0 until setRoot().
+    std::uint64_t root() const;
+    void setRoot( std::uint64_t offset );
+
+    BookStorage storage() { return BookStorage( this, base_ ); }
+
+    /// @brief Writes every dirty page back to the file (msync).
+    bool flush();
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t usedBytes() const;
+    const std::string& path() const { return path_; }
+
+    /// @brief Size of the block a request of @p bytes takes (0 for 0).
+    static std::size_t blockBytes( std::size_t bytes );
+
+    /// @brief True if every request in @p requests (ranges of byte counts)
+    /// can be served together: from a free list (one block per size class
+    /// is counted on) or else from the unused tail of the file.
+    template <typename... Requests>
+    bool fits( const Requests&... requests ) const
+    {
+        std::size_t needed    = 0;
+        std::uint64_t claimed = 0;
+        const auto add        = [this, &needed, &claimed]( const auto& range )
+        {
+            for ( const std::size_t bytes : range )
+            {
+                needed += tailBytes( bytes, claimed );
+            }
+        };
+        ( add( requests ), ... );
+        return needed <= capacity_ - usedBytes();
+    }
+
+    /// @brief Bytes in blocks handed out and not freed, and the bytes those
+    /// blocks were asked for: the difference is power-of-two rounding.
+    std::size_t liveBlockBytes() const;
+    std::size_t liveRequestedBytes() const;
+
+private:
+    struct Header;
+
+    /// @brief Tail bytes a request of @p bytes takes: 0 if a free block of
+    /// its size class is left unclaimed in @p claimed (which it then claims).
+    std::size_t tailBytes( std::size_t bytes, std::uint64_t& claimed ) const;
+
+    MappedBookFile( std::string path, std::byte* base, std::size_t capacity, bool restored );
+
+    Header& header() const { return *reinterpret_cast<Header*>( base_ ); }
+
+    void* do_allocate( std::size_t bytes, std::size_t alignment ) override;
+    void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override;
+    bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+
+    std::string path_;
+    std::byte* base_;
+    std::size_t capacity_;
+    bool restored_;
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,179 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Book Storage
+//
+// BookStorage names where a book's pools live, and BookVector is the array
+// type the pools are made of (SimOrderBook's node pool, cold table and
+// ladders, OrderIndex slots and CountingBloomFilter counters).
+//
+// A BookVector records its buffer as an offset from its storage's base,
+// never as a pointer, so a structure built of BookVectors and indices means
+// the same thing wherever its memory is mapped:
+//   - heap storage (a SymbolArena or any pmr resource) has base 0, so an
+//     offset is simply the address
+//   - mapped storage (MappedBookFile) has the mapping as its base, so a
+//     book written by one process is valid in the next one
+// The data pointer each BookVector caches for the hot path is process-local
+// and is recomputed by rebind(): one add per array, whatever its length.
+//
+// Elements must be trivially copyable: growth moves them with memcpy and a
+// mapped book is used in place, without running any constructor.
+// ============================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace MarketMicroStructure
+{
+class BookStorage
+{
+public:
+    /// @brief Heap storage: offsets are addresses.
+    explicit BookStorage( std::pmr::memory_resource* resource ) : resource_( resource ) {}
+
+    /// @brief Storage carved by @p resource out of a mapping at @p base:
+    /// offsets are relative to @p base.
+    BookStorage( std::pmr::memory_resource* resource, const std::byte* base )
+        : resource_( resource ), base_( reinterpret_cast<std::uintptr_t>( base ) )
+    {
+    }
+
+    std::uint64_t allocate( std::size_t bytes, std::size_t alignment ) { return offsetOf( resource_->allocate( bytes, alignment ) ); }
+    void deallocate( std::uint64_t offset, std::size_t bytes, std::size_t alignment ) { resource_->deallocate( at<void>( offset ), bytes, alignment ); }
+
+    template <typename T>
+    T* at( std::uint64_t offset ) const
+    {
+        return reinterpret_cast<T*>( base_ + offset );
+    }
+
+    std::uint64_t offsetOf( const void* p ) const { return reinterpret_cast<std::uintptr_t>( p ) - base_; }
+
+private:
+    std::pmr::memory_resource* resource_;
+    std::uintptr_t base_{ 0 };
+};
+
+template <typename T>
+class BookVector
+{
+    static_assert( std::is_trivially_copyable_v<T>, "BookVector elements are moved with memcpy and mapped in place" );
+
+public:
+    explicit BookVector( BookStorage storage ) : storage_( storage ) {}
+    ~BookVector() { release(); }
+
+    BookVector( const BookVector& )            = delete;
+    BookVector& operator=( const BookVector& ) = delete;
+
+    /// @brief Re-derives the cached data pointer after the vector's memory
+    /// was mapped by another process (or at another address).
+    void rebind( BookStorage storage )
+    {
+        storage_ = storage;
+        data_    = capacity_ != 0 ? storage_.at<T>( offset_ ) : nullptr;
+    }
+
+    BookStorage storage() const { return storage_; }
+
+    std::size_t size() const { return static_cast<std::size_t>( size_ ); }
+    std::size_t capacity() const { return static_cast<std::size_t>( capacity_ ); }
+    bool empty() const { return size_ == 0; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T& operator[]( std::size_t i ) { return data_[i]; }
+    const T& operator[]( std::size_t i ) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    void reserve( std::size_t capacity )
+    {
+        if ( capacity > capacity_ )
+        {
+            reallocate( capacity );
+        }
+    }
+
+    /// @brief Bytes the next emplace_back() asks the storage for; 0 if it fits.
+    std::size_t appendBytes() const { return size_ == capacity_ ? std::max<std::size_t>( 8, 2 * capacity() ) * sizeof( T ) : 0; }
+
+    /// @brief Appends a value-initialised element.
+    T& emplace_back()
+    {
+        if ( size_ == capacity_ )
+        {
+            reallocate( std::max<std::size_t>( 8, 2 * capacity() ) );
+        }
+        return *::new ( static_cast<void*>( data_ + size_++ ) ) T{};
+    }
+
+    /// @brief Replaces the contents with @p count copies of @p value.
+    void assign( std::size_t count, const T& value )
+    {
+        size_ = 0;
+        reserve( count );
+        std::uninitialized_fill_n( data_, count, value );
+        size_ = count;
+    }
+
+    void clear() { size_ = 0; }
+
+    void swap( BookVector& other ) noexcept
+    {
+        std::swap( offset_, other.offset_ );
+        std::swap( size_, other.size_ );
+        std::swap( capacity_, other.capacity_ );
+        std::swap( storage_, other.storage_ );
+        std::swap( data_, other.data_ );
+    }
+
+private:
+    void reallocate( std::size_t capacity )
+    {
+        const std::uint64_t offset = storage_.allocate( capacity * sizeof( T ), alignof( T ) );
+        T* data                    = storage_.at<T>( offset );
+        if ( size_ != 0 )
+        {
+            std::memcpy( static_cast<void*>( data ), data_, size() * sizeof( T ) );
+        }
+        const std::uint64_t size = size_;
+        release();
+        offset_   = offset;
+        size_     = size;
+        capacity_ = capacity;
+        data_     = data;
+    }
+
+    void release()
+    {
+        if ( capacity_ != 0 )
+        {
+            storage_.deallocate( offset_, capacity() * sizeof( T ), alignof( T ) );
+        }
+        offset_   = 0;
+        size_     = 0;
+        capacity_ = 0;
+        data_     = nullptr;
+    }
+
+    // Persistent: meaningful in any process that maps the storage.
+    std::uint64_t offset_{ 0 };
+    std::uint64_t size_{ 0 };
+    std::uint64_t capacity_{ 0 };
+
+    // Process-local, re-derived by rebind().
+    BookStorage storage_;
+    T* data_{ nullptr };
+};
+
+}  // namespace MarketMicroStructure
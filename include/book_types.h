@@ -0,0 +1,85 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Book Types
+//
+// Small value types shared by SimOrderBook, OrderIndex and SimMatchingEngine.
+// Price and quantity types are taken from HFTToolset::Order so the simulation
+// book always agrees with the events it is fed.
+// ============================================================================
+
+#include <common/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+namespace MarketMicroStructure
+{
+using OrderPrice = decltype( HFTToolset::Order::price );
+using OrderQty   = decltype( HFTToolset::Order::quantity );
+using OrderKey   = decltype( HFTToolset::Order::id );
+using TraderKey  = decltype( HFTToolset::Order::trader_id );
+
+/// @brief Price in ticks and quantity in lots, as stored inside a book.
+/// Orders whose price or quantity does not fit are rejected at submit().
+using Ticks   = std::uint32_t;
+using NodeQty = std::uint32_t;
+
+/// @brief Per-symbol price and quantity grid, fixed at add_symbol().
+/// Prices are carried inside the book as tick counts (price / tick_size)
+/// and quantities as lot counts (quantity / lot_size); both are converted
+/// back to HFTToolset units only for trades, market data and reports.
+struct SymbolSpec
+{
+    OrderPrice tick_size{ 1 };
+    OrderQty lot_size{ 1 };
+};
+
+/// @brief Index of an order node inside its symbol's node pool.
+using NodeIndex                       = std::uint32_t;
+inline constexpr NodeIndex NilNode    = std::numeric_limits<NodeIndex>::max();
+using SymbolIndex                     = std::uint32_t;
+inline constexpr SymbolIndex NoSymbol = std::numeric_limits<SymbolIndex>::max();
+
+/// @brief One fill between a resting (maker) and an incoming (taker) order.
+struct SimTrade
+{
+    SymbolIndex symbol{ NoSymbol };
+    OrderKey maker_id{};
+    OrderKey taker_id{};
+    TraderKey maker_trader{};
+    TraderKey taker_trader{};
+    OrderPrice price{};
+    OrderQty quantity{};
+    HFTToolset::Side aggressor_side{ HFTToolset::Side::Buy };
+    HFTToolset::Timestamp time{};
+};
+
+using SimTradeCallback = std::function<void( const SimTrade& )>;
+
+/// @brief Order-flow counters kept by the simulation-layer engines.
+struct EngineStats
+{
+    std::uint64_t accepted{ 0 };
+    std::uint64_t rejected{ 0 };
+    std::uint64_t cancelled{ 0 };
+    std::uint64_t cancel_rejects{ 0 };
+    std::uint64_t cancel_filtered{ 0 };  ///< Cancel rejects answered by the Bloom filter alone
+    std::uint64_t storage_rejects{ 0 };  ///< Rejects because the book file could not hold the order's growth
+};
+
+/// @brief Per-symbol market data state kept next to the book.
+struct MarketDataState
+{
+    OrderPrice best_bid{};
+    OrderQty best_bid_qty{};
+    OrderPrice best_ask{};
+    OrderQty best_ask_qty{};
+    OrderPrice last_trade_price{};
+    OrderQty last_trade_qty{};
+    OrderQty traded_volume{};
+    std::uint64_t trade_count{ 0 };
+    std::uint64_t tob_updates{ 0 };
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,42 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Clock Reference
+//
+// Non-owning, type-erased reference to anything with a now() returning a
+// nanosecond Timestamp: HFTToolset::Clock, TscClock, or a test clock.  The
+// simulation-layer engines take a ClockRef instead of HFTToolset::Clock& so
+// the time source is injectable; existing call sites that pass a Clock keep
+// compiling unchanged.  One indirect call per now().
+// ============================================================================
+
+#include <common/types.h>
+
+#include <concepts>
+#include <type_traits>
+
+namespace MarketMicroStructure
+{
+template <typename C>
+concept NanosecondClock = requires( C& clock ) {
+    { clock.now() } -> std::convertible_to<HFTToolset::Timestamp>;
+};
+
+class ClockRef
+{
+public:
+    template <NanosecondClock C>
+        requires( !std::same_as<std::remove_const_t<C>, ClockRef> )
+    ClockRef( C& clock )  // NOLINT(google-explicit-constructor): implicit by design
+        : clock_( const_cast<std::remove_const_t<C>*>( &clock ) ),
+          now_( []( void* c ) -> HFTToolset::Timestamp { return static_cast<C*>( c )->now(); } )
+    {
+    }
+
+    HFTToolset::Timestamp now() const { return now_( clock_ ); }
+
+private:
+    void* clock_;
+    HFTToolset::Timestamp ( *now_ )( void* );
+};
+
+}  // namespace MarketMicroStructure
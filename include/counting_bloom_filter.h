@@ -0,0 +1,101 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Counting Bloom Filter
+//
+// Membership pre-check for order ids, kept in step with OrderIndex on every
+// insert and erase.  A negative answer is certain, so a cancel for an id
+// that is not resting is rejected without probing the index.
+//
+//   - 8-bit counters, so ids can be removed as well as added; a counter
+//     that reaches 255 sticks there (it can only cause false positives)
+//   - Blocked layout: all Hashes counters of an id fall in one 64-byte
+//     block, so a query costs one cache line
+//   - Sized at OrderIndex::FilterCountersPerSlot counters per index slot
+//   - Counters live in a BookVector, so the filter can be kept in a
+//     MappedBookFile along with the index it shadows
+// ============================================================================
+
+#include <book_storage.h>
+#include <book_types.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace MarketMicroStructure
+{
+class CountingBloomFilter
+{
+public:
+    static constexpr std::size_t BlockBytes = 64;
+    static constexpr unsigned Hashes        = 3;
+
+    explicit CountingBloomFilter( BookStorage storage ) : counters_( storage ) {}
+
+    /// @brief See BookVector::rebind().
+    void rebind( BookStorage storage ) { counters_.rebind( storage ); }
+
+    /// @brief Resizes to at least @p counters counters and empties the filter.
+    void reset( std::size_t counters );
+
+    /// @brief Counter bytes reset( @p counters ) sizes the filter to.
+    static std::size_t bytesFor( std::size_t counters ) { return std::bit_ceil( std::max<std::size_t>( counters / BlockBytes, 1 ) ) * BlockBytes; }
+
+    void add( OrderKey id )
+    {
+        std::uint8_t* block = blockFor( id );
+        forEachCounter( id, [block]( unsigned pos ) { block[pos] += block[pos] != Saturated; } );
+    }
+
+    void remove( OrderKey id )
+    {
+        std::uint8_t* block = blockFor( id );
+        forEachCounter( id, [block]( unsigned pos ) { block[pos] -= block[pos] != Saturated; } );
+    }
+
+    /// @brief False means @p id was certainly never added (or was removed).
+    bool mayContain( OrderKey id ) const
+    {
+        const std::uint8_t* block = blockFor( id );
+        bool present              = true;
+        forEachCounter( id, [block, &present]( unsigned pos ) { present &= block[pos] != 0; } );
+        return present;
+    }
+
+    const void* blockAddress( OrderKey id ) const { return blockFor( id ); }
+
+    std::size_t memoryBytes() const { return counters_.capacity(); }
+
+private:
+    static constexpr std::uint8_t Saturated = 0xFF;
+
+    static std::uint64_t hash( OrderKey id )
+    {
+        // Different mixer from OrderIndex::hash so filter and index collisions
+        // are independent.
+        auto x = static_cast<std::uint64_t>( id ) + 0x9e3779b97f4a7c15ULL;
+        x      = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        x      = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+        return x ^ ( x >> 31 );
+    }
+
+    std::uint8_t* blockFor( OrderKey id ) { return counters_.data() + ( hash( id ) & block_mask_ ) * BlockBytes; }
+    const std::uint8_t* blockFor( OrderKey id ) const { return counters_.data() + ( hash( id ) & block_mask_ ) * BlockBytes; }
+
+    template <typename Fn>
+    static void forEachCounter( OrderKey id, Fn&& fn )
+    {
+        // Block index uses the low bits; in-block positions the top 18.
+        const std::uint64_t h = hash( id );
+        for ( unsigned i = 0; i < Hashes; ++i )
+        {
+            fn( static_cast<unsigned>( h >> ( 64 - 6 * ( i + 1 ) ) ) & ( BlockBytes - 1 ) );
+        }
+    }
+
+    BookVector<std::uint8_t> counters_;
+    std::uint64_t block_mask_{ 0 };
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,496 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Compile-Time Specialized Engine
+//
+// FixedUniverseEngine<FixedSymbol<...>...> is a matching engine whose symbol
+// set, tick/lot sizes, price bands and order capacities are all template
+// parameters:
+//
+//   - Each symbol's book is a FixedBook: std::array ladders of exactly
+//     Levels price levels per side (indexed by (price - MinPrice) / tick)
+//     and a std::array node pool of MaxOrders orders with its parallel cold
+//     table (SimOrderBook's Node / ColdOrder split); nothing is allocated
+//     or resized after construction
+//   - A full pool is a hard limit: a limit order arriving when no node is
+//     free is rejected before it matches, so a remainder is never dropped
+//     after it has traded
+//   - The books live in a std::tuple, so every book's constants fold into
+//     its own code; symbol dispatch for new orders is an unrolled chain of
+//     Symbol compares, and cancels dispatch on the OrderIndex entry's symbol
+//     number
+//   - The engine-wide OrderIndex is reserved for the sum of all capacities
+//     up front, so it never rehashes on the hot path
+//
+// The engine exposes process_new_order() / process_cancel() like
+// SimMatchingEngine and plugs into BasicEventLoop unchanged.  It is large
+// (the pools are inline), so allocate it on the heap.
+// ============================================================================
+
+#include <book_types.h>
+#include <clock_ref.h>
+#include <order_index.h>
+#include <sim_order_book.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace MarketMicroStructure
+{
+/// @brief String literal usable as a template argument.
+template <std::size_t N>
+struct FixedName
+{
+    constexpr FixedName( const char ( &s )[N] ) { std::copy_n( s, N, value ); }
+    constexpr std::string_view view() const { return { value, N - 1 }; }
+
+    char value[N]{};
+};
+
+/// @brief Compile-time description of one symbol of a FixedUniverseEngine.
+/// Limit prices must lie on the grid MinPrice + k * TickSize, k < Levels.
+template <FixedName Name, OrderPrice TickSize, OrderQty LotSize, OrderPrice MinPrice, std::size_t Levels, std::size_t MaxOrders>
+struct FixedSymbol
+{
+    static_assert( TickSize > 0 && LotSize > 0, "tick and lot size must be positive" );
+    static_assert( Levels > 0 && Levels <= SimOrderBook::MaxLadderLevels, "ladder size out of range" );
+    static_assert( MaxOrders > 0 && MaxOrders < NilNode, "order capacity out of range" );
+
+    static constexpr std::string_view name  = Name.view();
+    static constexpr OrderPrice tick_size   = TickSize;
+    static constexpr OrderQty lot_size      = LotSize;
+    static constexpr OrderPrice min_price   = MinPrice;
+    static constexpr std::size_t levels     = Levels;
+    static constexpr std::size_t max_orders = MaxOrders;
+};
+
+/// @brief Where a FixedBook sits in its engine (one argument, so books can
+/// be constructed in place inside a std::tuple).
+struct FixedBookBinding
+{
+    SymbolIndex symbol;
+    OrderIndex* index;
+};
+
+/// @brief Single-symbol book with statically sized ladders and node pool.
+template <typename Spec>
+class FixedBook
+{
+public:
+    using Node         = SimOrderBook::Node;
+    using ColdOrder    = SimOrderBook::ColdOrder;
+    using Level        = SimOrderBook::Level;
+    using SubmitResult = SimOrderBook::SubmitResult;
+
+    explicit FixedBook( FixedBookBinding binding ) : symbol_( binding.symbol ), index_( *binding.index )
+    {
+        // Thread the whole pool onto the free list (this also faults it in).
+        for ( std::size_t i = 0; i < Spec::max_orders; ++i )
+        {
+            nodes_[i].next = i + 1 < Spec::max_orders ? static_cast<NodeIndex>( i + 1 ) : NilNode;
+        }
+        free_head_ = 0;
+    }
+
+    FixedBook( const FixedBook& )            = delete;
+    FixedBook& operator=( const FixedBook& ) = delete;
+
+    void setTradeSink( const SimTradeCallback* sink ) { trade_sink_ = sink; }
+
+    SubmitResult submit( const HFTToolset::Order& order, HFTToolset::Timestamp now )
+    {
+        if ( order.quantity <= 0 || order.quantity % Spec::lot_size != 0 || static_cast<std::uint64_t>( order.quantity / Spec::lot_size ) > NodeQtyMax )
+        {
+            return SubmitResult::Rejected;
+        }
+
+        // Matching only frees nodes, so a node free now is still free if a
+        // remainder has to rest.
+        std::optional<std::size_t> limit;
+        if ( order.type == HFTToolset::OrderType::Limit )
+        {
+            limit = toLevel( order.price );
+            if ( !limit || free_head_ == NilNode )
+            {
+                return SubmitResult::Rejected;
+            }
+        }
+
+        const auto quantity     = static_cast<NodeQty>( order.quantity / Spec::lot_size );
+        const NodeQty remaining = match( order, limit, quantity, now );
+        SubmitResult result     = remaining == 0 ? SubmitResult::Filled : SubmitResult::Expired;
+
+        if ( remaining > 0 && limit )
+        {
+            rest( order, *limit, quantity, remaining, now );
+            result = SubmitResult::Rested;
+        }
+        refreshTopOfBook();
+        return result;
+    }
+
+    void cancel( NodeIndex node_idx )
+    {
+        const Node& node = nodes_[node_idx];
+        Ladder& side     = node.side == HFTToolset::Side::Buy ? bids_ : asks_;
+        const auto idx   = static_cast<std::size_t>( node.price );
+
+        side.qty[idx] -= node.open();
+        unlink( side.levels[idx], node_idx );
+        freeNode( node_idx );
+        --resting_;
+        if ( side.levels[idx].count == 0 )
+        {
+            levelEmptied( side, idx );
+        }
+        refreshTopOfBook();
+    }
+
+    std::optional<OrderPrice> bestBid() const { return bestPrice( bids_ ); }
+    std::optional<OrderPrice> bestAsk() const { return bestPrice( asks_ ); }
+    const MarketDataState& marketData() const { return market_data_; }
+    std::size_t restingOrders() const { return resting_; }
+
+private:
+    static constexpr std::uint64_t NodeQtyMax = std::numeric_limits<NodeQty>::max();
+
+    struct Ladder
+    {
+        std::array<Level, Spec::levels> levels{};
+        std::array<std::uint64_t, Spec::levels> qty{};
+        std::int64_t best{ -1 };
+        std::size_t non_empty{ 0 };
+    };
+
+    /// Node::price holds the ladder index (tick offset from MinPrice).
+    static std::optional<std::size_t> toLevel( OrderPrice price )
+    {
+        const OrderPrice offset = price - Spec::min_price;
+        if ( offset < 0 || offset % Spec::tick_size != 0 || static_cast<std::size_t>( offset / Spec::tick_size ) >= Spec::levels )
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>( offset / Spec::tick_size );
+    }
+
+    static constexpr OrderPrice toPrice( std::size_t level ) { return Spec::min_price + static_cast<OrderPrice>( level ) * Spec::tick_size; }
+
+    static std::optional<OrderPrice> bestPrice( const Ladder& ladder )
+    {
+        if ( ladder.best < 0 )
+        {
+            return std::nullopt;
+        }
+        return toPrice( static_cast<std::size_t>( ladder.best ) );
+    }
+
+    void levelFilled( Ladder& ladder, std::size_t idx, bool bid )
+    {
+        ++ladder.non_empty;
+        const auto i = static_cast<std::int64_t>( idx );
+        if ( ladder.best < 0 || ( bid ? i > ladder.best : i < ladder.best ) )
+        {
+            ladder.best = i;
+        }
+    }
+
+    void levelEmptied( Ladder& ladder, std::size_t idx )
+    {
+        --ladder.non_empty;
+        if ( static_cast<std::int64_t>( idx ) != ladder.best )
+        {
+            return;
+        }
+        if ( ladder.non_empty == 0 )
+        {
+            ladder.best = -1;
+            return;
+        }
+        const std::int64_t step = &ladder == &bids_ ? -1 : 1;
+        for ( std::int64_t i = ladder.best + step;; i += step )
+        {
+            if ( ladder.levels[static_cast<std::size_t>( i )].count > 0 )
+            {
+                ladder.best = i;
+                return;
+            }
+        }
+    }
+
+    void freeNode( NodeIndex node )
+    {
+        nodes_[node].next = free_head_;
+        free_head_        = node;
+    }
+
+    void unlink( Level& level, NodeIndex node )
+    {
+        const Node& n = nodes_[node];
+        ( n.prev != NilNode ? nodes_[n.prev].next : level.head ) = n.next;
+        ( n.next != NilNode ? nodes_[n.next].prev : level.tail ) = n.prev;
+        --level.count;
+    }
+
+    void rest( const HFTToolset::Order& order, std::size_t idx, NodeQty quantity, NodeQty remaining, HFTToolset::Timestamp accept_time )
+    {
+        const bool bid           = order.side == HFTToolset::Side::Buy;
+        Ladder& side             = bid ? bids_ : asks_;
+        Level& level             = side.levels[idx];
+        const NodeIndex node_idx = free_head_;
+        Node& node               = nodes_[node_idx];
+        free_head_               = node.next;
+
+        node = Node{ .id         = order.id,
+                     .price      = static_cast<Ticks>( idx ),
+                     .quantity   = quantity,
+                     .filled_qty = quantity - remaining,
+                     .prev       = level.tail,
+                     .next       = NilNode,
+                     .side       = order.side };
+        cold_[node_idx] = ColdOrder{ .trader_id   = order.trader_id,
+                                     .submit_time = order.submit_time,
+                                     .accept_time = accept_time,
+                                     .cl_ord_id   = order.cl_ord_id,
+                                     .tif         = order.tif };
+        ( level.tail != NilNode ? nodes_[level.tail].next : level.head ) = node_idx;
+        level.tail     = node_idx;
+        side.qty[idx] += remaining;
+        if ( level.count++ == 0 )
+        {
+            levelFilled( side, idx, bid );
+        }
+        index_.insert( order.id, { symbol_, node_idx } );
+        ++resting_;
+    }
+
+    NodeQty match( const HFTToolset::Order& order, std::optional<std::size_t> limit, NodeQty remaining, HFTToolset::Timestamp now )
+    {
+        const bool is_buy = order.side == HFTToolset::Side::Buy;
+        Ladder& book_side = is_buy ? asks_ : bids_;
+
+        while ( remaining > 0 && book_side.best >= 0 )
+        {
+            const auto idx = static_cast<std::size_t>( book_side.best );
+            if ( limit && ( is_buy ? idx > *limit : idx < *limit ) )
+            {
+                break;
+            }
+
+            const OrderPrice price = toPrice( idx );
+            Level& level           = book_side.levels[idx];
+            while ( remaining > 0 && level.head != NilNode )
+            {
+                const NodeIndex maker_idx = level.head;
+                Node& maker               = nodes_[maker_idx];
+                const NodeQty fill        = std::min( remaining, maker.open() );
+                const OrderQty fill_qty   = static_cast<OrderQty>( fill ) * Spec::lot_size;
+
+                if ( trade_sink_ && *trade_sink_ )
+                {
+                    ( *trade_sink_ )( SimTrade{ .symbol         = symbol_,
+                                                .maker_id       = maker.id,
+                                                .taker_id       = order.id,
+                                                .maker_trader   = cold_[maker_idx].trader_id,
+                                                .taker_trader   = order.trader_id,
+                                                .price          = price,
+                                                .quantity       = fill_qty,
+                                                .aggressor_side = order.side,
+                                                .time           = now } );
+                }
+                market_data_.last_trade_price = price;
+                market_data_.last_trade_qty   = fill_qty;
+                market_data_.traded_volume   += fill_qty;
+                ++market_data_.trade_count;
+
+                remaining          -= fill;
+                book_side.qty[idx] -= fill;
+                if ( fill == maker.open() )
+                {
+                    index_.erase( maker.id );
+                    unlink( level, maker_idx );
+                    freeNode( maker_idx );
+                    --resting_;
+                }
+                else
+                {
+                    maker.filled_qty += fill;
+                }
+            }
+
+            if ( level.count == 0 )
+            {
+                levelEmptied( book_side, idx );
+            }
+        }
+        return remaining;
+    }
+
+    void refreshTopOfBook()
+    {
+        const auto top = []( const Ladder& ladder ) -> std::pair<OrderPrice, OrderQty>
+        {
+            if ( ladder.best < 0 )
+            {
+                return {};
+            }
+            const auto idx = static_cast<std::size_t>( ladder.best );
+            return { toPrice( idx ), static_cast<OrderQty>( ladder.qty[idx] ) * Spec::lot_size };
+        };
+        const auto [bid, bid_qty] = top( bids_ );
+        const auto [ask, ask_qty] = top( asks_ );
+
+        MarketDataState& md = market_data_;
+        if ( bid != md.best_bid || bid_qty != md.best_bid_qty || ask != md.best_ask || ask_qty != md.best_ask_qty )
+        {
+            md.best_bid     = bid;
+            md.best_bid_qty = bid_qty;
+            md.best_ask     = ask;
+            md.best_ask_qty = ask_qty;
+            ++md.tob_updates;
+        }
+    }
+
+    SymbolIndex symbol_;
+    OrderIndex& index_;
+    const SimTradeCallback* trade_sink_{ nullptr };
+
+    std::array<Node, Spec::max_orders> nodes_{};
+    std::array<ColdOrder, Spec::max_orders> cold_{};  ///< Read on the matching path only for trade reports
+    NodeIndex free_head_{ NilNode };
+    std::size_t resting_{ 0 };
+
+    Ladder bids_;
+    Ladder asks_;
+    MarketDataState market_data_;
+};
+
+template <typename... Specs>
+class FixedUniverseEngine
+{
+public:
+    static constexpr std::size_t SymbolCount   = sizeof...( Specs );
+    static constexpr std::size_t TotalCapacity = ( Specs::max_orders + ... );
+
+    using Stats = EngineStats;
+
+    explicit FixedUniverseEngine( ClockRef clock )
+        : FixedUniverseEngine( clock, std::make_index_sequence<SymbolCount>{} )
+    {
+    }
+
+    FixedUniverseEngine( const FixedUniverseEngine& )            = delete;
+    FixedUniverseEngine& operator=( const FixedUniverseEngine& ) = delete;
+
+    /// @brief The symbol set is fixed; returns the index of @p name if it is
+    /// part of the universe, NoSymbol otherwise.
+    SymbolIndex add_symbol( std::string_view name ) const
+    {
+        SymbolIndex found = NoSymbol;
+        forEachSymbol( [&]<std::size_t I>() {
+            if ( std::tuple_element_t<I, std::tuple<Specs...>>::name == name )
+            {
+                found = I;
+            }
+        } );
+        return found;
+    }
+
+    void process_new_order( const HFTToolset::Order& order )
+    {
+        if ( ( index_.mayContain( order.id ) && index_.find( order.id ) ) || !dispatchNew( order, std::make_index_sequence<SymbolCount>{} ) )
+        {
+            ++stats_.rejected;
+        }
+    }
+
+    void process_cancel( const HFTToolset::CancelRequest& cancel )
+    {
+        if ( !index_.mayContain( cancel.order_id ) )
+        {
+            ++stats_.cancel_rejects;
+            ++stats_.cancel_filtered;
+            return;
+        }
+        const OrderIndex::Entry* entry = index_.find( cancel.order_id );
+        if ( !entry )
+        {
+            ++stats_.cancel_rejects;
+            return;
+        }
+
+        const OrderIndex::Entry resting = *entry;
+        index_.erase( cancel.order_id );
+        withBook( resting.symbol, [node = resting.node]( auto& book ) { book.cancel( node ); } );
+        ++stats_.cancelled;
+    }
+
+    void onTrade( SimTradeCallback callback ) { on_trade_ = std::move( callback ); }
+
+    template <std::size_t I>
+    const auto& book() const
+    {
+        return std::get<I>( books_ );
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    template <std::size_t... I>
+    FixedUniverseEngine( ClockRef clock, std::index_sequence<I...> )
+        : clock_( clock ),
+          index_( std::pmr::new_delete_resource(), TotalCapacity * 2 ),
+          symbols_{ HFTToolset::Symbol( Specs::name.data() )... },
+          books_( FixedBookBinding{ I, &index_ }... )
+    {
+        ( std::get<I>( books_ ).setTradeSink( &on_trade_ ), ... );
+    }
+
+    template <typename Fn>
+    static void forEachSymbol( Fn&& fn )
+    {
+        [&]<std::size_t... I>( std::index_sequence<I...> ) { ( fn.template operator()<I>(), ... ); }( std::make_index_sequence<SymbolCount>{} );
+    }
+
+    /// @brief Unrolled compare chain over the universe's symbols.
+    template <std::size_t... I>
+    bool dispatchNew( const HFTToolset::Order& order, std::index_sequence<I...> )
+    {
+        return ( ( order.symbol == symbols_[I] && submitTo<I>( order ) ) || ... );
+    }
+
+    template <std::size_t I>
+    bool submitTo( const HFTToolset::Order& order )
+    {
+        if ( std::get<I>( books_ ).submit( order, clock_.now() ) == SimOrderBook::SubmitResult::Rejected )
+        {
+            return false;
+        }
+        ++stats_.accepted;
+        return true;
+    }
+
+    /// @brief Direct index -> book dispatch; compiles to a jump table.
+    template <typename Fn>
+    void withBook( SymbolIndex symbol, Fn&& fn )
+    {
+        [&]<std::size_t... I>( std::index_sequence<I...> ) {
+            ( ( symbol == I ? ( fn( std::get<I>( books_ ) ), true ) : false ) || ... );
+        }( std::make_index_sequence<SymbolCount>{} );
+    }
+
+    ClockRef clock_;
+    OrderIndex index_;
+    std::array<HFTToolset::Symbol, SymbolCount> symbols_;
+    SimTradeCallback on_trade_;
+    std::tuple<FixedBook<Specs>...> books_;
+    Stats stats_;
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,164 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Hot Standby Replica
+//
+// A second process mirrors the primary's books event by event, so failover
+// is a matter of noticing the primary is gone, not of rebuilding state.
+//
+// The primary's producer publishes every inbound event, with its sequence
+// number, to a POSIX shared-memory SPSC ring (ReplicaPublisher) before
+// handing it to its own engine.  The standby (HotStandby) attaches to the
+// ring and applies each event to its own SimMatchingEngine, set up exactly
+// like the primary's.  Both engines see the same events in the same order,
+// so the books match order for order.
+//
+// Bounded lag: the publisher never runs more than max_lag events ahead of
+// the standby's applied count, and waits when it would.  The ring holds at
+// least max_lag slots, so a slot is never overwritten before it is applied.
+//
+// Liveness: each side stamps a heartbeat in the segment (steady-clock ns,
+// which is CLOCK_MONOTONIC and so comparable across processes).  The
+// primary's comes from a background thread every millisecond, so a slow
+// flow is not mistaken for a dead primary; the standby stamps its own as it
+// applies and while it polls.  The standby takes over once the primary's
+// heartbeat is older than the takeover timeout, after applying everything
+// the primary published.  Its book is then current: takeover costs the
+// detection timeout plus that last drain.  A primary that stops cleanly
+// marks the segment closed.  A primary whose standby goes silent stops
+// publishing rather than stall.
+//
+// The segment holds only indices and trivially copyable events, so it maps
+// at any address in either process.
+// ============================================================================
+
+#include <sequencer.h>
+#include <sim_matching_engine.h>
+
+#include <common/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace MarketMicroStructure
+{
+struct ReplicationConfig
+{
+    std::uint64_t max_lag{ 4096 };                       ///< Events the primary may run ahead of the standby
+    std::chrono::milliseconds takeover_timeout{ 500 };   ///< Heartbeat age after which the other side counts as gone
+    std::chrono::milliseconds attach_timeout{ 10'000 };  ///< How long either side waits for the other to show up
+};
+
+/// @brief The shared segment's header; the event slots follow it.
+struct ReplicationHeader;
+
+/// @brief A mapped replication segment.  Move-only; unmaps on destruction
+/// and, for the creating side, unlinks the name.
+class ReplicationSegment
+{
+public:
+    static std::expected<ReplicationSegment, std::string> create( const std::string& name, std::uint64_t capacity );
+    static std::expected<ReplicationSegment, std::string> attach( const std::string& name, std::chrono::milliseconds timeout );
+
+    ReplicationSegment( ReplicationSegment&& other ) noexcept;
+    ReplicationSegment& operator=( ReplicationSegment&& other ) noexcept;
+    ~ReplicationSegment();
+
+    ReplicationHeader& header() const { return *header_; }
+    SequencedEvent& slot( std::uint64_t sequence ) const;
+
+    /// @brief Removes the segment's name now; the mapping stays valid.
+    void unlink();
+
+private:
+    ReplicationSegment( std::string name, void* base, std::size_t bytes, bool owner );
+
+    std::string name_;
+    ReplicationHeader* header_{ nullptr };
+    std::size_t bytes_{ 0 };
+    bool owner_{ false };
+};
+
+/// @brief Primary side.  publish() runs on the producer thread.
+class ReplicaPublisher
+{
+public:
+    /// @brief Creates segment @p name (replacing a stale one) and waits for
+    /// a standby to attach.
+    static std::expected<ReplicaPublisher, std::string> open( const std::string& name, const ReplicationConfig& config );
+
+    /// @brief Publishes @p ev as the next sequence number.  Waits while the
+    /// standby is max_lag events behind; if its heartbeat goes stale
+    /// meanwhile, replication is dropped and later calls return at once.
+    void publish( const HFTToolset::EngineEvent& ev );
+
+    /// @brief Marks the stream complete; the standby drains it and exits.
+    void close();
+
+    std::uint64_t published() const { return published_; }
+    std::uint64_t stalls() const { return stalls_; }  ///< publish() calls that hit the lag bound
+    bool lost() const { return lost_; }                ///< The standby went silent and was dropped
+
+private:
+    ReplicaPublisher( ReplicationSegment segment, const ReplicationConfig& config );
+
+    ReplicationSegment segment_;
+    ReplicationConfig config_;
+    std::jthread heartbeat_;  // declared after segment_: stops before the unmap
+    std::uint64_t published_{ 0 };
+    std::uint64_t stalls_{ 0 };
+    bool lost_{ false };
+};
+
+enum class StandbyOutcome : std::uint8_t
+{
+    PrimaryClosed,  ///< The primary finished cleanly; the standby holds its final state
+    Takeover        ///< The primary's heartbeat stopped; the standby is now authoritative
+};
+
+struct StandbyResult
+{
+    StandbyOutcome outcome{ StandbyOutcome::PrimaryClosed };
+    std::uint64_t applied{ 0 };
+    std::uint64_t max_lag{ 0 };           ///< Largest published - applied seen by the standby
+    std::uint64_t heartbeat_age_ns{ 0 };  ///< Age of the primary's last heartbeat when failure was declared
+    std::uint64_t takeover_ns{ 0 };       ///< Declaring failure to a current, writable book
+};
+
+/// @brief Standby side: applies the primary's events to @p engine, which
+/// must be set up exactly like the primary's (same symbols, same order).
+/// Returns once the primary closes or is declared failed.
+class HotStandby
+{
+public:
+    HotStandby( ReplicationSegment segment, SimMatchingEngine& engine, const ReplicationConfig& config );
+
+    /// @brief Runs on the calling thread.  Fails if the stream skips a
+    /// sequence number.
+    std::expected<StandbyResult, std::string> run();
+
+private:
+    ReplicationSegment segment_;
+    SimMatchingEngine& engine_;
+    ReplicationConfig config_;
+};
+
+/// @brief Hash of every book (each resting order's id, side, price,
+/// quantity and fill, in queue order, then the symbol's top of book and
+/// trade state) and the engine's counters.  Timestamps and tob_updates are
+/// left out: each process stamps with its own clock, and a restored book
+/// counts its own top-of-book updates.  Equal digests mean identical books
+/// in everything a fill or a market-data reader can observe.
+std::uint64_t bookDigest( const SimMatchingEngine& engine, std::span<const std::string_view> symbols );
+
+/// @brief Prints the "[Standby]" line.
+void printStandby( std::ostream& out, const StandbyResult& result, std::uint64_t digest );
+
+}  // namespace MarketMicroStructure
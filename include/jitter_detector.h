@@ -0,0 +1,94 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Host Jitter Detector
+//
+// Calibration tool that spins a tight TSC loop on a set of cores and records
+// every gap between consecutive reads that exceeds a threshold.  On a quiet
+// core consecutive reads are a few nanoseconds apart; anything larger is time
+// stolen from the thread (SMIs, timer ticks, IRQs, preemption).
+//
+// Run on the producer and EventLoop cores before and after a simulation, the
+// report separates noisy-host artifacts from genuine engine regressions: if
+// the host itself loses tens of microseconds at a time, a bad P99.9 says
+// nothing about the matching path.
+//
+// Gaps are timed with the process's TscClock, so the detector and the
+// benchmarks share one calibration.
+// ============================================================================
+
+#include <tsc_clock.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+/// @brief Log2 histogram of interruption gaps, in nanoseconds.
+/// Bucket i counts gaps in [2^i, 2^(i+1)) ns.
+struct JitterHistogram
+{
+    static constexpr std::size_t Buckets = 32;
+
+    std::array<std::uint64_t, Buckets> counts{};
+
+    void record( std::uint64_t gap_ns );
+    std::uint64_t total() const;
+
+    /// @brief Upper bound (ns) of the bucket holding the given quantile.
+    std::uint64_t quantileUpperBound( double q ) const;
+};
+
+/// @brief Result of one calibration run on one core.
+struct JitterReport
+{
+    int core{ -1 };  ///< Requested core (-1 = unpinned)
+    bool pinned{ false };
+    std::uint64_t wall_ns{ 0 };     ///< Length of the measurement window
+    std::uint64_t stolen_ns{ 0 };   ///< Sum of all gaps above threshold
+    std::uint64_t max_gap_ns{ 0 };  ///< Largest single interruption
+    std::uint64_t iterations{ 0 };  ///< Number of TSC reads performed
+    JitterHistogram gaps;
+
+    double stolenFraction() const { return wall_ns ? static_cast<double>( stolen_ns ) / static_cast<double>( wall_ns ) : 0.0; }
+};
+
+class JitterDetector
+{
+public:
+    struct Config
+    {
+        std::chrono::nanoseconds duration{ std::chrono::milliseconds( 500 ) };
+        std::chrono::nanoseconds gap_threshold{ 200 };  ///< Gaps below this are loop cost, not jitter
+
+        // A core is flagged noisy when either limit is exceeded.
+        double max_stolen_fraction{ 0.001 };
+        std::chrono::nanoseconds max_single_gap{ std::chrono::microseconds( 50 ) };
+    };
+
+    /// @brief @p clock must outlive the detector.
+    JitterDetector( Config config, const TscClock& clock );
+
+    /// @brief Spins on the calling thread (pinned to @p core if >= 0).
+    JitterReport measure( int core ) const;
+
+    /// @brief Runs measure() simultaneously on every core in @p cores, one
+    /// thread each, so cross-core effects (shared IRQ lines, SMT siblings)
+    /// are observed the same way the simulation threads would see them.
+    std::vector<JitterReport> measureConcurrently( std::span<const int> cores ) const;
+
+    bool isNoisy( const JitterReport& report ) const;
+
+    /// @brief Prints one summary line and the non-empty histogram buckets per core.
+    void print( std::ostream& out, std::string_view phase, std::span<const JitterReport> reports ) const;
+
+private:
+    Config config_;
+    const TscClock& clock_;
+};
+
+}  // namespace MarketMicroStructure
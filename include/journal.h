@@ -0,0 +1,293 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Block-Compressed Journals
+//
+// Append-only journals of fixed-size records: the inbound event journal
+// (SequencedEvent) and the trade journal (SimTrade).
+//
+// The thread that appends (the producer, or the matching thread for
+// trades) only copies the record into a raw block of a staging ring.  When
+// a block fills it is sealed and handed to a pool of compression threads.
+// Those compress blocks in parallel with block_codec.h and commit them to
+// the file strictly in block order, each behind a JournalBlockHeader.  A
+// committed block's staging slot goes back to the appender.  If every slot
+// is still in flight the appender waits, and the wait is counted.  The
+// hot path takes no lock; only the background threads share one to order
+// their commits.
+//
+// close() seals the partial last block, waits for the pool, and appends the
+// block index (one JournalBlock per block) with a trailer pointing at it.
+// JournalReader uses the index for random access: a record lookup is a
+// binary search over the index plus one block decode.  A journal cut short
+// by a crash has no trailer; the reader rebuilds the index by walking the
+// block headers and stops at the first incomplete block.
+//
+// Each committed block also appends one entry to a sidecar key index,
+// "<journal>.idx": the block's offset, its event-time range, its order-id
+// range and a Bloom filter of every order id its records reference.  The
+// keys are extracted by the compression thread, so the appender does no
+// extra work.  JournalIndex answers "records between two times" and
+// "records referencing an order" with a binary search over the running
+// maxima of those ranges plus a scan that decodes only the blocks whose
+// range (and, for ids, filter) can match.  Ids are not generally
+// monotonic (the uniform flow draws them at random), so the order lookup
+// leans on the filters: at 16 bits per id roughly one block in 400 is
+// decoded needlessly.  Blocks are flushed once per commit batch (every
+// block that was next in line when a worker finished), before that batch's
+// sidecar entries are written, so an entry never points past the journal.
+// A process crash can lose the batch in flight, at most staging_blocks
+// blocks, and its entries.  The sidecar is never required: entries missing
+// after a crash are rebuilt from the journal.
+//
+// File layout:
+//   JournalFileHeader
+//   { JournalBlockHeader, payload }*          payload stored_bytes long
+//   JournalBlock[blocks], JournalTrailer      written by close()
+//
+// Sidecar layout:
+//   JournalIndexHeader
+//   { JournalKeys, std::uint64_t[filter_words] }*   one per block, in order
+// ============================================================================
+
+#include <common/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+enum class JournalKind : std::uint32_t
+{
+    Events = 1,  ///< SequencedEvent records
+    Trades = 2   ///< SimTrade records
+};
+
+struct JournalConfig
+{
+    std::size_t block_bytes{ 64 * 1024 };  ///< Raw bytes per block, rounded down to whole records
+    std::size_t staging_blocks{ 16 };      ///< Raw blocks the appender can fill ahead of the compressors
+    std::size_t workers{ 2 };              ///< Compression threads
+};
+
+/// @brief One block-index entry.
+struct JournalBlock
+{
+    std::uint64_t offset{ 0 };        ///< File offset of the block's JournalBlockHeader
+    std::uint64_t first_record{ 0 };  ///< Number of the block's first record
+    std::uint32_t records{ 0 };
+    std::uint32_t stored_bytes{ 0 };  ///< Payload bytes on disk; equal to the raw size if stored uncompressed
+};
+
+/// @brief One sidecar-index entry: the keys of one journal block.
+struct JournalKeys
+{
+    std::uint64_t offset{ 0 };  ///< File offset of the block's JournalBlockHeader
+    std::uint64_t first_record{ 0 };
+    std::uint32_t records{ 0 };
+    std::uint32_t filter_words{ 0 };  ///< Bloom filter words that follow the entry
+    HFTToolset::Timestamp min_time{ 0 };
+    HFTToolset::Timestamp max_time{ 0 };
+    HFTToolset::OrderId min_id{ 0 };  ///< Lowest order id any record references
+    HFTToolset::OrderId max_id{ 0 };
+};
+
+/// @brief Records found by a JournalIndex lookup.
+struct JournalMatches
+{
+    std::vector<std::uint64_t> records;  ///< Matching record numbers, ascending
+    std::size_t blocks_decoded{ 0 };     ///< Blocks read to find them
+};
+
+struct JournalStats
+{
+    std::uint64_t records{ 0 };
+    std::uint64_t blocks{ 0 };
+    std::uint64_t raw_bytes{ 0 };
+    std::uint64_t stored_bytes{ 0 };    ///< Block payloads on disk, headers excluded
+    std::uint64_t staging_stalls{ 0 };  ///< Blocks the appender had to wait for a free staging slot
+
+    double ratio() const { return raw_bytes != 0 ? static_cast<double>( stored_bytes ) / static_cast<double>( raw_bytes ) : 0.0; }
+};
+
+class JournalWriter
+{
+public:
+    /// @brief Creates (truncates) @p path and starts the compression pool.
+    static std::expected<std::unique_ptr<JournalWriter>, std::string> open( const std::string& path, JournalKind kind, std::size_t record_size,
+                                                                            const JournalConfig& config = {} );
+
+    ~JournalWriter();
+
+    JournalWriter( const JournalWriter& )            = delete;
+    JournalWriter& operator=( const JournalWriter& ) = delete;
+
+    /// @brief Hot path: copies one record_size-byte record into staging.
+    /// Single appending thread only.
+    void append( const void* record );
+
+    template <typename Record>
+    void append( const Record& record )
+    {
+        static_assert( std::is_trivially_copyable_v<Record> );
+        append( static_cast<const void*>( &record ) );
+    }
+
+    /// @brief Flushes the partial block, stops the pool and writes the block
+    /// index.  Called by the appending thread, or once it has been joined;
+    /// idempotent.
+    std::expected<void, std::string> close();
+
+    /// @brief Appender-side counters plus everything committed so far.
+    JournalStats stats() const;
+
+private:
+    struct Slot
+    {
+        std::vector<std::uint8_t> raw;
+        std::vector<std::uint8_t> stored;
+        std::uint64_t block{ 0 };
+        std::uint64_t first_record{ 0 };
+        std::uint32_t records{ 0 };
+        std::uint32_t stored_bytes{ 0 };
+        std::uint32_t checksum{ 0 };
+        JournalKeys keys;
+        std::vector<std::uint64_t> filter;
+        bool compressed{ false };        // under commit_mutex_
+        std::atomic<bool> free{ true };  // true: owned by the appender
+    };
+
+    JournalWriter( std::ofstream file, std::ofstream sidecar, JournalKind kind, std::size_t record_size, const JournalConfig& config );
+
+    void seal();
+    void runWorker();
+    void compress( Slot& slot );
+    void commit( Slot& slot );
+
+    std::ofstream file_;
+    std::ofstream sidecar_;
+    JournalKind kind_;
+    std::size_t record_size_;
+    std::uint32_t block_records_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+
+    // Appender only.
+    Slot* current_{ nullptr };
+    std::uint32_t fill_{ 0 };
+    std::uint64_t records_{ 0 };
+    std::uint64_t stalls_{ 0 };
+    bool closed_{ false };
+
+    // Appender -> pool.
+    alignas( 64 ) std::atomic<std::uint64_t> sealed_{ 0 };
+    std::atomic<std::uint64_t> wake_{ 0 };
+    std::atomic<bool> stopping_{ false };
+    alignas( 64 ) std::atomic<std::uint64_t> claimed_{ 0 };
+
+    // Pool, under commit_mutex_.
+    mutable std::mutex commit_mutex_;
+    std::uint64_t next_commit_{ 0 };
+    std::uint64_t offset_{ 0 };
+    std::uint64_t raw_bytes_{ 0 };
+    std::uint64_t stored_bytes_{ 0 };
+    std::vector<JournalBlock> index_;
+    std::string error_;
+
+    std::vector<std::jthread> workers_;  // last: joined before anything above is destroyed
+};
+
+class JournalReader
+{
+public:
+    static std::expected<JournalReader, std::string> open( const std::string& path );
+
+    JournalKind kind() const { return kind_; }
+    std::size_t recordSize() const { return record_size_; }
+    std::uint64_t records() const { return index_.empty() ? 0 : index_.back().first_record + index_.back().records; }
+    const std::vector<JournalBlock>& index() const { return index_; }
+
+    /// @brief True if the file had no trailer (an unclean shutdown) and the
+    /// index was rebuilt by scanning.
+    bool recovered() const { return recovered_; }
+
+    /// @brief Decoded records of block @p block, verified against its
+    /// checksum.  Valid until the next call.
+    std::expected<std::span<const std::uint8_t>, std::string> block( std::size_t block );
+
+    /// @brief Copies record @p record into @p out (recordSize() bytes).
+    std::expected<void, std::string> read( std::uint64_t record, void* out );
+
+    /// @brief Block holding record @p record: binary search over the index.
+    std::size_t blockOf( std::uint64_t record ) const;
+
+private:
+    JournalReader( std::ifstream file, std::string path );
+
+    std::ifstream file_;
+    std::string path_;
+    JournalKind kind_{ JournalKind::Events };
+    std::size_t record_size_{ 0 };
+    std::vector<JournalBlock> index_;
+    bool recovered_{ false };
+
+    std::size_t cached_block_{ static_cast<std::size_t>( -1 ) };
+    std::vector<std::uint8_t> stored_;
+    std::vector<std::uint8_t> raw_;
+};
+
+/// @brief The sidecar key index of one journal.
+class JournalIndex
+{
+public:
+    /// @brief Sidecar file name of the journal at @p journal.
+    static std::string sidecarPath( const std::string& journal );
+
+    /// @brief Loads the sidecar of @p journal.  Entries it lacks (no
+    /// sidecar, or one cut short by a crash) are rebuilt by decoding the
+    /// journal's blocks; rebuilt() counts them.
+    static std::expected<JournalIndex, std::string> open( const std::string& path, JournalReader& journal );
+
+    std::size_t blocks() const { return keys_.size(); }
+    std::size_t rebuilt() const { return rebuilt_; }
+    const JournalKeys& keys( std::size_t block ) const { return keys_[block]; }
+
+    /// @brief Records with from <= time < to (event_time for events, the
+    /// trade time for trades).
+    std::expected<JournalMatches, std::string> findTime( JournalReader& journal, HFTToolset::Timestamp from, HFTToolset::Timestamp to ) const;
+
+    /// @brief Records referencing order @p id: the order itself, cancels of
+    /// it, and trades where it is maker or taker.
+    std::expected<JournalMatches, std::string> findOrder( JournalReader& journal, HFTToolset::OrderId id ) const;
+
+private:
+    void add( const JournalKeys& keys, const std::uint64_t* filter );
+    void buildSearchKeys();
+    bool mayReference( std::size_t block, HFTToolset::OrderId id ) const;
+
+    std::vector<JournalKeys> keys_;
+    std::vector<std::uint64_t> filters_;
+    std::vector<std::size_t> filter_at_;  ///< First filter word of each block
+    // Search keys: [b] is the max over blocks 0..b, or the min over b..end.
+    // Both are sorted, so a lookup binary-searches its first block and
+    // stops at the first block past which nothing can match.
+    std::vector<HFTToolset::Timestamp> max_time_upto_;
+    std::vector<HFTToolset::Timestamp> min_time_from_;
+    std::vector<HFTToolset::OrderId> max_id_upto_;
+    std::vector<HFTToolset::OrderId> min_id_from_;
+    std::size_t rebuilt_{ 0 };
+};
+
+/// @brief Prints a "[Journal]" line for a writer's stats.
+void printJournalStats( std::ostream& out, const std::string& name, const JournalStats& stats );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,128 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Historical L3 Replay
+//
+// Rebuilds per-symbol order books from a recorded order-by-order feed and
+// checks them against the recorded snapshots in the same file.
+//
+// File layout (little-endian, no padding between sections):
+//
+//   L3FileHeader     24 bytes   magic "MMSL3v1\0", symbol_count,
+//                               reserved (0), message_count
+//   L3SymbolName     16 bytes   x symbol_count, NUL-padded names; a
+//                               message's symbol field indexes this table
+//   L3Message        32 bytes   x message_count, in feed order:
+//
+//     type  meaning    order_id        price          quantity         side
+//     'A'   add        new order       limit price    shares           'B'/'S'
+//     'M'   modify     resting order   new price      new shares       -
+//     'D'   delete     resting order   -              -                -
+//     'E'   execute    resting order   -              shares executed  -
+//     'C'   check      -               depth (0=all)  # of 'S' records -
+//     'S'   snapshot   order count     level price    level shares     'B'/'S'
+//
+// A 'C' record opens a snapshot of its symbol: the next `quantity` 'S'
+// records of that symbol list the recorded levels (best first per side,
+// `depth` levels per side, or every level when depth is 0).  When the
+// last one arrives the rebuilt book is compared with it.
+//
+// Replay: one pass buckets message indices by symbol (stable, so each
+// symbol keeps feed order).  Worker threads then claim whole symbols from
+// a shared counter and replay them into private books.  Symbols are
+// independent, so there is no other synchronization.  Each symbol's book
+// at the end of the feed is returned in the form
+// SimMatchingEngine::restoreSymbol() takes, so an engine can start from it
+// (restoreL3Books()).
+// ============================================================================
+
+#include <sim_matching_engine.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+inline constexpr char L3Magic[8] = { 'M', 'M', 'S', 'L', '3', 'v', '1', '\0' };
+
+struct L3FileHeader
+{
+    char magic[8];
+    std::uint32_t symbol_count;
+    std::uint32_t reserved;
+    std::uint64_t message_count;
+};
+
+struct L3SymbolName
+{
+    char name[16];
+};
+
+struct L3Message
+{
+    std::uint64_t time_ns;
+    std::uint64_t order_id;
+    std::int64_t price;
+    std::uint32_t quantity;
+    std::uint16_t symbol;
+    char type;
+    char side;
+};
+
+static_assert( sizeof( L3FileHeader ) == 24 );
+static_assert( sizeof( L3SymbolName ) == 16 );
+static_assert( sizeof( L3Message ) == 32 );
+
+struct L3Feed
+{
+    std::vector<std::string> symbols;
+    std::vector<L3Message> messages;
+};
+
+/// @brief Reads and validates a feed file.
+std::expected<L3Feed, std::string> loadL3Feed( const std::string& path );
+
+/// @brief Writes @p feed in the layout above.
+std::expected<void, std::string> saveL3Feed( const std::string& path, const L3Feed& feed );
+
+/// @brief Outcome of replaying one symbol.
+struct L3SymbolResult
+{
+    std::size_t messages{ 0 };
+    std::size_t snapshots{ 0 };       ///< Snapshots compared
+    std::size_t mismatches{ 0 };      ///< Snapshots that differed from the rebuilt book
+    std::size_t unknown_orders{ 0 };   ///< M/D/E for an id not resting, or a duplicate A
+    std::size_t over_executions{ 0 };  ///< E for more shares than rest; the order is removed
+    std::size_t resting_orders{ 0 };   ///< At end of feed
+    std::string first_mismatch;        ///< Description of the first mismatch, if any
+    SymbolBookState book;              ///< Resting orders at end of feed, in queue order per level
+};
+
+struct L3ReplayResult
+{
+    std::vector<L3SymbolResult> symbols;  ///< Indexed like L3Feed::symbols
+    std::size_t threads{ 0 };
+    std::uint64_t elapsed_ns{ 0 };
+
+    std::size_t messages() const;
+    std::size_t mismatches() const;
+};
+
+/// @brief Replays @p feed on @p threads workers (0 = one per hardware thread,
+/// never more than there are symbols).
+L3ReplayResult replayL3( const L3Feed& feed, std::size_t threads );
+
+/// @brief Prints the "[L3Replay]" summary plus one line per symbol with a
+/// mismatch, unknown order or over-execution.
+void printL3Replay( std::ostream& out, const L3Feed& feed, const L3ReplayResult& result );
+
+/// @brief Lists every feed symbol on @p engine (tick and lot size 1) and
+/// restores its rebuilt book.  @p engine must not hold any of the feed's
+/// order ids.  Returns the number of symbols whose book could not be
+/// restored; each of those is left empty.
+std::size_t restoreL3Books( SimMatchingEngine& engine, const L3Feed& feed, const L3ReplayResult& result );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,32 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Level Sweep
+//
+// Finds how far a large aggressive order reaches into one side of a ladder
+// by running a prefix sum over the contiguous per-level quantity array:
+// the result is the number of leading levels the order consumes completely
+// and their combined volume.  The book then removes those levels in bulk
+// and only walks the FIFO of the (at most one) partially filled level.
+//
+// With AVX2 the prefix sum runs four levels per step; other targets use
+// the scalar loop, which gives identical results.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MarketMicroStructure
+{
+struct SweepResult
+{
+    std::size_t levels{ 0 };     ///< Leading levels whose running total stays <= budget
+    std::uint64_t volume{ 0 };  ///< Sum of those levels' quantities
+};
+
+/// @brief Sweeps qty[0], qty[1], ..., qty[n - 1] (asks, best upwards).
+SweepResult sweepAscending( const std::uint64_t* qty, std::size_t n, std::uint64_t budget );
+
+/// @brief Sweeps qty[0], qty[-1], ..., qty[1 - n] (bids, best downwards).
+SweepResult sweepDescending( const std::uint64_t* qty, std::size_t n, std::uint64_t budget );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,125 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Memory Accounting
+//
+// Per-subsystem byte counters that are cheap enough to leave on in every run:
+//   - MemoryAccount     named live/peak/allocation counters (relaxed atomics)
+//   - MemoryRegistry    process-wide table of accounts, keyed by name
+//   - CountingResource  std::pmr::memory_resource that charges an account on
+//                       every allocate/deallocate and forwards upstream
+//   - ProcessMemoryStats peak RSS and page-fault counters from getrusage()
+//
+// Accounting happens at the allocator boundary, never by walking the heap:
+// a subsystem that wants to be measured allocates through a CountingResource
+// (or charges its account directly for fixed-size blocks).
+// ============================================================================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace MarketMicroStructure
+{
+class MemoryAccount
+{
+public:
+    explicit MemoryAccount( std::string name ) : name_( std::move( name ) ) {}
+
+    void charge( std::size_t bytes )
+    {
+        const auto live = live_bytes_.fetch_add( bytes, std::memory_order_relaxed ) + bytes;
+        auto peak       = peak_bytes_.load( std::memory_order_relaxed );
+        while ( live > peak && !peak_bytes_.compare_exchange_weak( peak, live, std::memory_order_relaxed ) )
+        {
+        }
+        allocations_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void release( std::size_t bytes ) { live_bytes_.fetch_sub( bytes, std::memory_order_relaxed ); }
+
+    const std::string& name() const { return name_; }
+    std::size_t liveBytes() const { return live_bytes_.load( std::memory_order_relaxed ); }
+    std::size_t peakBytes() const { return peak_bytes_.load( std::memory_order_relaxed ); }
+    std::uint64_t allocations() const { return allocations_.load( std::memory_order_relaxed ); }
+
+private:
+    std::string name_;
+    std::atomic<std::size_t> live_bytes_{ 0 };
+    std::atomic<std::size_t> peak_bytes_{ 0 };
+    std::atomic<std::uint64_t> allocations_{ 0 };
+};
+
+/// @brief Process-wide registry of MemoryAccounts.
+/// Lookup takes a mutex and is meant for setup code; hot paths keep the
+/// returned reference, which stays valid for the life of the process.
+class MemoryRegistry
+{
+public:
+    static MemoryRegistry& instance();
+
+    /// @brief Returns the account called @p name, creating it on first use.
+    MemoryAccount& account( std::string_view name );
+
+    /// @brief Prints live and peak bytes for every account, in registration order.
+    void report( std::ostream& out ) const;
+
+private:
+    MemoryRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::deque<MemoryAccount> accounts_;  // deque: stable addresses on growth
+    std::map<std::string, MemoryAccount*, std::less<>> by_name_;
+};
+
+/// @brief Memory resource that charges every allocation to a MemoryAccount.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    explicit CountingResource( MemoryAccount& account, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource() )
+        : account_( account ), upstream_( upstream )
+    {
+    }
+
+    MemoryAccount& account() const { return account_; }
+
+private:
+    void* do_allocate( std::size_t bytes, std::size_t alignment ) override
+    {
+        void* p = upstream_->allocate( bytes, alignment );
+        account_.charge( bytes );
+        return p;
+    }
+
+    void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override
+    {
+        upstream_->deallocate( p, bytes, alignment );
+        account_.release( bytes );
+    }
+
+    bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+
+    MemoryAccount& account_;
+    std::pmr::memory_resource* upstream_;
+};
+
+/// @brief Process-level counters from getrusage(RUSAGE_SELF).
+struct ProcessMemoryStats
+{
+    std::size_t peak_rss_bytes{ 0 };
+    std::uint64_t minor_faults{ 0 };
+    std::uint64_t major_faults{ 0 };
+
+    static ProcessMemoryStats sample();
+};
+
+/// @brief Prints peak RSS and the page faults taken since @p baseline.
+void reportProcessMemory( std::ostream& out, const ProcessMemoryStats& baseline );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,146 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Order Index
+//
+// Open-addressing hash table mapping an order id to the symbol and node that
+// hold the resting order.  One probe sequence answers a cancel completely
+// (no separate id -> symbol lookup followed by a per-book lookup).
+//
+//   - Linear probing over 16-byte slots (four per cache line)
+//   - Backward-shift deletion, so there are no tombstones and misses stay short
+//   - Load factor kept <= 1/2; capacity is a power of two
+//   - A CountingBloomFilter is updated on every insert and erase; callers
+//     that expect mostly misses (cancels for unknown ids) ask mayContain()
+//     first and skip the probe on a certain miss
+//
+// Slots are allocated from caller-supplied storage: a memory resource, so
+// the index can be charged to its own MemoryAccount, or a MappedBookFile,
+// where the index outlives the process (see book_storage.h).
+// ============================================================================
+
+#include <book_storage.h>
+#include <book_types.h>
+#include <counting_bloom_filter.h>
+#include <prefetch.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+class OrderIndex
+{
+public:
+    struct Entry
+    {
+        SymbolIndex symbol{ NoSymbol };
+        NodeIndex node{ NilNode };
+    };
+
+    explicit OrderIndex( std::pmr::memory_resource* resource, std::size_t initial_capacity = 1024 )
+        : OrderIndex( BookStorage( resource ), initial_capacity )
+    {
+    }
+
+    explicit OrderIndex( BookStorage storage, std::size_t initial_capacity = 1024 );
+
+    OrderIndex( const OrderIndex& )            = delete;
+    OrderIndex& operator=( const OrderIndex& ) = delete;
+
+    /// @brief See BookVector::rebind().
+    void rebind( BookStorage storage );
+
+    /// @brief Inserts @p id; returns false if it is already present.
+    bool insert( OrderKey id, Entry entry );
+
+    /// @brief Returns the entry for @p id, or nullptr.  The pointer is
+    /// invalidated by the next insert or erase.
+    Entry* find( OrderKey id );
+    const Entry* find( OrderKey id ) const { return const_cast<OrderIndex*>( this )->find( id ); }
+
+    /// @brief False only if @p id is certainly not in the index.
+    bool mayContain( OrderKey id ) const { return filter_.mayContain( id ); }
+
+    /// @brief Prefetches the filter block and home slot of @p id (first
+    /// probe of mayContain/find/insert/erase).
+    void prefetch( OrderKey id ) const
+    {
+        if ( !slots_.empty() )
+        {
+            prefetchForWrite( filter_.blockAddress( id ) );
+            prefetchForWrite( &slots_[home( id )] );
+        }
+    }
+
+    bool erase( OrderKey id );
+
+    /// @brief Removes every entry, keeping the slot array.
+    void clear();
+
+    /// @brief Grows the slot array so @p entries fit without rehashing.
+    void reserve( std::size_t entries );
+
+    /// @brief Storage requests reserve( @p entries ) makes: one slot array
+    /// and filter per doubling.
+    std::vector<std::size_t> reserveAllocations( std::size_t entries ) const
+    {
+        std::vector<std::size_t> requests;
+        for ( std::size_t slots = slots_.size(); entries * 2 > slots; )
+        {
+            slots *= 2;
+            requests.push_back( slots * sizeof( Slot ) );
+            requests.push_back( CountingBloomFilter::bytesFor( slots * FilterCountersPerSlot ) );
+        }
+        return requests;
+    }
+
+    /// @brief What the next insert() asks the storage for: a doubled slot
+    /// array and its filter, or nothing.
+    std::array<std::size_t, 2> insertAllocations() const
+    {
+        if ( ( size_ + 1 ) * 2 <= slots_.size() )
+        {
+            return {};
+        }
+        return { slots_.size() * 2 * sizeof( Slot ), CountingBloomFilter::bytesFor( slots_.size() * 2 * FilterCountersPerSlot ) };
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return slots_.size(); }
+    std::size_t memoryBytes() const { return slots_.capacity() * sizeof( Slot ) + filter_.memoryBytes(); }
+
+private:
+    struct Slot
+    {
+        OrderKey id{};
+        Entry entry{};
+
+        bool occupied() const { return entry.symbol != NoSymbol; }
+    };
+
+    static std::size_t hash( OrderKey id )
+    {
+        auto x = static_cast<std::uint64_t>( id );
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return static_cast<std::size_t>( x );
+    }
+
+    std::size_t home( OrderKey id ) const { return hash( id ) & mask_; }
+
+    void grow();
+
+    /// Filter counters per index slot: 8 per entry at the 1/2 load limit.
+    static constexpr std::size_t FilterCountersPerSlot = 4;
+
+    BookStorage storage_;
+    BookVector<Slot> slots_;
+    CountingBloomFilter filter_;
+    std::size_t mask_{ 0 };
+    std::size_t size_{ 0 };
+};
+
+}  // namespace MarketMicroStructure
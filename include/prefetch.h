@@ -0,0 +1,32 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Software Prefetch Helpers
+//
+// Thin wrappers over __builtin_prefetch used by the EventLoop prefetch
+// pipeline.  Both hint maximum temporal locality: the line is about to be
+// touched by the event being dispatched a few iterations later.
+// ============================================================================
+
+namespace MarketMicroStructure
+{
+/// @brief Hints that the line holding @p p will be read soon.
+inline void prefetchForRead( const void* p )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __builtin_prefetch( p, 0, 3 );
+#else
+    (void) p;
+#endif
+}
+
+/// @brief Hints that the line holding @p p will be written soon.
+inline void prefetchForWrite( const void* p )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __builtin_prefetch( p, 1, 3 );
+#else
+    (void) p;
+#endif
+}
+
+}  // namespace MarketMicroStructure
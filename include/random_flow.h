@@ -0,0 +1,68 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Random Order Flow
+//
+// The simulation's synthetic NewOrder / CancelOrder stream, generated a
+// batch at a time: each refill draws whole columns (event kind, symbol,
+// side, price, quantity, ids) from a VectorRng, and next() then only
+// assembles one EngineEvent from the current row.  Ranges match the
+// original per-event generator: prices 90..110, quantities 1..500, order
+// and trader ids 1..10,000, an even split of new orders and cancels.
+// A cancel names the symbol its id was last issued on, or no symbol if
+// the id has not been issued yet.
+//
+// A (seed, stream) pair fully determines the flow, so a run can be
+// replayed from its printed seed and agents or producer threads can each
+// take their own stream.
+// ============================================================================
+
+#include <vector_rng.h>
+
+#include <common/types.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+class RandomFlow
+{
+public:
+    static constexpr std::size_t BatchSize = 1024;
+
+    static constexpr std::int64_t MinPrice = 90;
+    static constexpr std::int64_t MaxPrice = 110;
+    static constexpr std::int64_t MinQty   = 1;
+    static constexpr std::int64_t MaxQty   = 500;
+    static constexpr std::int64_t MinId    = 1;
+    static constexpr std::int64_t MaxId    = 10'000;
+
+    RandomFlow( std::span<const HFTToolset::Symbol> symbols, std::uint64_t seed, std::uint64_t stream = 0 );
+
+    /// @brief Overwrites @p ev with the next event; event_time is left to the caller.
+    void next( HFTToolset::EngineEvent& ev );
+
+private:
+    void refill();
+
+    std::span<const HFTToolset::Symbol> symbols_;
+    VectorRng rng_;
+    std::size_t cursor_{ BatchSize };
+
+    std::array<std::uint32_t, BatchSize> kinds_;  // 0 = new order, 1 = cancel
+    std::array<std::uint32_t, BatchSize> symbol_indices_;
+    std::array<std::uint32_t, BatchSize> sides_;
+    std::array<std::int64_t, BatchSize> prices_;
+    std::array<std::int64_t, BatchSize> quantities_;
+    std::array<std::int64_t, BatchSize> filled_;
+    std::array<std::int64_t, BatchSize> ids_;  // order id, or the cancel target
+    std::array<std::int64_t, BatchSize> trader_ids_;
+
+    static constexpr std::uint32_t NotIssued = ~std::uint32_t{ 0 };
+    std::vector<std::uint32_t> id_symbols_;  // per order id: symbol index last issued on
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,63 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Book-Depth / Symbol-Count Scaling Benchmark
+//
+// Builds an engine with S symbols (via add_symbol) and D resting orders
+// spread over them, then measures per-operation latency at constant depth:
+//   - add     passive limit order that rests
+//   - cancel  cancel of a uniformly random resting order
+//   - match   marketable order for one lot against a random symbol/side
+//
+// Each cancel is followed by an add of the same symbol/side, and matches
+// only shave one lot off deep resting orders, so the book never drifts away
+// from the configured depth.  Running the matrix (1K..10M orders, 3..10K
+// symbols) shows where latency falls off a cliff: L2/LLC exhaustion, TLB
+// reach, hash-table resizes.
+// ============================================================================
+
+#include <tsc_clock.h>
+
+#include <common/clock.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+struct ScalingBenchConfig
+{
+    std::vector<std::size_t> depths{ 1'000, 100'000, 10'000'000 };
+    std::vector<std::size_t> symbol_counts{ 3, 100, 1'000, 10'000 };
+    std::size_t samples{ 200'000 };  ///< Measured operations per op type and configuration
+    std::size_t levels_per_side{ 100 };
+    std::uint64_t seed{ 42 };
+};
+
+/// @brief Latency distribution of one operation type in one configuration.
+struct ScalingResult
+{
+    std::size_t symbols{ 0 };
+    std::size_t depth{ 0 };
+    std::string_view op;
+    std::size_t samples{ 0 };
+    std::uint64_t p50_ns{ 0 };
+    std::uint64_t p90_ns{ 0 };
+    std::uint64_t p99_ns{ 0 };
+    std::uint64_t p999_ns{ 0 };
+    std::uint64_t max_ns{ 0 };
+    double mean_ns{ 0.0 };
+    std::uint64_t build_ns{ 0 };  ///< Time to add the symbols and populate the book
+};
+
+/// @brief Runs the full depth x symbol-count matrix on a fresh Engine per
+/// configuration and prints one "[Scaling]" line per result as it completes.
+/// Instantiated for HFTToolset::MatchingEngine (stamping with @p clock) and
+/// SimMatchingEngine (stamping with @p tsc); both are timed with @p tsc.
+template <typename Engine>
+std::vector<ScalingResult> runScalingBenchmark( const ScalingBenchConfig& config, HFTToolset::Clock& clock, TscClock& tsc,
+                                                std::ostream& out );
+
+}  // namespace MarketMicroStructure
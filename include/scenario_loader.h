@@ -0,0 +1,69 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Scenario Loader
+//
+// Reads a recorded order-flow scenario: one event per line, whitespace
+// separated, '#' starts a comment.
+//
+//     <time_ns> A <symbol> <B|S> <price> <qty> <order_id>   add (new limit order)
+//     <time_ns> X <symbol> <B|S> <price> <qty> <order_id>   cancel
+//     <time_ns> T <symbol> <B|S> <price> <qty> <order_id>   trade (aggressor side)
+//
+// Times are nanoseconds on any epoch and must not decrease.  Fields the
+// consumer does not need may be 0 (a cancel's price, for instance).
+// saveScenario() writes the same format, so generated scenarios (see
+// stress_scenarios.h) round-trip through files.
+// ============================================================================
+
+#include <common/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+enum class ScenarioEventKind : std::uint8_t
+{
+    Add,
+    Cancel,
+    Trade
+};
+
+inline constexpr std::size_t ScenarioEventKinds = 3;
+
+struct ScenarioEvent
+{
+    HFTToolset::Timestamp time{ 0 };
+    ScenarioEventKind kind{ ScenarioEventKind::Add };
+    std::uint32_t symbol{ 0 };  ///< Index into Scenario::symbols
+    HFTToolset::Side side{ HFTToolset::Side::Buy };
+    HFTToolset::Price price{ 0 };
+    HFTToolset::Quantity quantity{ 0 };
+    HFTToolset::OrderId order_id{ 0 };
+};
+
+struct Scenario
+{
+    std::vector<std::string> symbols;  ///< In order of first appearance
+    std::vector<ScenarioEvent> events;
+
+    /// @brief Time between the first and last event, in nanoseconds.
+    HFTToolset::Timestamp duration() const { return events.empty() ? 0 : events.back().time - events.front().time; }
+};
+
+/// @brief Parses the scenario file at @p path.
+/// @return The scenario, or an error naming the file and offending line.
+std::expected<Scenario, std::string> loadScenario( const std::string& path );
+
+/// @brief Writes @p scenario to @p path in the format loadScenario() reads.
+std::expected<void, std::string> saveScenario( const std::string& path, const Scenario& scenario );
+
+/// @brief The engine event a scenario event replays as.  Adds are resting
+/// limit orders; trades are IOC market orders, so whatever they do not fill
+/// expires instead of resting crossed.  event_time is left to the caller.
+HFTToolset::EngineEvent toEngineEvent( const ScenarioEvent& ev, const HFTToolset::Symbol& symbol );
+
+}  // namespace MarketMicroStructure
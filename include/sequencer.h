@@ -0,0 +1,112 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Global Sequencer and Output Merger
+//
+// Gives a multi-shard engine one totally ordered output stream.
+//
+// Inbound: the single producer stamps every event with the next global
+// sequence number as it routes it (SequencedEvent), so arrival order is
+// the order of record.
+//
+// Outbound: each shard publishes to its own SPSC OutputRing.  Records are
+// ReplayOutputs with event = the sequence number: first the event's fills
+// as they happen (seq = 1, 2, ...), then exactly one execution report
+// (seq = 0), which closes the event.  SequenceMerger drains every ring as
+// fast as it can, so a shard never stalls on a full output ring.  Each
+// closed event goes into a reorder window indexed by sequence number, and
+// the window's head is emitted as soon as it is complete: report first,
+// then fills.  A shard's events are usually already in sequence order, but
+// not after a migration: the moved symbol's held events reach the new
+// shard behind later events of its other symbols.
+//
+// The window is a preallocated power-of-two ring of slots, reused in
+// place: a slot's fill vector trades buffers with the shard's pending
+// vector, so steady state allocates nothing.  It only doubles if the head
+// is held back by more than its size.
+//
+// No locks: each ring has one writer (its shard) and one reader (the
+// merger), and only the merger touches the window.  Every record carries
+// its inbound event's event_time, so the merged stream depends only on the
+// inbound events, never on timing or the number of shards.
+// ============================================================================
+
+#include <partitioned_replay.h>
+
+#include <common/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "HPRingBuffer.hpp"
+
+namespace MarketMicroStructure
+{
+struct SequencedEvent
+{
+    std::uint64_t sequence{ 0 };
+    HFTToolset::EngineEvent event;
+};
+
+using SequencedEventRing = HPRingBuffer<SequencedEvent, 8192>;
+using OutputRing         = HPRingBuffer<ReplayOutput, 8192>;
+
+class SequenceMerger
+{
+public:
+    using Sink = std::function<void( const ReplayOutput& )>;
+
+    /// @brief @p rings are the shards' output rings; they must outlive the
+    /// merger.
+    SequenceMerger( std::vector<OutputRing*> rings, Sink sink );
+    ~SequenceMerger();
+
+    SequenceMerger( const SequenceMerger& )            = delete;
+    SequenceMerger& operator=( const SequenceMerger& ) = delete;
+
+    /// @brief Starts the merge thread, pinned to @p core when core >= 0.
+    void start( int core = -1 );
+
+    /// @brief Returns once every sequence number below @p end has been
+    /// emitted, then stops and joins the merge thread.
+    void finish( std::uint64_t end );
+
+    /// @brief Next sequence number to be emitted; every lower one is out.
+    std::uint64_t nextSequence() const { return next_.load( std::memory_order_acquire ); }
+
+private:
+    static constexpr std::size_t InitialWindow = 16'384;  ///< Reorder slots preallocated
+
+    struct Slot
+    {
+        bool closed{ false };
+        ReplayOutput report;
+        std::vector<ReplayOutput> fills;
+    };
+
+    void run();
+
+    /// @brief Moves a shard's record into its pending fills or, for a
+    /// report, closes the event into its reorder slot.
+    void collect( std::size_t shard, const ReplayOutput& output );
+
+    /// @brief Emits the head of the window if it is closed.  False if not.
+    bool emitNext();
+
+    /// @brief Re-homes the open slots in a ring of at least @p slots.
+    void growWindow( std::size_t slots );
+
+    std::vector<OutputRing*> rings_;
+    std::vector<std::vector<ReplayOutput>> pending_;  ///< Fills of the event each shard is dispatching
+    std::vector<Slot> window_;                        ///< window_[s & (size - 1)] is sequence s, next_ <= s < next_ + size
+    Sink sink_;
+    std::thread thread_;
+    std::atomic<bool> stopping_{ false };
+    std::atomic<std::uint64_t> end_{ 0 };
+    alignas( 64 ) std::atomic<std::uint64_t> next_{ 0 };
+};
+
+}  // namespace MarketMicroStructure
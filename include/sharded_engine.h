@@ -0,0 +1,245 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Sharded Engine with Hot-Symbol Rebalancing
+//
+// Spreads symbols over several shards.  Each shard is a SimMatchingEngine
+// with its own EventLoopBuffer and consumer thread.  The producer thread
+// calls route(), which looks up the event's symbol, counts it and pushes
+// it to the owning shard's ring.  Every shard engine registers every
+// symbol, so a SymbolIndex means the same book everywhere, but only the
+// owning shard's copy ever holds orders.
+//
+// Load is tracked from the producer side per symbol and per shard: events
+// routed in total and in the current window, plus each shard's ring
+// backlog.  Every rebalance_window routed events, if the busiest shard
+// carries more than `imbalance` times the mean load, the symbol whose move
+// best evens out the busiest and idlest shards migrates between them.  A
+// symbol is only moved if the idle shard stays no busier than the hot one,
+// so a lone hot symbol stays put and the other symbols move away from it.
+//
+// Migration is quiesce - transfer - resume:
+//   1. Quiesce: the producer stops routing the symbol to its old shard and
+//      holds its new events.  It posts a Snapshot command fenced at the
+//      number of events already pushed to that shard.
+//   2. Transfer: the old shard runs the command once it has dispatched
+//      exactly that many events, so every earlier event of the symbol is
+//      in the book, and copies the book out (exportSymbol).  The producer
+//      then posts a Restore command to the new shard, fenced at that
+//      shard's pushed count.  The restore is all or nothing: it fails if
+//      any of the orders' ids already rests on the new shard.
+//   3. Resume: if the restore succeeded, routing switches over, the held
+//      events are pushed to the new shard in arrival order and a Drop
+//      command empties the old shard's copy.  If it failed, the migration
+//      is abandoned: the old shard's book was never touched, and the held
+//      events go back to it.
+// Commands are checked between events, after each pop, so a fenced command
+// can never be overtaken by an event pushed after it.  No event or order
+// is lost or reordered per symbol, and queue positions survive the move.
+// Other symbols are never paused.
+//
+// Every routed event carries a global sequence number (sequencer.h).  With
+// sequenceOutputs(), shards also publish execution reports and fills on
+// per-shard output rings, and a SequenceMerger thread turns them into one
+// stream in sequence order: the same for any shard count or migration
+// history.
+//
+// Each engine checks order ids only against its own shard, so results
+// match a single engine as long as order ids are unique across symbols and
+// every cancel names its order's symbol.
+// ============================================================================
+
+#include <clock_ref.h>
+#include <sequencer.h>
+#include <sim_event_loop.h>
+#include <sim_matching_engine.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+struct ShardConfig
+{
+    std::size_t shards{ 2 };
+    int first_core{ -1 };                      ///< Pin shard s to core first_core + s, -1 = unpinned
+    std::size_t prefault_orders{ 0 };          ///< Per-symbol reserve() on every shard engine, 0 = none
+    std::uint64_t rebalance_window{ 65'536 };  ///< Routed events between load checks, 0 = never migrate automatically
+    double imbalance{ 1.25 };                  ///< Migrate when the busiest shard exceeds this multiple of the mean
+};
+
+struct ShardLoad
+{
+    std::uint64_t routed{ 0 };   ///< Events pushed to the shard so far
+    std::uint64_t window{ 0 };   ///< Events routed to its symbols in the current window
+    std::uint64_t backlog{ 0 };  ///< Pushed but not yet dispatched
+    std::size_t symbols{ 0 };
+};
+
+struct SymbolLoad
+{
+    std::size_t shard{ 0 };
+    std::uint64_t routed{ 0 };
+    std::uint64_t window{ 0 };
+};
+
+struct ShardMigration
+{
+    SymbolIndex symbol{ NoSymbol };
+    std::size_t from{ 0 };
+    std::size_t to{ 0 };
+    std::size_t orders{ 0 };      ///< Resting orders copied from the old shard
+    std::uint64_t held{ 0 };      ///< Events held back while the book was in transit
+    std::uint64_t at_event{ 0 };  ///< Routed events before the migration began
+    bool restored{ true };        ///< False: an id collided on the new shard and the symbol stayed put
+};
+
+class ShardedEngine
+{
+public:
+    ShardedEngine( ClockRef clock, ShardConfig config );
+    ~ShardedEngine();
+
+    ShardedEngine( const ShardedEngine& )            = delete;
+    ShardedEngine& operator=( const ShardedEngine& ) = delete;
+
+    /// @brief Registers a symbol before start(); symbols are dealt to shards
+    /// round-robin.  Re-adding an existing symbol returns its index.
+    SymbolIndex add_symbol( std::string_view name );
+
+    /// @brief Before start(): publish every event's execution report and
+    /// fills, merged into sequence order on a thread pinned to @p core, and
+    /// hand them to @p sink on that thread.
+    void sequenceOutputs( SequenceMerger::Sink sink, int core = -1 );
+
+    /// @brief Starts one consumer thread per shard.  Each builds its engine
+    /// on its own (pinned) thread, so books are first-touched there.
+    void start();
+
+    /// @brief Producer thread only: routes one event to its symbol's shard.
+    /// Cancels are routed by the symbol they name, so a cancel must name
+    /// its order's symbol.  Events with no known symbol are spread over the
+    /// shards, whose engines reject them.
+    void route( const HFTToolset::EngineEvent& ev );
+
+    /// @brief Starts moving @p symbol to shard @p to.  False if a migration
+    /// is already in flight or the symbol is there already.  Producer thread
+    /// only; completes during later route() / drain() calls.
+    bool migrate( SymbolIndex symbol, std::size_t to );
+    bool migrating() const { return migration_ != nullptr; }
+
+    /// @brief Completes any migration, then waits until every shard has
+    /// dispatched everything pushed to it.
+    void drain();
+
+    /// @brief drain(), then waits for the merger to emit every sequence
+    /// number, and stops and joins all threads.  Engines stay readable
+    /// afterwards.
+    void stop();
+
+    std::size_t shardCount() const { return shards_.size(); }
+    std::size_t shardOf( SymbolIndex symbol ) const { return routes_[symbol].shard; }
+    const std::string& symbolName( SymbolIndex symbol ) const { return names_[symbol]; }
+    std::vector<ShardLoad> shardLoads() const;
+    std::vector<SymbolLoad> symbolLoads() const;
+    const std::vector<ShardMigration>& migrations() const { return history_; }
+
+    /// @brief Sum of the shard engines' counters.  After stop() only.
+    EngineStats stats() const;
+
+    /// @brief Resting orders of @p symbol on its owning shard, in queue
+    /// order.  After stop() only.
+    std::vector<HFTToolset::Order> restingOrders( SymbolIndex symbol ) const;
+
+    /// @brief Prints a "[Shards]" summary, one "[Shard]" line per shard, the
+    /// busiest symbols and one "[Migration]" line per completed migration.
+    void report( std::ostream& out ) const;
+
+private:
+    struct Command
+    {
+        enum class Kind : std::uint8_t
+        {
+            Snapshot,  ///< Copy the book out
+            Restore,   ///< Rebuild the book, all or nothing
+            Drop       ///< Empty the book
+        };
+
+        Kind kind{ Kind::Snapshot };
+        SymbolIndex symbol{ NoSymbol };
+        std::uint64_t fence{ 0 };  ///< Run once the shard has dispatched this many events
+        SymbolBookState state;     ///< Output of Snapshot, input of Restore
+        bool restored{ true };
+        std::atomic<bool> done{ false };
+    };
+
+    struct Shard
+    {
+        std::unique_ptr<SimMatchingEngine> engine;
+        RingBufferPtr<SequencedEventRing> events;
+        RingBufferPtr<OutputRing> outputs;  // set by sequenceOutputs()
+        std::thread thread;
+        std::uint64_t pushed{ 0 };  // producer side
+        std::atomic<bool> ready{ false };
+        std::atomic<bool> stopping{ false };
+        std::atomic<Command*> command{ nullptr };
+        alignas( 64 ) std::atomic<std::uint64_t> processed{ 0 };
+    };
+
+    struct Migration
+    {
+        enum class Stage : std::uint8_t
+        {
+            Snapshot,
+            Restore,
+            Drop
+        };
+
+        ShardMigration record;
+        Command snapshot;
+        Command restore;
+        Command drop;
+        std::vector<SequencedEvent> held;
+        Stage stage{ Stage::Snapshot };
+    };
+
+    struct Route
+    {
+        std::size_t shard{ 0 };
+        std::uint64_t routed{ 0 };
+        std::uint64_t window{ 0 };
+    };
+
+    void runShard( Shard& shard, int core );
+    static void serviceCommand( Shard& shard, std::uint64_t processed );
+    static void post( Shard& shard, Command& command );
+    static void publish( Shard& shard, const ReplayOutput& output );
+    SymbolIndex symbolFor( const HFTToolset::EngineEvent& ev ) const;
+    void push( Shard& shard, const SequencedEvent& ev );
+    void advanceMigration();
+    void finishMigration();
+    void rebalance();
+
+    ClockRef clock_;
+    ShardConfig config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<std::string> names_;
+    std::unordered_map<HFTToolset::Symbol, SymbolIndex> lookup_;
+    std::vector<Route> routes_;
+    std::unique_ptr<Migration> migration_;
+    std::unique_ptr<SequenceMerger> merger_;
+    int merger_core_{ -1 };
+    std::vector<ShardMigration> history_;
+    std::uint64_t routed_{ 0 };
+    std::uint64_t window_events_{ 0 };
+    bool started_{ false };
+};
+
+}  // namespace MarketMicroStructure
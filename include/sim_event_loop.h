@@ -4,20 +4,47 @@
 //
 // Provides a single-consumer event loop that pulls EngineEvent objects from
 // a lock-free HPRingBuffer and dispatches them to the HFTToolset
-// MatchingEngine.  Designed for a single-producer / single-consumer (SPSC)
+// MatchingEngine (EventLoop) or the simulation-layer SimMatchingEngine
+// (SimEventLoop).  Designed for a single-producer / single-consumer (SPSC)
 // threading model:
 //   - Producer (main thread) pushes events via EventLoopBuffer::push()
 //   - Consumer (EventLoop thread) pops and processes via run()
 //
+// With a non-zero prefetch distance K the loop claims events from the ring
+// in batches of up to MaxBatch and, while dispatching event i, issues
+// software prefetches for events i + K (index slot, price levels) and
+// i + K/2 (resting order node).  Engines without the prefetch hooks
+// (prefetchEvent / prefetchResting) always use the plain one-by-one loop.
+//
+// Symbols are listed and delisted through a second, small ring of
+// SymbolControl commands.  The producer fences each command at the number
+// of events it has pushed so far, and the loop runs it on the matching
+// thread after exactly that many events, before the next one.  A command
+// is looked for after each pop, so it can never be overtaken by an event
+// pushed after it, and matching never stops for it beyond the command
+// itself.  Only engines with add_symbol( name, spec ) and
+// remove_symbol( name ) take commands (SimMatchingEngine); for the others
+// the check compiles away.
+//
 // The EventLoopBuffer (~9 MB) MUST be heap-allocated; a convenience factory
-// function makeEventLoopBuffer() is provided for this purpose.
+// function makeEventLoopBuffer() is provided for this purpose.  Its bytes are
+// charged to the "ring_buffer" MemoryAccount.
 // ============================================================================
 
 #include <common/types.h>
 #include <market/matching_engine.h>
+#include <memory_accounting.h>
+#include <sim_matching_engine.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
+#include <optional>
+#include <string_view>
 #include <thread>
 
 #include "HPRingBuffer.hpp"
@@ -26,27 +53,122 @@ namespace MarketMicroStructure
 {
 using EventLoopBuffer = HPRingBuffer<HFTToolset::EngineEvent, 8192>;
 
+/// @brief Lists or delists a symbol between two events.
+struct SymbolControl
+{
+    enum class Kind : std::uint8_t
+    {
+        List,   ///< add_symbol( name, spec )
+        Delist  ///< remove_symbol( name )
+    };
+
+    Kind kind{ Kind::List };
+    std::array<char, 32> name{};  ///< NUL-terminated
+    SymbolSpec spec;
+    std::uint64_t fence{ 0 };  ///< Run once the loop has dispatched this many events
+
+    static SymbolControl make( Kind kind, std::string_view name, std::uint64_t fence, SymbolSpec spec = {} );
+};
+
+using ControlBuffer = HPRingBuffer<SymbolControl, 64>;
+
+/// @brief Returns a ring's storage to its counting resource.
+template <typename Ring>
+struct RingBufferDeleter
+{
+    CountingResource* resource;
+
+    void operator()( Ring* buffer ) const
+    {
+        buffer->~Ring();
+        resource->deallocate( buffer, sizeof( Ring ), alignof( Ring ) );
+    }
+};
+
+template <typename Ring>
+using RingBufferPtr = std::unique_ptr<Ring, RingBufferDeleter<Ring>>;
+
+/// @brief Creates a heap-allocated ring of any HPRingBuffer type, charged to
+/// the "ring_buffer" MemoryAccount.  Rings of large elements run to
+/// megabytes and must not be placed on the stack.
+template <typename Ring>
+RingBufferPtr<Ring> makeRingBuffer()
+{
+    static CountingResource resource( MemoryRegistry::instance().account( "ring_buffer" ) );
+
+    void* storage = resource.allocate( sizeof( Ring ), alignof( Ring ) );
+    return RingBufferPtr<Ring>( ::new ( storage ) Ring(), RingBufferDeleter<Ring>{ &resource } );
+}
+
+using EventLoopBufferPtr = RingBufferPtr<EventLoopBuffer>;
+
 /// @brief Creates a heap-allocated EventLoopBuffer.
 /// The buffer is large (sizeof(HFTToolset::EngineEvent) * 8192 bytes) and
 /// must NOT be placed on the stack to avoid stack overflow.
-inline std::unique_ptr<EventLoopBuffer> makeEventLoopBuffer()
+inline EventLoopBufferPtr makeEventLoopBuffer()
 {
-    return std::make_unique<EventLoopBuffer>();
+    return makeRingBuffer<EventLoopBuffer>();
 }
 
-class EventLoop
+/// @brief Event loop over any engine exposing process_new_order() and
+/// process_cancel(); instantiated for HFTToolset::MatchingEngine and
+/// SimMatchingEngine and SimUniverseEngine in sim_event_loop.cpp.  The
+/// SimUniverseEngine loop is declared in sim_universe.h, so only files that
+/// run the fixed engine pay for its templates.
+template <typename Engine>
+class BasicEventLoop
 {
 public:
-    explicit EventLoop( HFTToolset::MatchingEngine& engine );
+    /// Largest batch claimed from the ring per pass in prefetch mode.
+    static constexpr std::size_t MaxBatch = 32;
+
+    explicit BasicEventLoop( Engine& engine );
     void run( EventLoopBuffer& events );
-    std::thread runAsync( EventLoopBuffer& events );
+
+    /// @brief Enables the batched prefetch dispatch mode with look-ahead
+    /// @p distance (clamped to MaxBatch - 1); 0 disables it.  Must be called
+    /// before run()/runAsync().
+    void setPrefetchDistance( std::size_t distance ) { prefetch_distance_ = std::min( distance, MaxBatch - 1 ); }
+    std::size_t prefetchDistance() const { return prefetch_distance_; }
+
+    /// @brief Starts run() on a new thread, pinned to @p core when core >= 0.
+    std::thread runAsync( EventLoopBuffer& events, int core = -1 );
 
     void setWaitForDone() { wait_for_done_.store( true, std::memory_order_release ); }
     bool isDone() const { return wait_for_done_.load( std::memory_order_acquire ); }
 
+    /// @brief Number of events fully dispatched so far.  Once it equals the
+    /// number pushed, the engine is idle and may be touched by the caller.
+    std::uint64_t processedCount() const { return processed_.load( std::memory_order_acquire ); }
+
+    /// @brief Producer thread: queues @p control, whose fence must be the
+    /// number of events pushed to the ring so far (fences never decrease).
+    /// False if the control ring is full; it drains as the loop catches up.
+    bool postControl( const SymbolControl& control ) { return controls_.push( control ); }
+
+    /// @brief Number of controls run so far.  A control whose fence is
+    /// reached once the ring is empty still runs, up to the loop's exit.
+    std::uint64_t controlsApplied() const { return controls_applied_.load( std::memory_order_acquire ); }
+
 private:
-    HFTToolset::MatchingEngine& engine_;
+    void dispatch( const HFTToolset::EngineEvent& ev );
+    void runPrefetched( EventLoopBuffer& events );
+    void serviceControls( std::uint64_t processed );
+
+    Engine& engine_;
+    std::size_t prefetch_distance_{ 0 };
     std::atomic<bool> wait_for_done_{ false };
+    alignas( 64 ) std::atomic<std::uint64_t> processed_{ 0 };
+
+    ControlBuffer controls_;
+    std::optional<SymbolControl> pending_;  ///< Popped, fence not yet reached; loop thread only
+    std::atomic<std::uint64_t> controls_applied_{ 0 };
 };
 
+using EventLoop    = BasicEventLoop<HFTToolset::MatchingEngine>;
+using SimEventLoop = BasicEventLoop<SimMatchingEngine>;
+
+extern template class BasicEventLoop<HFTToolset::MatchingEngine>;
+extern template class BasicEventLoop<SimMatchingEngine>;
+
 }  // namespace MarketMicroStructure
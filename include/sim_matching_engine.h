@@ -0,0 +1,272 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Matching Engine
+//
+// Multi-symbol coordinator over SimOrderBook with the same entry points as
+// HFTToolset::MatchingEngine (add_symbol / process_new_order /
+// process_cancel), so EventLoop and the simulation driver can run either.
+//
+// Memory layout:
+//   - Each symbol owns a SymbolArena; its book's node pool, ladders and
+//     market data state are all carved from that arena, charged to the
+//     "book/<symbol>" MemoryAccount.
+//   - The engine-wide OrderIndex is charged to "order_index".
+//   - endSession() destroys every book and rewinds every arena, so teardown
+//     costs a few chunk rewinds per symbol instead of one free() per order.
+//
+// attach() moves the engine into a MappedBookFile instead: books, order
+// index, counters and the symbol table all live in the file, and a later
+// process that attaches the same file resumes with the exact book state.
+// Attaching costs one rebind per symbol, however many orders rest.  Each
+// event is bracketed by a started/applied counter pair, so a file left by a
+// process killed in the middle of an event is refused, not trusted.
+//
+// Symbols can be listed and delisted while the engine runs, from the
+// matching thread (EventLoop runs them as control events, see
+// sim_event_loop.h).  A SymbolIndex is never reused: a delisted symbol
+// keeps its slot with an empty book, and listing it again revives that
+// slot, so once an order's symbol is resolved the hot path is an index
+// into symbols_ with no extra check.  Resolving it stays one symbol_lookup_
+// probe per order: HFTToolset::Order names its symbol and has no field a
+// producer could carry a dense SymbolIndex in.
+// Other threads must not touch symbols_ or the lookup.  They read the
+// SymbolTable instead, an immutable snapshot republished on every change:
+// a reader loads the current one and keeps it as long as it needs.  table_
+// is a std::atomic<std::shared_ptr>, which libstdc++ guards with a short
+// internal lock rather than implementing lock-free, so a publication can
+// wait out a concurrent symbolTable() load (a reference-count increment),
+// though never a reader's use of its table.  A retired table is freed by
+// whichever side drops its last reference: a reader, or the matching
+// thread if no reader still holds it.  A new table shares every entry
+// chunk and lookup shard the change did not touch with the one it
+// replaces, so a control copies one of each rather than the whole universe.
+// ============================================================================
+
+#include <book_file.h>
+#include <book_storage.h>
+#include <book_types.h>
+#include <clock_ref.h>
+#include <memory_accounting.h>
+#include <order_index.h>
+#include <sim_order_book.h>
+#include <symbol_arena.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+/// @brief One symbol's book, detached from its engine: resting orders in
+/// queue order plus its trade statistics.
+struct SymbolBookState
+{
+    std::vector<HFTToolset::Order> orders;
+    MarketDataState market_data;
+};
+
+/// @brief Snapshot of an engine's symbols for threads other than the
+/// matching thread.  Never modified once published.
+struct SymbolTable
+{
+    struct Entry
+    {
+        std::string name;
+        SymbolSpec spec;
+        bool listed{ true };
+        std::size_t dropped_orders{ 0 };  ///< Resting orders discarded by its last delisting
+    };
+
+    static constexpr std::size_t ChunkEntries = 64;
+    static constexpr std::size_t LookupShards = 64;
+
+    using Chunk = std::vector<Entry>;
+    using Shard = std::unordered_map<HFTToolset::Symbol, SymbolIndex>;
+
+    std::uint64_t version{ 0 };  ///< Bumped by every publication
+    std::size_t size{ 0 };       ///< Symbols, delisted ones included
+    std::vector<std::shared_ptr<const Chunk>> chunks;  ///< ChunkEntries entries each, by SymbolIndex
+    std::array<std::shared_ptr<const Shard>, LookupShards> lookup;  ///< Listed symbols, by hash
+
+    const Entry& entry( SymbolIndex symbol ) const { return ( *chunks[symbol / ChunkEntries] )[symbol % ChunkEntries]; }
+    std::optional<SymbolIndex> find( const HFTToolset::Symbol& symbol ) const;
+
+    static std::size_t shardOf( const HFTToolset::Symbol& symbol ) { return std::hash<HFTToolset::Symbol>{}( symbol ) % LookupShards; }
+};
+
+class SimMatchingEngine
+{
+public:
+    using Stats = EngineStats;
+
+    explicit SimMatchingEngine( ClockRef clock );
+
+    SimMatchingEngine( const SimMatchingEngine& )            = delete;
+    SimMatchingEngine& operator=( const SimMatchingEngine& ) = delete;
+
+    /// @brief Signature of the types attach() keeps in a book file; a file
+    /// written under another signature is refused.
+    static std::uint64_t persistentLayout();
+
+    /// @brief Keeps every book, the order index and the counters in @p file
+    /// from now on.  A restored file brings back its symbols and books as
+    /// they were; a new one starts empty.  Must precede add_symbol(); @p file
+    /// must outlive the engine.
+    std::expected<void, std::string> attach( MappedBookFile& file );
+
+    /// @brief Registers a symbol and creates its arena and book.  @p spec
+    /// fixes the symbol's tick and lot size; orders not on that grid are
+    /// rejected.  Re-adding a listed symbol returns its index unchanged;
+    /// re-adding a delisted one lists it again, under its old index, with
+    /// @p spec.  Matching thread only once events flow.
+    SymbolIndex add_symbol( std::string_view name, SymbolSpec spec = {} );
+
+    /// @brief Delists a symbol: its resting orders are dropped (no cancels
+    /// are counted) and later orders for it are rejected.  Returns how many
+    /// orders were dropped, or nullopt if @p name is not listed.  Matching
+    /// thread only.
+    std::optional<std::size_t> remove_symbol( std::string_view name );
+
+    /// @brief The current symbol table.  Safe from any thread; briefly
+    /// contends with a publication on table_'s internal lock.
+    std::shared_ptr<const SymbolTable> symbolTable() const { return table_.load( std::memory_order_acquire ); }
+
+    void process_new_order( const HFTToolset::Order& order );
+    void process_cancel( const HFTToolset::CancelRequest& cancel );
+
+    /// @brief Stage 1 of the EventLoop prefetch pipeline, issued K events
+    /// ahead: the order-index slot for the event's id and, for new orders,
+    /// the target and opposite-best price levels.
+    void prefetchEvent( const HFTToolset::EngineEvent& ev ) const;
+
+    /// @brief Stage 2, issued K/2 events ahead once stage 1 has landed:
+    /// resolves the (now cached) index slot and prefetches the resting
+    /// order node for cancels, or the head order to be matched for new orders.
+    void prefetchResting( const HFTToolset::EngineEvent& ev ) const;
+
+    void onTrade( SimTradeCallback callback ) { on_trade_ = std::move( callback ); }
+
+    /// @brief Pre-sizes every book (now and after each endSession()) for
+    /// @p orders_per_symbol resting orders, sizes the order index to match,
+    /// and pre-faults the arenas backing them.  Attached to a book file, the
+    /// reservation is cut to fit half of the file's unused tail.  Returns
+    /// the orders per symbol actually reserved.
+    std::size_t reserve( std::size_t orders_per_symbol );
+
+    /// @brief Drops every resting order and rewinds all per-symbol arenas.
+    /// Arena chunks are kept, so the next session starts on warm memory.
+    void endSession();
+
+    /// @brief Copies @p symbol's resting orders and trade state, leaving
+    /// the book as it is.
+    SymbolBookState exportSymbol( SymbolIndex symbol ) const;
+
+    /// @brief Removes every resting order of @p symbol from this engine and
+    /// returns them, leaving the symbol registered with an empty book and a
+    /// rewound arena.  Stats are not touched: nothing was cancelled.
+    SymbolBookState extractSymbol( SymbolIndex symbol );
+
+    /// @brief Rebuilds @p symbol's (empty) book from @p state, queue
+    /// positions included.  All or nothing: if any order cannot be restored
+    /// (its id already rests in this engine, or the book refuses it) the
+    /// book is left empty and the result is false.
+    bool restoreSymbol( SymbolIndex symbol, const SymbolBookState& state );
+
+    /// @brief Symbols ever listed, delisted ones included.
+    std::size_t symbolCount() const { return symbols_.size(); }
+    bool listed( SymbolIndex symbol ) const { return symbols_[symbol]->listed; }
+    std::optional<SymbolIndex> findSymbol( const HFTToolset::Symbol& symbol ) const;
+
+    /// @brief Full order record of a resting order, for reports; joins the
+    /// book's hot node with its cold side-table entry.
+    std::optional<HFTToolset::Order> findOrder( OrderKey id ) const;
+
+    const SimOrderBook& book( SymbolIndex symbol ) const { return *symbols_[symbol]->book; }
+    const std::string& symbolName( SymbolIndex symbol ) const { return symbols_[symbol]->name; }
+    const Stats& stats() const { return state_->stats; }
+
+    /// @brief Prints the per-symbol split of orders / levels / market data.
+    void reportMemory( std::ostream& out ) const;
+
+private:
+    struct SymbolSlot
+    {
+        SymbolSlot( std::string symbol_name, SymbolSpec symbol_spec, MemoryAccount& account, MappedBookFile* file )
+            : name( std::move( symbol_name ) ), spec( symbol_spec ), arena( account ), storage( file ? file->storage() : BookStorage( &arena ) )
+        {
+        }
+
+        std::string name;
+        SymbolSpec spec;
+        SymbolArena arena;     ///< Unused once attached to a book file
+        BookStorage storage;   ///< The arena, or the book file
+        SimOrderBook* book{};  ///< Lives in storage; left there when the slot goes
+        bool listed{ true };   ///< False: empty, unreserved book, absent from the lookup
+        std::size_t dropped_orders{ 0 };
+    };
+
+    /// @brief A symbol as recorded in a book file.
+    struct StoredSymbol
+    {
+        std::array<char, 32> name{};
+        SymbolSpec spec;
+        std::uint64_t book{ 0 };  ///< Offset of its SimOrderBook
+        bool listed{ true };
+    };
+
+    /// @brief Everything besides the books that a restart must get back: on
+    /// the heap, or at the root of the book file.
+    struct EngineState
+    {
+        explicit EngineState( BookStorage storage ) : index( storage ), symbols( storage ) {}
+
+        OrderIndex index;
+        BookVector<StoredSymbol> symbols;  ///< Book file only
+        Stats stats;
+        std::uint64_t events_started{ 0 };
+        std::uint64_t events_applied{ 0 };  ///< Lags events_started only while an event is applied
+    };
+
+    void createBook( SymbolIndex symbol );
+    void destroyBook( SymbolIndex symbol );
+    void setListed( SymbolIndex symbol, bool listed );
+
+    /// @brief Book file bytes reserve( @p orders_per_symbol ) would take.
+    std::size_t reservationBytes( std::size_t orders_per_symbol ) const;
+
+    /// @brief Publishes a table built from every symbol.
+    void publishTable();
+
+    /// @brief Publishes a table where only @p symbol changed (or was
+    /// appended): its chunk and lookup shard are copied, the rest shared.
+    void publishTable( SymbolIndex symbol );
+    SymbolIndex listSymbol( std::string_view name, SymbolSpec spec );
+    std::optional<std::size_t> delistSymbol( std::string_view name );
+    void newOrder( const HFTToolset::Order& order );
+    void cancelOrder( const HFTToolset::CancelRequest& cancel );
+
+    ClockRef clock_;
+    std::vector<std::unique_ptr<SymbolSlot>> symbols_;
+    std::unordered_map<HFTToolset::Symbol, SymbolIndex> symbol_lookup_;
+
+    CountingResource index_resource_;
+    std::unique_ptr<EngineState> heap_state_;  ///< Until attach()
+    EngineState* state_;
+    MappedBookFile* file_{ nullptr };
+
+    SimTradeCallback on_trade_;
+    std::size_t reserved_orders_{ 0 };
+
+    std::atomic<std::shared_ptr<const SymbolTable>> table_;
+    std::uint64_t table_version_{ 0 };
+};
+
+}  // namespace MarketMicroStructure
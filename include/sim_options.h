@@ -0,0 +1,119 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Command-Line Options
+//
+// Parses the flags accepted by the simulation driver.  Every flag is
+// optional; running without arguments reproduces the default simulation
+// (1,000,000 random events, unpinned threads, no calibration).
+// ============================================================================
+
+#include <hot_standby.h>
+#include <journal.h>
+#include <scaling_bench.h>
+#include <stress_scenarios.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+enum class FlowModel : std::uint8_t
+{
+    Uniform,  ///< RandomFlow: i.i.d. uniform events (default)
+    Hawkes    ///< HawkesFlow: self- and cross-exciting adds, cancels and trades
+};
+
+enum class EngineBackend : std::uint8_t
+{
+    HFTToolset,  ///< HFTToolset::MatchingEngine (default)
+    Sim,         ///< Simulation-layer SimMatchingEngine with per-symbol arenas
+    Fixed        ///< Compile-time specialized SimUniverseEngine (sim_universe.h)
+};
+
+/// @brief A --list / --delist entry: applied once the producer has pushed
+/// at_event timed events.
+struct SymbolChange
+{
+    std::uint64_t at_event{ 0 };
+    std::string name;
+    bool list{ true };  ///< False: delist
+};
+
+struct SimOptions
+{
+    bool show_help{ false };
+
+    std::uint64_t events{ 1'000'000 };
+    EngineBackend engine{ EngineBackend::HFTToolset };
+    std::uint64_t seed{ 0 };  ///< Random-flow seed, 0 = draw one from std::random_device
+
+    FlowModel flow{ FlowModel::Uniform };
+    std::string flow_scenario;  ///< Recorded scenario the Hawkes parameters are fitted to (empty = defaults)
+    bool flow_pacing{ false };  ///< Release Hawkes events at their simulated times instead of back to back
+
+    int producer_core{ -1 };  ///< Core for the producer (main) thread, -1 = unpinned
+    int loop_core{ -1 };      ///< Core for the EventLoop thread, -1 = unpinned
+
+    bool calibrate{ false };  ///< Run the jitter detector before and after the simulation
+    std::chrono::milliseconds calibrate_duration{ 500 };
+    std::chrono::nanoseconds calibrate_threshold{ 200 };
+
+    std::uint64_t warmup_events{ 200'000 };  ///< Synthetic events run before the timed region (0 = off)
+    std::size_t prefault_orders{ 16'384 };   ///< Per-symbol resting orders pre-sized and pre-faulted (sim engine)
+    bool lock_memory{ false };               ///< mlockall() before allocating the ring and books
+
+    std::size_t prefetch_distance{ 0 };  ///< EventLoop look-ahead in events (sim engine), 0 = one-by-one dispatch
+
+    bool memory_report{ false };  ///< Print per-subsystem bytes, peak RSS and page faults at exit
+
+    bool scaling_bench{ false };  ///< Run the depth x symbol-count benchmark instead of the simulation
+    ScalingBenchConfig scaling;
+
+    bool stress_bench{ false };             ///< Replay stress scenarios instead of the simulation
+    std::vector<std::string> stress_names;  ///< Scenarios to run, empty = all
+    StressConfig stress;
+    std::string stress_save_dir;  ///< Also write each generated scenario here (empty = don't)
+
+    std::string l3_replay;            ///< L3 feed to replay and check instead of the simulation (empty = off)
+    std::size_t replay_threads{ 0 };  ///< Replay workers / partitions, 0 = one per hardware thread
+
+    std::string partitioned_replay;  ///< Scenario to replay partitioned by symbol instead of the simulation (empty = off)
+    int replay_first_core{ -1 };     ///< Pin replay partition p to core replay_first_core + p, -1 = unpinned
+
+    std::size_t shards{ 0 };                   ///< Run the simulation on a ShardedEngine with this many shards (0 = off)
+    std::uint64_t rebalance_window{ 65'536 };  ///< Routed events between shard load checks, 0 = no automatic migration
+    bool sequenced{ false };                   ///< Merge shard reports and fills into one stream in global sequence order
+
+    std::string replica_publish;  ///< Shared-memory segment to publish inbound events to for a hot standby (empty = off)
+    std::string replica;          ///< Run as the hot standby of this segment instead of the simulation (empty = off)
+    ReplicationConfig replication;
+
+    std::string journal_dir;   ///< Write events.journal and trades.journal here (empty = off)
+    std::string journal_info;  ///< Check and summarise this journal instead of the simulation (empty = off)
+    JournalConfig journal;
+
+    std::string journal_find;                 ///< Look records up in this journal through its sidecar index (empty = off)
+    std::optional<std::uint64_t> find_order;  ///< --journal-find: records referencing this order id
+    std::optional<std::uint64_t> find_from;   ///< --journal-find: records with find_from <= time < find_to
+    std::uint64_t find_to{ 0 };
+
+    std::string book_file;             ///< Keep the simulation engine's books in this mapped file (empty = off)
+    std::size_t book_file_mb{ 1024 };  ///< Capacity of a new book file
+
+    std::vector<SymbolChange> symbol_changes;  ///< Runtime listings and delistings, ordered by at_event
+};
+
+/// @brief Parses argv into SimOptions.
+/// @return The parsed options, or an error message (including usage) on an
+///         unknown flag or malformed value.
+std::expected<SimOptions, std::string> parseSimOptions( int argc, char** argv );
+
+/// @brief Usage text listing every supported flag.
+std::string simOptionsUsage( const char* program );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,261 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Order Book
+//
+// Price-time priority L3 book for one symbol, owned by the simulation layer
+// so that its memory layout is under our control:
+//
+//   - Order nodes live in one node pool indexed by NodeIndex; each price level
+//     is an intrusive FIFO (head/tail/prev/next are pool indices, not pointers)
+//   - Prices are tick counts and quantities lot counts on the symbol's
+//     SymbolSpec grid; HFTToolset units appear only at the edges (submit,
+//     trades, market data, reports)
+//   - Price levels live in a dense ladder per side, indexed directly by
+//     (ticks - ladder base); the ladder grows and re-centres on demand.
+//     Per-level quantities sit in their own contiguous array so large
+//     aggressive orders can be sized with a SIMD prefix sum
+//   - Each node holds only the hot fields matching and cancel touch (id,
+//     price, quantities, side, queue links); the cold remainder of the order
+//     (trader, client order id, timestamps, TIF) lives in a parallel side
+//     table indexed by the same NodeIndex and is read only to build reports
+//   - Market data state (TOB, last trade, volume) sits next to the book
+//
+// Every container is a BookVector carved from the BookStorage handed in at
+// construction: normally the symbol's SymbolArena, or a MappedBookFile that
+// keeps the book across restarts.  Pools are linked by index and arrays
+// recorded by offset, so a mapped book needs only rebind() to be used by a
+// new process.  Resting orders are registered in the engine-wide
+// OrderIndex so cancels resolve in one probe.
+// ============================================================================
+
+#include <book_storage.h>
+#include <book_types.h>
+#include <order_index.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+class SimOrderBook
+{
+public:
+    /// @brief Ladders never span more levels than this; orders priced
+    /// further away from the current range are rejected.
+    static constexpr std::size_t MaxLadderLevels = std::size_t{ 1 } << 20;
+
+    /// @brief Initial ladder size; kept small because thousands of mostly
+    /// idle symbols would otherwise pay for wide empty ladders.
+    static constexpr std::size_t MinLadderLevels = 64;
+
+    /// @brief A compaction sweep starts once at least this many tombstones
+    /// have built up and they outnumber the live resting orders.
+    static constexpr std::size_t CompactionMinTombstones = 256;
+
+    /// @brief Nodes a running sweep examines per submit() or cancel(), so no
+    /// single event pays for the whole pool.
+    static constexpr std::size_t CompactionStepNodes = 64;
+
+    enum class SubmitResult : std::uint8_t
+    {
+        Rested,   ///< Remainder (possibly all of it) rests on the book
+        Filled,   ///< Fully filled on arrival
+        Expired,  ///< Market order remainder discarded after matching
+        Rejected  ///< Price or quantity off the symbol's grid or out of range, or price outside the ladder limit
+    };
+
+    /// @brief Hot part of a resting order.
+    struct Node
+    {
+        OrderKey id{};
+        Ticks price{};
+        NodeQty quantity{};    ///< Original order quantity, in lots
+        NodeQty filled_qty{};  ///< Filled so far (lots), including fills on arrival
+        NodeIndex prev{ NilNode };
+        NodeIndex next{ NilNode };
+        HFTToolset::Side side{ HFTToolset::Side::Buy };
+        bool tombstone{ false };  ///< Cancelled but still linked into its level's FIFO
+
+        NodeQty open() const { return quantity - filled_qty; }
+    };
+
+    /// @brief Cold part of a resting order, parallel to the node pool.
+    struct ColdOrder
+    {
+        TraderKey trader_id{};
+        HFTToolset::Timestamp submit_time{};
+        HFTToolset::Timestamp accept_time{};
+        decltype( HFTToolset::Order::cl_ord_id ) cl_ord_id{};
+        HFTToolset::TimeInForce tif{};
+    };
+
+    struct Level
+    {
+        NodeIndex head{ NilNode };
+        NodeIndex tail{ NilNode };
+        std::uint32_t count{ 0 };  ///< Live orders; the FIFO may also hold tombstones
+    };
+
+    struct MemoryUsage
+    {
+        std::size_t orders{ 0 };
+        std::size_t levels{ 0 };
+        std::size_t market_data{ 0 };
+    };
+
+    SimOrderBook( SymbolIndex symbol, SymbolSpec spec, OrderIndex& index, BookStorage storage );
+
+    SimOrderBook( const SimOrderBook& )            = delete;
+    SimOrderBook& operator=( const SimOrderBook& ) = delete;
+
+    /// @brief Adopts a book found in mapped storage written by another
+    /// process: re-derives every cached pointer and clears the trade sink.
+    /// O(1) whatever the number of resting orders.
+    void rebind( OrderIndex& index, BookStorage storage );
+
+    /// @brief Sink for fills; trades are only built when it is set and non-empty.
+    void setTradeSink( const SimTradeCallback* sink ) { trade_sink_ = sink; }
+
+    /// @brief Matches @p order against the opposite side and rests any limit
+    /// remainder.  The caller guarantees the order id is not already resting.
+    SubmitResult submit( const HFTToolset::Order& order, HFTToolset::Timestamp now );
+
+    /// @brief Largest storage requests submit( @p order ) can make: ladder
+    /// growth (levels, quantities) and node pool growth (nodes, cold table).
+    /// Zero where no growth is possible.  The order index is separate.
+    std::array<std::size_t, 4> submitAllocations( const HFTToolset::Order& order ) const;
+
+    /// @brief Cancels a resting order by tombstoning it.  The caller owns
+    /// the OrderIndex entry.
+    void cancel( NodeIndex node );
+
+    /// @brief Unlinks and frees every tombstone in one pass.  Events only
+    /// ever run the bounded compactStep(); this is for quiet points.
+    void compact();
+
+    /// @brief Prefetch-pipeline hooks (see SimMatchingEngine::prefetchEvent).
+    /// Both are pure hints: out-of-range arguments are ignored.
+    void prefetchLevels( HFTToolset::Side side, OrderPrice price ) const;
+    void prefetchNode( NodeIndex node ) const;
+
+    /// @brief Prefetches the head order of the best level an incoming order
+    /// on @p side would match against.  Reads that level, so it should have
+    /// been prefetched by prefetchLevels() a few events earlier.
+    void prefetchMatchHead( HFTToolset::Side side ) const;
+
+    /// @brief Rebuilds the full order record of a resting node from its hot
+    /// and cold parts.  Report path only.
+    HFTToolset::Order restingOrder( NodeIndex node, const HFTToolset::Symbol& symbol ) const;
+
+    /// @brief Every live resting order, bids then asks, each side best level
+    /// first and FIFO within a level: re-adding them in this order through
+    /// restore() rebuilds the same queues.
+    std::vector<HFTToolset::Order> exportOrders( const HFTToolset::Symbol& symbol ) const;
+
+    /// @brief Rests @p order (as returned by exportOrders()) at the tail of
+    /// its level without matching, keeping its fill and accept time.  The
+    /// caller guarantees the book is not crossed by it and the id is new.
+    /// False if it is off the grid, outside the ladder limit, or its
+    /// quantity fails submit()'s checks or is already fully filled.
+    bool restore( const HFTToolset::Order& order );
+
+    /// @brief Copies last trade, volume and trade count from another book's
+    /// market data; top of book is always derived from the resting orders.
+    void restoreTradeState( const MarketDataState& state );
+
+    /// @brief Sizes the node pool and cold table for @p orders resting orders.
+    void reserve( std::size_t orders )
+    {
+        nodes_.reserve( orders );
+        cold_.reserve( orders );
+    }
+
+    /// @brief Storage requests reserve( @p orders ) makes: node pool and
+    /// cold table, zero where the capacity is already there.
+    std::array<std::size_t, 2> reserveAllocations( std::size_t orders ) const
+    {
+        return { orders > nodes_.capacity() ? orders * sizeof( Node ) : 0, orders > cold_.capacity() ? orders * sizeof( ColdOrder ) : 0 };
+    }
+
+    std::optional<OrderPrice> bestBid() const { return bestPrice( bids_ ); }
+    std::optional<OrderPrice> bestAsk() const { return bestPrice( asks_ ); }
+
+    const SymbolSpec& spec() const { return spec_; }
+
+    /// @brief Converts a price to ticks; nullopt if it is off the tick grid
+    /// or outside [0, Ticks max] ticks.
+    std::optional<Ticks> toTicks( OrderPrice price ) const;
+    OrderPrice toPrice( Ticks ticks ) const { return static_cast<OrderPrice>( ticks ) * spec_.tick_size; }
+
+    /// @brief Converts a quantity to lots; nullopt unless it is positive, a
+    /// whole number of lots and within NodeQty.
+    std::optional<NodeQty> toLots( OrderQty quantity ) const;
+
+    const MarketDataState& marketData() const { return market_data_; }
+    std::size_t restingOrders() const { return resting_; }
+    std::size_t tombstones() const { return tombstones_; }
+    MemoryUsage memoryUsage() const;
+
+private:
+    struct Ladder
+    {
+        explicit Ladder( BookStorage storage, bool is_bid ) : levels( storage ), qty( storage ), bid( is_bid ) {}
+
+        std::int64_t base{ 0 };  ///< Tick count of levels[0]
+        BookVector<Level> levels;
+        BookVector<std::uint64_t> qty;  ///< Resting lots per level, parallel to levels (sweep input)
+        std::int64_t best{ -1 };  ///< Index of the best non-empty level, -1 if none
+        std::size_t non_empty{ 0 };
+        bool bid;
+    };
+
+    /// @brief Level count and base ensureRange() gives @p ladder to cover
+    /// @p price: a size of 0 if it already does, nullopt if the span would
+    /// exceed MaxLadderLevels.
+    static std::optional<std::pair<std::size_t, std::int64_t>> ladderGrowth( const Ladder& ladder, Ticks price );
+
+    std::optional<OrderPrice> bestPrice( const Ladder& ladder ) const;
+    static bool ensureRange( Ladder& ladder, Ticks price );
+
+    /// @brief Reaps the tombstones among the next CompactionStepNodes nodes
+    /// of the running sweep; the sweep ends at the end of the pool.
+    void compactStep();
+    static void levelFilled( Ladder& ladder, std::int64_t idx );
+    static void levelEmptied( Ladder& ladder, std::int64_t idx );
+
+    NodeIndex allocateNode();
+    void freeNode( NodeIndex node );
+    void unlink( Level& level, NodeIndex node );
+
+    /// @brief Links a new node at the tail of its level and indexes it.  The
+    /// ladder must already cover @p price.
+    void rest( const HFTToolset::Order& order, Ticks price, NodeQty quantity, NodeQty filled, HFTToolset::Timestamp accept_time );
+
+    void recordFill( const HFTToolset::Order& taker, NodeIndex maker, OrderPrice price, NodeQty fill, HFTToolset::Timestamp now );
+    NodeQty sweep( Ladder& ladder, const HFTToolset::Order& order, std::optional<Ticks> limit, NodeQty remaining, HFTToolset::Timestamp now );
+    NodeQty match( const HFTToolset::Order& order, std::optional<Ticks> limit, NodeQty remaining, HFTToolset::Timestamp now );
+    void refreshTopOfBook();
+
+    SymbolIndex symbol_;
+    SymbolSpec spec_;
+    OrderIndex* index_;
+    const SimTradeCallback* trade_sink_{ nullptr };
+
+    BookVector<Node> nodes_;
+    BookVector<ColdOrder> cold_;  // indexed like nodes_
+    NodeIndex free_head_{ NilNode };
+    std::size_t resting_{ 0 };
+    std::size_t tombstones_{ 0 };
+    NodeIndex compact_cursor_{ 0 };  // next node the running sweep examines
+    bool compacting_{ false };
+
+    Ladder bids_;
+    Ladder asks_;
+    MarketDataState market_data_;
+};
+
+}  // namespace MarketMicroStructure
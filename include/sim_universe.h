@@ -0,0 +1,24 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Universe
+//
+// The compile-time specialized engine used by --engine=fixed: the three
+// simulated symbols, integer prices on a unit tick within [0, 256), and
+// 16K resting orders per symbol (ids of the random flow stay below 10K,
+// warm-up orders are cancelled as they go).
+// ============================================================================
+
+#include <fixed_universe_engine.h>
+#include <sim_event_loop.h>
+
+namespace MarketMicroStructure
+{
+using SimUniverseEngine = FixedUniverseEngine<FixedSymbol<"XAUUSD", 1, 1, 0, 256, 16'384>,
+                                              FixedSymbol<"EURUSD", 1, 1, 0, 256, 16'384>,
+                                              FixedSymbol<"BTCUSD", 1, 1, 0, 256, 16'384>>;
+
+using FixedEventLoop = BasicEventLoop<SimUniverseEngine>;
+
+extern template class BasicEventLoop<SimUniverseEngine>;
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,114 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Stress Scenario Library
+//
+// Named, seeded generators for the flow patterns behind production
+// incidents, each built as a Scenario (scenario_loader.h) so it can be
+// saved, reloaded, fitted by fitHawkes(), or replayed through an engine:
+//
+//   flash_crash      bids on one symbol are pulled while marketable sells
+//                    sweep down through every level, then the book refills
+//   quote_stuffing   one participant adds and cancels at the top of one
+//                    book at a very high rate over a normal background
+//   opening_burst    an empty book meets a dense wave of crossing orders on
+//                    every symbol, thinning out to the normal rate
+//   cancel_storm     after "news", most resting liquidity is cancelled and
+//                    re-quoted further out, across all symbols
+//   book_depletion   marketable buys consume one side of one book while
+//                    only the other side is replenished
+//   hot_symbol       thousands of small books, nine events in ten on one
+//
+// Every scenario starts with setup_events adds that build the initial book
+// (not measured), followed by the measured events.  runStressBenchmark()
+// replays scenarios through an engine, times every measured event, and
+// compares throughput and p99 with the scenario's recorded baseline.
+// ============================================================================
+
+#include <scenario_loader.h>
+#include <tsc_clock.h>
+
+#include <common/clock.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+struct StressConfig
+{
+    std::size_t events{ 200'000 };      ///< Measured events per scenario
+    std::size_t symbols{ 0 };           ///< 0 = the scenario's default
+    std::size_t levels{ 0 };            ///< Initial levels per side per symbol, 0 = default
+    std::size_t orders_per_level{ 0 };  ///< 0 = default
+    std::uint64_t seed{ 42 };
+};
+
+/// @brief Reference numbers for one scenario: SimMatchingEngine, default
+/// parameters, 200K measured events, on the development host.
+struct StressBaseline
+{
+    double events_per_sec{ 0.0 };
+    std::uint64_t p99_ns{ 0 };
+};
+
+struct StressScenarioInfo
+{
+    std::string_view name;
+    std::string_view description;
+    std::size_t symbols;
+    std::size_t levels;
+    std::size_t orders_per_level;
+    StressBaseline baseline;
+};
+
+struct StressScenario
+{
+    const StressScenarioInfo* info{ nullptr };
+    Scenario scenario;
+    std::size_t setup_events{ 0 };  ///< Leading events that build the initial book
+};
+
+/// @brief Every scenario in the library, in a fixed order.
+std::span<const StressScenarioInfo> stressScenarios();
+
+/// @brief Looks up a scenario by name.
+const StressScenarioInfo* findStressScenario( std::string_view name );
+
+/// @brief Generates @p info's scenario; the same config always yields the
+/// same events.
+StressScenario makeStressScenario( const StressScenarioInfo& info, const StressConfig& config );
+
+struct StressResult
+{
+    std::string_view name;
+    std::size_t events{ 0 };
+    double events_per_sec{ 0.0 };
+    double mean_ns{ 0.0 };
+    std::uint64_t p50_ns{ 0 };
+    std::uint64_t p99_ns{ 0 };
+    std::uint64_t p999_ns{ 0 };
+    std::uint64_t max_ns{ 0 };
+
+    /// @brief False if throughput fell below half the baseline or p99 rose
+    /// above twice it; empty when no baseline applies (another engine, or
+    /// non-default parameters).
+    std::optional<bool> within_baseline;
+};
+
+/// @brief Replays each named scenario (all of them if @p names is empty)
+/// on a fresh Engine and prints one "[Stress]" line per scenario.  With
+/// @p save_dir set, each generated scenario is also written there as
+/// <name>.scenario.  Instantiated for HFTToolset::MatchingEngine and
+/// SimMatchingEngine; HFTToolset's engine stamps with @p clock, the sim
+/// engine with @p tsc, and both are timed with @p tsc.
+template <typename Engine>
+std::vector<StressResult> runStressBenchmark( std::span<const std::string> names, const StressConfig& config, const std::string& save_dir,
+                                              HFTToolset::Clock& clock, TscClock& tsc, std::ostream& out );
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,93 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Per-Symbol Arena
+//
+// Chunked bump allocator exposed as a std::pmr::memory_resource.  Each symbol
+// owns one arena and every container of its book (order nodes, price levels,
+// market data state) allocates from it, so a symbol's hot data stays in a
+// handful of large contiguous chunks instead of being interleaved with every
+// other symbol on the global heap.
+//
+//   - Small blocks (<= SmallBlockMax bytes) freed back to the arena go onto a
+//     per-size-class free list and are reused.
+//   - Larger frees (e.g. a vector's old buffer after growth) are simply
+//     abandoned until the next reset().
+//   - reset()   rewinds every chunk and keeps it for the next session: O(chunks)
+//   - release() returns every chunk upstream: O(chunks)
+//
+// Not thread-safe: an arena is owned by the single thread that matches the
+// symbol.  Chunks come from a CountingResource, so the arena's footprint is
+// charged to the symbol's MemoryAccount.
+// ============================================================================
+
+#include <memory_accounting.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+class SymbolArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t DefaultChunkSize = 4 * 1024;
+    static constexpr std::size_t MaxChunkSize     = 64 * 1024 * 1024;
+    static constexpr std::size_t SmallBlockMax    = 256;
+
+    explicit SymbolArena( MemoryAccount& account, std::size_t first_chunk_size = DefaultChunkSize );
+    ~SymbolArena() override;
+
+    SymbolArena( const SymbolArena& )            = delete;
+    SymbolArena& operator=( const SymbolArena& ) = delete;
+
+    /// @brief Makes every chunk available again without returning it upstream.
+    /// All objects allocated from the arena must already be dead.
+    void reset();
+
+    /// @brief Returns every chunk to the upstream resource.
+    void release();
+
+    /// @brief Grows the arena to at least @p bytes of chunk capacity and
+    /// writes one byte per page of every chunk, so no page fault is taken
+    /// later on the matching path.  Chunks survive reset().
+    void prefault( std::size_t bytes );
+
+    std::size_t reservedBytes() const { return reserved_bytes_; }
+    std::size_t usedBytes() const;
+
+private:
+    struct Chunk
+    {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static constexpr std::size_t SizeClassGranularity = 16;
+    static constexpr std::size_t SizeClasses          = SmallBlockMax / SizeClassGranularity;
+
+    static std::size_t sizeClass( std::size_t bytes ) { return ( bytes + SizeClassGranularity - 1 ) / SizeClassGranularity - 1; }
+
+    void* do_allocate( std::size_t bytes, std::size_t alignment ) override;
+    void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override;
+    bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+
+    void* bump( std::size_t bytes, std::size_t alignment );
+    void addChunk( std::size_t min_bytes );
+
+    CountingResource upstream_;
+    std::vector<Chunk> chunks_;
+    std::size_t current_{ 0 };  ///< Index of the chunk being bumped
+    std::size_t offset_{ 0 };   ///< Bump offset inside chunks_[current_]
+    std::size_t next_chunk_size_;
+    std::size_t reserved_bytes_{ 0 };
+    std::array<FreeBlock*, SizeClasses> free_lists_{};
+};
+
+}  // namespace MarketMicroStructure
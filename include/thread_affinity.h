@@ -0,0 +1,37 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Thread Affinity Helpers
+//
+// Pins the calling thread to a single CPU core so that the producer and
+// EventLoop threads (and the jitter calibration loops that stand in for
+// them) always run on the same, known cores.  A negative core id means
+// "leave the thread where the scheduler puts it".
+// ============================================================================
+
+#if defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace MarketMicroStructure
+{
+/// @brief Pins the calling thread to @p core.
+/// @return true on success, false if @p core is negative or pinning is not
+///         supported on this platform.
+inline bool pinCurrentThreadToCore( int core )
+{
+    if ( core < 0 )
+    {
+        return false;
+    }
+#if defined( __linux__ )
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    CPU_SET( core, &set );
+    return pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace MarketMicroStructure
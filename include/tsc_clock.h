@@ -0,0 +1,124 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — TSC Clock
+//
+// Nanosecond clock read from the invariant TSC instead of a clock_gettime()
+// call:
+//   - At construction the TSC rate is calibrated against CLOCK_MONOTONIC
+//     over a short busy-wait window, and both clocks are anchored together
+//   - now() is one rdtsc, a subtraction and a 64x64 -> 128-bit multiply by a
+//     fixed-point ns-per-tick factor; the result is on the CLOCK_MONOTONIC
+//     time base, so it mixes with steady_clock timestamps
+//   - checkDrift() compares now() with CLOCK_MONOTONIC and, past the
+//     configured bound, re-calibrates and re-anchors; sampleDrift() only
+//     measures, so it can run while other threads read the clock
+//   - ticks() / ticksPerNs() time short intervals in raw counter ticks,
+//     converted once per result: every benchmark and the jitter detector
+//     use this one calibration
+//
+// Without an invariant TSC (or off x86) now() falls back to CLOCK_MONOTONIC.
+// ============================================================================
+
+#include <common/types.h>
+
+#include <chrono>
+#include <cstdint>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+namespace MarketMicroStructure
+{
+/// @brief Reads the CPU timestamp counter (falls back to steady_clock ticks
+/// on non-x86 targets).
+inline std::uint64_t readTsc()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>( std::chrono::steady_clock::now().time_since_epoch().count() );
+#endif
+}
+
+class TscClock
+{
+public:
+    struct Config
+    {
+        std::chrono::milliseconds calibration{ 50 };
+        std::chrono::nanoseconds max_drift{ 1'000 };  ///< checkDrift() re-anchors beyond this
+    };
+
+    struct DriftSample
+    {
+        std::int64_t drift_ns{ 0 };  ///< now() minus CLOCK_MONOTONIC at the check
+        bool recalibrated{ false };
+    };
+
+    /// @brief Every drift sample taken so far.
+    struct DriftStats
+    {
+        std::uint64_t checks{ 0 };
+        std::uint64_t recalibrations{ 0 };
+        std::int64_t max_drift_ns{ 0 };  ///< Largest |drift| seen
+    };
+
+    TscClock();
+    explicit TscClock( Config config );
+
+    /// @brief True if CPUID reports an invariant (constant-rate, non-stop) TSC.
+    static bool invariantTscAvailable();
+
+    /// @brief CLOCK_MONOTONIC in nanoseconds.
+    static HFTToolset::Timestamp monotonicNow();
+
+    HFTToolset::Timestamp now() const
+    {
+        if ( !use_tsc_ )
+        {
+            return monotonicNow();
+        }
+        return toNanoseconds( readTsc() );
+    }
+
+    /// @brief Raw reading for interval timing: TSC ticks, or nanoseconds
+    /// without a usable TSC.  Divide differences by ticksPerNs().
+    std::uint64_t ticks() const { return use_tsc_ ? readTsc() : monotonicNow(); }
+
+    /// @brief Converts a raw TSC reading to the clock's nanosecond time base.
+    HFTToolset::Timestamp toNanoseconds( std::uint64_t tsc ) const
+    {
+        const auto delta = static_cast<unsigned __int128>( tsc - tsc_base_ );
+        return ns_base_ + static_cast<HFTToolset::Timestamp>( ( delta * ns_per_tick_fixed_ ) >> FixedShift );
+    }
+
+    /// @brief Measures drift against CLOCK_MONOTONIC and re-calibrates if it
+    /// exceeds Config::max_drift.  Re-calibration rewrites the anchor, so
+    /// call it only while no other thread is reading this clock.
+    DriftSample checkDrift();
+
+    /// @brief Measures drift like checkDrift() but never re-anchors, so it
+    /// is safe while other threads read the clock.  One caller at a time.
+    DriftSample sampleDrift();
+
+    const DriftStats& driftStats() const { return drift_stats_; }
+
+    bool usingTsc() const { return use_tsc_; }
+    double ticksPerNs() const { return ticks_per_ns_; }
+
+private:
+    static constexpr unsigned FixedShift = 32;
+
+    void calibrate();
+
+    Config config_;
+    bool use_tsc_;
+    double ticks_per_ns_{ 1.0 };
+    std::uint64_t tsc_base_{ 0 };
+    HFTToolset::Timestamp ns_base_{ 0 };
+    std::uint64_t ns_per_tick_fixed_{ 0 };  ///< ns per tick, scaled by 2^FixedShift
+    DriftStats drift_stats_;                ///< Written by the drift checks only; now() never reads it
+};
+
+}  // namespace MarketMicroStructure
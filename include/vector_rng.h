@@ -0,0 +1,83 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Vectorized Random Generation
+//
+// VectorRng runs Lanes independent xoshiro256** generators side by side,
+// with the state held lane-major (word w of every lane is one contiguous
+// row) so that with AVX2 one step advances all four lanes in a single set
+// of 256-bit shifts, xors and adds.  The ** scrambler's multiplies by 5
+// and 9 are shift-and-add, so no 64-bit vector multiply is needed.
+//
+//   - fill()         raw 64-bit words
+//   - fillBounded()  uniform in [0, bound), bias-free: Lemire's
+//                    multiply-shift on 32-bit words, rejecting the few
+//                    words whose low product half falls under 2^32 % bound
+//   - fillUniform()  uniform in [lo, hi], widened to int64
+//   - next() / below() / unit()  one value at a time, for generators that
+//                    draw per event
+//
+// Seeding is reproducible and random-access: lane l of stream s takes its
+// four state words from the SplitMix64 sequence of the seed at positions
+// (s * Lanes + l) * 4 ... + 3, so streams for different agents or threads
+// are independent of how many other streams exist or in which order they
+// are created.  The scalar path (no AVX2) produces identical output.
+//
+// Each fill call consumes whole 8-word blocks; the unused words of a
+// partial final block are dropped, so output depends on the sequence of
+// call sizes as well as the seed.
+// ============================================================================
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace MarketMicroStructure
+{
+class VectorRng
+{
+public:
+    static constexpr std::size_t Lanes = 4;
+
+    /// 32-bit words produced per step: two per 64-bit lane output.
+    static constexpr std::size_t BlockWords = Lanes * 2;
+
+    explicit VectorRng( std::uint64_t seed, std::uint64_t stream = 0 );
+
+    /// @brief Fills @p out with @p n raw 64-bit words.
+    void fill( std::uint64_t* out, std::size_t n );
+
+    /// @brief Fills @p out with @p n values uniform in [0, bound); @p bound > 0.
+    void fillBounded( std::uint32_t* out, std::size_t n, std::uint32_t bound );
+
+    /// @brief Fills @p out with @p n values uniform in [lo, hi]; hi - lo < 2^32 - 1.
+    void fillUniform( std::int64_t* out, std::size_t n, std::int64_t lo, std::int64_t hi );
+
+    /// @brief Scalar draws for event-at-a-time consumers, served from a
+    /// buffered step; they share the lanes with the fills.
+    std::uint64_t next();
+    std::uint32_t below( std::uint32_t bound );  ///< Uniform in [0, bound), unbiased; @p bound > 0
+    double unit();                               ///< Uniform in (0, 1]
+
+    std::uint64_t seed() const { return seed_; }
+    std::uint64_t stream() const { return stream_; }
+
+private:
+    /// @brief Advances every lane one step and writes their outputs.
+    void step( std::uint64_t* out );
+
+    /// @brief Next 8 values in [0, bound), rejected words redrawn in order.
+    void boundedBlock( std::uint32_t* out, std::uint32_t bound, std::uint32_t threshold );
+
+    /// @brief Next raw 32-bit word, for replacing rejected draws.
+    std::uint32_t spareWord();
+
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+    alignas( 32 ) std::array<std::array<std::uint64_t, Lanes>, 4> state_;  // state_[word][lane]
+    alignas( 32 ) std::array<std::uint32_t, BlockWords> spare_{};
+    std::size_t spare_used_{ BlockWords };
+    alignas( 32 ) std::array<std::uint64_t, Lanes> scalar_{};
+    std::size_t scalar_used_{ Lanes };
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,62 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Warm-Up and Pre-Faulting
+//
+// Helpers for the warm-up phase that runs before the timed region:
+//   - prefaultPages()   write-touches one byte per page of a buffer
+//   - lockAllMemory()   mlockall(MCL_CURRENT | MCL_FUTURE)
+//   - WarmupFlow        deterministic synthetic NewOrder / CancelOrder flow
+//                       on order ids reserved for warm-up, ending with a
+//                       cancel for every id it issued so no warm-up order is
+//                       left resting in the engine; cancels name the
+//                       symbol of the order they target
+//
+// Pushing the warm-up flow through the real ring and EventLoop cycles every
+// ring slot (faulting the ring in), and runs the matching code paths on the
+// loop thread so the first timed events find warm caches and predictors.
+// ============================================================================
+
+#include <common/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+/// @brief Write-touches every page in [data, data + bytes) without changing
+/// its contents.  Safe on memory that already holds live objects, provided
+/// no other thread writes it concurrently.
+void prefaultPages( void* data, std::size_t bytes );
+
+/// @brief Locks current and future pages into RAM.
+std::expected<void, std::string> lockAllMemory();
+
+class WarmupFlow
+{
+public:
+    /// Ids at or above this value are reserved for warm-up traffic.
+    static constexpr HFTToolset::OrderId FirstWarmupId = 1'000'000'000;
+
+    WarmupFlow( std::span<const HFTToolset::Symbol> symbols, std::uint64_t events );
+
+    /// @brief Produces the next warm-up event; returns false once the flow,
+    /// including its trailing clean-up cancels, is exhausted.
+    bool next( HFTToolset::EngineEvent& ev );
+
+private:
+    /// @brief Overwrites @p ev with a cancel of the @p issued-th warm-up id.
+    void cancel( HFTToolset::EngineEvent& ev, std::size_t issued ) const;
+
+    std::span<const HFTToolset::Symbol> symbols_;
+    std::uint64_t remaining_;
+    std::mt19937 rng_{ 0x5EED };  // fixed seed: identical warm-up every run
+    std::vector<std::size_t> issued_;  // symbol index of id FirstWarmupId + i
+    std::size_t cleanup_cursor_{ 0 };
+};
+
+}  // namespace MarketMicroStructure
@@ -0,0 +1,263 @@
+// ============================================================================
+// MarketMicrostructureEngine — Block Codec Implementation
+// ============================================================================
+
+#include <block_codec.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+constexpr std::size_t MinMatch     = 4;
+constexpr std::size_t LastLiterals = 5;   // the tail is always stored as literals
+constexpr std::size_t MatchLimit   = 12;  // no match starts closer than this to the end
+constexpr std::size_t MaxOffset    = 0xFFFF;
+constexpr int HashBits             = 12;
+
+std::uint32_t read32( const std::uint8_t* p )
+{
+    std::uint32_t v;
+    std::memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+std::uint64_t read64( const std::uint8_t* p )
+{
+    std::uint64_t v;
+    std::memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+std::uint32_t hash4( std::uint32_t v )
+{
+    return ( v * 2654435761U ) >> ( 32 - HashBits );
+}
+
+/// @brief Length of the common run at @p a and @p b, stopping at @p end.
+std::size_t matchLength( const std::uint8_t* a, const std::uint8_t* b, const std::uint8_t* end )
+{
+    const std::uint8_t* start = b;
+    if constexpr ( std::endian::native == std::endian::little )
+    {
+        while ( b + 8 <= end )
+        {
+            const std::uint64_t diff = read64( a ) ^ read64( b );
+            if ( diff != 0 )
+            {
+                return static_cast<std::size_t>( b - start ) + static_cast<std::size_t>( std::countr_zero( diff ) / 8 );
+            }
+            a += 8;
+            b += 8;
+        }
+    }
+    while ( b < end && *a == *b )
+    {
+        ++a;
+        ++b;
+    }
+    return static_cast<std::size_t>( b - start );
+}
+
+/// @brief Bounds-checked output cursor; once a write would overflow, every
+/// later one is dropped and ok() stays false.
+class Output
+{
+public:
+    Output( std::uint8_t* dst, std::size_t capacity ) : dst_( dst ), capacity_( capacity ) {}
+
+    void byte( std::uint8_t value )
+    {
+        if ( size_ < capacity_ )
+        {
+            dst_[size_++] = value;
+        }
+        else
+        {
+            ok_ = false;
+        }
+    }
+
+    void bytes( const std::uint8_t* src, std::size_t count )
+    {
+        if ( count == 0 )
+        {
+            return;
+        }
+        if ( count <= capacity_ - size_ )
+        {
+            std::memcpy( dst_ + size_, src, count );
+            size_ += count;
+        }
+        else
+        {
+            ok_ = false;
+        }
+    }
+
+    /// @brief The 255-run extension of a length that did not fit its nibble.
+    void length( std::size_t remainder )
+    {
+        for ( ; remainder >= 255; remainder -= 255 )
+        {
+            byte( 255 );
+        }
+        byte( static_cast<std::uint8_t>( remainder ) );
+    }
+
+    bool ok() const { return ok_; }
+    std::size_t size() const { return size_; }
+
+private:
+    std::uint8_t* dst_;
+    std::size_t capacity_;
+    std::size_t size_{ 0 };
+    bool ok_{ true };
+};
+
+void emitSequence( Output& out, const std::uint8_t* literals, std::size_t literal_count, std::size_t offset, std::size_t match )
+{
+    const std::size_t match_code = match - MinMatch;
+    out.byte( static_cast<std::uint8_t>( ( std::min<std::size_t>( literal_count, 15 ) << 4 ) | std::min<std::size_t>( match_code, 15 ) ) );
+    if ( literal_count >= 15 )
+    {
+        out.length( literal_count - 15 );
+    }
+    out.bytes( literals, literal_count );
+    out.byte( static_cast<std::uint8_t>( offset & 0xFF ) );
+    out.byte( static_cast<std::uint8_t>( offset >> 8 ) );
+    if ( match_code >= 15 )
+    {
+        out.length( match_code - 15 );
+    }
+}
+
+void emitLiterals( Output& out, const std::uint8_t* literals, std::size_t literal_count )
+{
+    out.byte( static_cast<std::uint8_t>( std::min<std::size_t>( literal_count, 15 ) << 4 ) );
+    if ( literal_count >= 15 )
+    {
+        out.length( literal_count - 15 );
+    }
+    out.bytes( literals, literal_count );
+}
+
+/// @brief Reads a 255-run length extension; false if it runs off the input.
+bool readLength( const std::uint8_t*& ip, const std::uint8_t* end, std::size_t& length )
+{
+    std::uint8_t b;
+    do
+    {
+        if ( ip == end )
+        {
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while ( b == 255 );
+    return true;
+}
+
+}  // namespace
+
+std::size_t MarketMicroStructure::blockCompress( const std::uint8_t* src, std::size_t size, std::uint8_t* dst, std::size_t capacity )
+{
+    Output out( dst, capacity );
+    std::size_t anchor = 0;
+
+    if ( size > MatchLimit )
+    {
+        std::array<std::uint32_t, std::size_t{ 1 } << HashBits> table{};
+        const std::size_t match_start_limit = size - MatchLimit;
+        const std::uint8_t* match_end       = src + size - LastLiterals;
+
+        std::size_t ip = 0;
+        while ( ip < match_start_limit )
+        {
+            const std::uint32_t h       = hash4( read32( src + ip ) );
+            const std::size_t candidate = table[h];
+            table[h]                    = static_cast<std::uint32_t>( ip );
+            if ( candidate >= ip || ip - candidate > MaxOffset || read32( src + candidate ) != read32( src + ip ) )
+            {
+                ++ip;
+                continue;
+            }
+
+            const std::size_t match = MinMatch + matchLength( src + candidate + MinMatch, src + ip + MinMatch, match_end );
+            emitSequence( out, src + anchor, ip - anchor, ip - candidate, match );
+            ip += match;
+            anchor = ip;
+        }
+    }
+    emitLiterals( out, src + anchor, size - anchor );
+    return out.ok() ? out.size() : 0;
+}
+
+bool MarketMicroStructure::blockDecompress( const std::uint8_t* src, std::size_t size, std::uint8_t* dst, std::size_t raw_size )
+{
+    const std::uint8_t* ip     = src;
+    const std::uint8_t* in_end = src + size;
+    std::size_t op             = 0;
+
+    while ( ip < in_end )
+    {
+        const std::uint8_t token  = *ip++;
+        std::size_t literal_count = token >> 4;
+        if ( literal_count == 15 && !readLength( ip, in_end, literal_count ) )
+        {
+            return false;
+        }
+        if ( literal_count > static_cast<std::size_t>( in_end - ip ) || literal_count > raw_size - op )
+        {
+            return false;
+        }
+        if ( literal_count != 0 )
+        {
+            std::memcpy( dst + op, ip, literal_count );
+        }
+        ip += literal_count;
+        op += literal_count;
+        if ( ip == in_end )
+        {
+            break;  // the literals-only final sequence
+        }
+
+        if ( in_end - ip < 2 )
+        {
+            return false;
+        }
+        const std::size_t offset = static_cast<std::size_t>( ip[0] ) | ( static_cast<std::size_t>( ip[1] ) << 8 );
+        ip += 2;
+        std::size_t match = token & 0x0F;
+        if ( match == 15 && !readLength( ip, in_end, match ) )
+        {
+            return false;
+        }
+        match += MinMatch;
+        if ( offset == 0 || offset > op || match > raw_size - op )
+        {
+            return false;
+        }
+
+        // A match closer than its own length overlaps the bytes it is
+        // producing (a run): copy those byte by byte.
+        const std::uint8_t* from = dst + op - offset;
+        if ( offset >= match )
+        {
+            std::memcpy( dst + op, from, match );
+        }
+        else
+        {
+            for ( std::size_t i = 0; i < match; ++i )
+            {
+                dst[op + i] = from[i];
+            }
+        }
+        op += match;
+    }
+    return op == raw_size;
+}
@@ -0,0 +1,230 @@
+// ============================================================================
+// MarketMicrostructureEngine — Mapped Book File Implementation
+// ============================================================================
+
+#include <book_file.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+constexpr char BookFileMagic[8]         = { 'M', 'M', 'B', 'O', 'O', 'K', '1', '\0' };
+constexpr std::uint32_t BookFileVersion = 2;
+constexpr std::size_t HeaderBytes       = 4096;  // blocks start on the second page
+constexpr unsigned MinBlockShift        = 6;     // 64-byte blocks: every alignment the books use
+constexpr unsigned SizeClasses          = 64;
+
+unsigned sizeClass( std::size_t bytes )
+{
+    return std::max( MinBlockShift, static_cast<unsigned>( std::bit_width( std::max<std::size_t>( bytes, 1 ) - 1 ) ) );
+}
+
+}  // namespace
+
+struct MappedBookFile::Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t layout;
+    std::uint64_t capacity;
+    std::uint64_t used;  ///< Bump offset: everything below is a header or a block
+    std::uint64_t root;
+    std::uint64_t live_blocks;     ///< Bytes in blocks handed out and not freed
+    std::uint64_t live_requested;  ///< Bytes those blocks were asked for
+    std::uint64_t free_lists[SizeClasses];  ///< Offset of the first free block of each size, 0 = none
+};
+
+MappedBookFile::MappedBookFile( std::string path, std::byte* base, std::size_t capacity, bool restored )
+    : path_( std::move( path ) ), base_( base ), capacity_( capacity ), restored_( restored )
+{
+}
+
+MappedBookFile::~MappedBookFile()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    ::munmap( base_, capacity_ );
+#endif
+}
+
+std::expected<std::unique_ptr<MappedBookFile>, std::string> MappedBookFile::open( const std::string& path, std::uint64_t layout, std::size_t capacity )
+{
+    static_assert( sizeof( Header ) <= HeaderBytes );
+#if defined( __unix__ ) || defined( __APPLE__ )
+    const int fd = ::open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+    if ( fd < 0 )
+    {
+        return std::unexpected( "cannot open book file '" + path + "': " + std::strerror( errno ) );
+    }
+    struct stat st{};
+    if ( ::fstat( fd, &st ) != 0 )
+    {
+        const std::string error = std::strerror( errno );
+        ::close( fd );
+        return std::unexpected( "cannot stat book file '" + path + "': " + error );
+    }
+
+    // An existing file is mapped at the size it was created with.
+    const bool restored = st.st_size != 0;
+    if ( restored )
+    {
+        Header header{};
+        if ( static_cast<std::size_t>( st.st_size ) < HeaderBytes || ::pread( fd, &header, sizeof( header ), 0 ) != static_cast<ssize_t>( sizeof( header ) )
+             || std::memcmp( header.magic, BookFileMagic, sizeof( BookFileMagic ) ) != 0 || header.version != BookFileVersion
+             || header.capacity != static_cast<std::uint64_t>( st.st_size ) )
+        {
+            ::close( fd );
+            return std::unexpected( "'" + path + "' is not a book file" );
+        }
+        if ( header.layout != layout )
+        {
+            ::close( fd );
+            return std::unexpected( "'" + path + "' was written by a build with a different book layout" );
+        }
+        capacity = header.capacity;
+    }
+    else
+    {
+        capacity = std::max( capacity, 2 * HeaderBytes );
+        if ( ::ftruncate( fd, static_cast<off_t>( capacity ) ) != 0 )
+        {
+            const std::string error = std::strerror( errno );
+            ::close( fd );
+            return std::unexpected( "cannot size book file '" + path + "': " + error );
+        }
+    }
+
+    void* base = ::mmap( nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if ( base == MAP_FAILED )
+    {
+        return std::unexpected( "cannot map book file '" + path + "': " + std::strerror( errno ) );
+    }
+
+    std::unique_ptr<MappedBookFile> file( new MappedBookFile( path, static_cast<std::byte*>( base ), capacity, restored ) );
+    if ( !restored )
+    {
+        // The magic goes last: a file cut short before it is not a book file.
+        Header& header  = *::new ( base ) Header{};
+        header.version  = BookFileVersion;
+        header.layout   = layout;
+        header.capacity = capacity;
+        header.used     = HeaderBytes;
+        std::memcpy( header.magic, BookFileMagic, sizeof( BookFileMagic ) );
+    }
+    return file;
+#else
+    (void)layout;
+    (void)capacity;
+    return std::unexpected( "mapped book files are not supported on this platform ('" + path + "')" );
+#endif
+}
+
+std::uint64_t MappedBookFile::root() const
+{
+    return header().root;
+}
+
+void MappedBookFile::setRoot( std::uint64_t offset )
+{
+    header().root = offset;
+}
+
+std::size_t MappedBookFile::usedBytes() const
+{
+    return static_cast<std::size_t>( header().used );
+}
+
+std::size_t MappedBookFile::blockBytes( std::size_t bytes )
+{
+    return bytes == 0 ? 0 : std::size_t{ 1 } << sizeClass( bytes );
+}
+
+std::size_t MappedBookFile::tailBytes( std::size_t bytes, std::uint64_t& claimed ) const
+{
+    if ( bytes == 0 )
+    {
+        return 0;
+    }
+    const unsigned size_class = sizeClass( bytes );
+    const std::uint64_t bit   = std::uint64_t{ 1 } << size_class;
+    if ( header().free_lists[size_class] != 0 && ( claimed & bit ) == 0 )
+    {
+        claimed |= bit;
+        return 0;
+    }
+    return std::size_t{ 1 } << size_class;
+}
+
+std::size_t MappedBookFile::liveBlockBytes() const
+{
+    return static_cast<std::size_t>( header().live_blocks );
+}
+
+std::size_t MappedBookFile::liveRequestedBytes() const
+{
+    return static_cast<std::size_t>( header().live_requested );
+}
+
+bool MappedBookFile::flush()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    return ::msync( base_, capacity_, MS_SYNC ) == 0;
+#else
+    return false;
+#endif
+}
+
+void* MappedBookFile::do_allocate( std::size_t bytes, std::size_t alignment )
+{
+    const unsigned size_class = sizeClass( std::max( bytes, alignment ) );
+    Header& header            = this->header();
+    if ( size_class >= SizeClasses || alignment > ( std::size_t{ 1 } << MinBlockShift ) )
+    {
+        throw std::bad_alloc();
+    }
+
+    const std::uint64_t block = std::uint64_t{ 1 } << size_class;
+    if ( const std::uint64_t head = header.free_lists[size_class]; head != 0 )
+    {
+        std::memcpy( &header.free_lists[size_class], base_ + head, sizeof( std::uint64_t ) );
+        header.live_blocks += block;
+        header.live_requested += bytes;
+        return base_ + head;
+    }
+
+    // Blocks are multiples of 64 bytes and start on a 64-byte boundary.
+    if ( block > capacity_ - header.used )
+    {
+        throw std::bad_alloc();
+    }
+    const std::uint64_t offset = header.used;
+    header.used += block;
+    header.live_blocks += block;
+    header.live_requested += bytes;
+    return base_ + offset;
+}
+
+void MappedBookFile::do_deallocate( void* p, std::size_t bytes, std::size_t alignment )
+{
+    const unsigned size_class  = sizeClass( std::max( bytes, alignment ) );
+    Header& header             = this->header();
+    const std::uint64_t offset = static_cast<std::uint64_t>( static_cast<std::byte*>( p ) - base_ );
+    std::memcpy( p, &header.free_lists[size_class], sizeof( std::uint64_t ) );
+    header.free_lists[size_class] = offset;
+    header.live_blocks -= std::uint64_t{ 1 } << size_class;
+    header.live_requested -= bytes;
+}
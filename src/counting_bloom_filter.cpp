@@ -0,0 +1,17 @@
+// ============================================================================
+// MarketMicrostructureEngine — Counting Bloom Filter Implementation
+// ============================================================================
+
+#include <counting_bloom_filter.h>
+
+#include <algorithm>
+#include <bit>
+
+using namespace MarketMicroStructure;
+
+void CountingBloomFilter::reset( std::size_t counters )
+{
+    const std::size_t bytes = bytesFor( counters );
+    counters_.assign( bytes, 0 );
+    block_mask_ = bytes / BlockBytes - 1;
+}
@@ -0,0 +1,509 @@
+// ============================================================================
+// MarketMicrostructureEngine — Hawkes Order Flow Implementation
+//
+// Fitting: at a fixed beta, lambda_u(t) is linear in (mu_u, alpha_u.).  So
+// the log-likelihood splits into one concave problem per target type u:
+//
+//     log L_u = sum_{i of type u} log(theta . x_i) - theta . c
+//
+// Here x_i = (1, R_0(t_i), ..., R_{D-1}(t_i)) holds the running kernel sums
+// just before event i, and c = (T, G_0, ..., G_{D-1}).  G_j is the kernel
+// mass that type-j events put inside [0, T].  A single recursive pass
+// builds both.  Each row is solved by projected Newton on theta >= 0.
+// beta is chosen by a coarse grid followed by a golden-section search on
+// log(beta).
+// ============================================================================
+
+#include <hawkes_flow.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+constexpr std::size_t Dims           = HawkesParams::Dims;
+constexpr std::size_t Coefficients   = Dims + 1;  // mu_u, alpha_u0 .. alpha_u(Dims-1)
+constexpr std::size_t MinFitEvents   = 32;
+constexpr std::size_t NewtonSteps    = 50;
+constexpr std::size_t BetaRefinement = 16;       // golden-section steps after the coarse grid
+constexpr double MaxBranchingRatio   = 0.95;     // fits above this are scaled back to stay stationary
+constexpr std::array<double, 9> Betas = { 10.0, 30.0, 100.0, 300.0, 1e3, 3e3, 1e4, 3e4, 1e5 };
+
+using Vector = std::array<double, Coefficients>;
+using Matrix = std::array<Vector, Coefficients>;
+
+struct TypedTime
+{
+    double time;  // seconds from the first event
+    std::size_t kind;
+};
+
+/// @brief Everything the likelihood of target type u needs at one beta:
+/// x_i = (1, R_0(t_i), ..., R_{Dims-1}(t_i)) for each type-u event, and the
+/// exposure c = (T, G_0, ..., G_{Dims-1}).
+struct RowProblem
+{
+    std::vector<Vector> features;
+    Vector exposure{};
+};
+
+/// @brief log L_u(theta) = sum_i log(theta . x_i) - theta . c; -inf outside
+/// the domain.
+double rowLikelihood( const RowProblem& row, const Vector& theta )
+{
+    double value = 0.0;
+    for ( const Vector& x : row.features )
+    {
+        double lambda = 0.0;
+        for ( std::size_t k = 0; k < Coefficients; ++k )
+        {
+            lambda += theta[k] * x[k];
+        }
+        if ( lambda <= 0.0 )
+        {
+            return -std::numeric_limits<double>::infinity();
+        }
+        value += std::log( lambda );
+    }
+    for ( std::size_t k = 0; k < Coefficients; ++k )
+    {
+        value -= theta[k] * row.exposure[k];
+    }
+    return value;
+}
+
+/// @brief Solves m * d = g over the coordinates in @p free (the rest of d
+/// is zero) by Gaussian elimination with partial pivoting.
+Vector solveFree( Matrix m, Vector g, const std::array<bool, Coefficients>& free )
+{
+    std::array<std::size_t, Coefficients> index{};
+    std::size_t n = 0;
+    for ( std::size_t k = 0; k < Coefficients; ++k )
+    {
+        if ( free[k] )
+        {
+            index[n++] = k;
+        }
+    }
+
+    Matrix a{};
+    Vector b{};
+    for ( std::size_t r = 0; r < n; ++r )
+    {
+        for ( std::size_t c = 0; c < n; ++c )
+        {
+            a[r][c] = m[index[r]][index[c]];
+        }
+        b[r] = g[index[r]];
+    }
+
+    for ( std::size_t col = 0; col < n; ++col )
+    {
+        std::size_t pivot = col;
+        for ( std::size_t r = col + 1; r < n; ++r )
+        {
+            if ( std::abs( a[r][col] ) > std::abs( a[pivot][col] ) )
+            {
+                pivot = r;
+            }
+        }
+        std::swap( a[col], a[pivot] );
+        std::swap( b[col], b[pivot] );
+        if ( a[col][col] == 0.0 )
+        {
+            return {};
+        }
+        for ( std::size_t r = col + 1; r < n; ++r )
+        {
+            const double f = a[r][col] / a[col][col];
+            for ( std::size_t c = col; c < n; ++c )
+            {
+                a[r][c] -= f * a[col][c];
+            }
+            b[r] -= f * b[col];
+        }
+    }
+
+    Vector d{};
+    for ( std::size_t r = n; r-- > 0; )
+    {
+        double sum = b[r];
+        for ( std::size_t c = r + 1; c < n; ++c )
+        {
+            sum -= a[r][c] * d[index[c]];
+        }
+        d[index[r]] = sum / a[r][r];
+    }
+    return d;
+}
+
+/// @brief Maximizes log L_u over theta >= 0 by projected Newton.  The
+/// problem is concave (log of a linear function minus a linear term), so
+/// this converges to the row's global optimum.
+double fitRow( const RowProblem& row, Vector& theta )
+{
+    double value = rowLikelihood( row, theta );
+    for ( std::size_t step = 0; step < NewtonSteps; ++step )
+    {
+        // Gradient sum x_i / lambda_i - c; curvature sum x_i x_i^T / lambda_i^2.
+        Vector g{};
+        Matrix m{};
+        for ( const Vector& x : row.features )
+        {
+            double lambda = 0.0;
+            for ( std::size_t k = 0; k < Coefficients; ++k )
+            {
+                lambda += theta[k] * x[k];
+            }
+            const double inv = 1.0 / lambda;
+            for ( std::size_t r = 0; r < Coefficients; ++r )
+            {
+                g[r] += x[r] * inv;
+                for ( std::size_t c = 0; c <= r; ++c )
+                {
+                    m[r][c] += x[r] * x[c] * inv * inv;
+                }
+            }
+        }
+
+        // Coefficients pinned at zero by a gradient pointing below zero, or
+        // with no data behind them, stay out of the step.
+        std::array<bool, Coefficients> free{};
+        for ( std::size_t r = 0; r < Coefficients; ++r )
+        {
+            g[r] -= row.exposure[r];
+            for ( std::size_t c = 0; c < r; ++c )
+            {
+                m[c][r] = m[r][c];
+            }
+            free[r] = m[r][r] > 0.0 && ( theta[r] > 0.0 || g[r] > 0.0 );
+        }
+        const Vector d = solveFree( m, g, free );
+
+        // Backtrack until the projected step improves the likelihood.
+        bool improved = false;
+        for ( double scale = 1.0; scale > 1e-10 && !improved; scale *= 0.5 )
+        {
+            Vector next;
+            for ( std::size_t k = 0; k < Coefficients; ++k )
+            {
+                next[k] = std::max( theta[k] + scale * d[k], 0.0 );
+            }
+            const double next_value = rowLikelihood( row, next );
+            if ( next_value > value )
+            {
+                improved = next_value - value > 1e-10 * std::abs( value );
+                theta    = next;
+                value    = next_value;
+                if ( !improved )
+                {
+                    return value;  // converged
+                }
+            }
+        }
+        if ( !improved )
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+/// @brief Maximum-likelihood mu and alpha at a fixed beta; returns the
+/// total log-likelihood.
+double fitAtBeta( std::span<const TypedTime> events, double horizon, const std::array<std::size_t, Dims>& counts, double beta,
+                  HawkesParams& p )
+{
+    std::array<RowProblem, Dims> rows;
+    for ( std::size_t u = 0; u < Dims; ++u )
+    {
+        rows[u].features.reserve( counts[u] );
+        rows[u].exposure[0] = horizon;
+    }
+
+    std::array<double, Dims> kernel{};  // R_j, decayed to the current event
+    double last = 0.0;
+    for ( const auto& [time, u] : events )
+    {
+        const double decay = std::exp( -beta * ( time - last ) );
+        last               = time;
+        Vector x;
+        x[0] = 1.0;
+        for ( std::size_t j = 0; j < Dims; ++j )
+        {
+            kernel[j] *= decay;
+            x[j + 1] = kernel[j];
+        }
+        rows[u].features.push_back( x );
+        kernel[u] += beta;
+    }
+    for ( const auto& [time, j] : events )
+    {
+        const double mass = 1.0 - std::exp( -beta * ( horizon - time ) );
+        for ( auto& row : rows )
+        {
+            row.exposure[j + 1] += mass;
+        }
+    }
+
+    p.beta                = beta;
+    double log_likelihood = 0.0;
+    for ( std::size_t u = 0; u < Dims; ++u )
+    {
+        Vector theta{};
+        if ( counts[u] > 0 )
+        {
+            theta[0] = 0.5 * static_cast<double>( counts[u] ) / horizon;
+            for ( std::size_t j = 0; j < Dims; ++j )
+            {
+                theta[j + 1] = 0.1;
+            }
+            log_likelihood += fitRow( rows[u], theta );
+        }
+        p.mu[u] = theta[0];
+        for ( std::size_t j = 0; j < Dims; ++j )
+        {
+            p.alpha[u][j] = theta[j + 1];
+        }
+    }
+    return log_likelihood;
+}
+
+}  // namespace
+
+double HawkesParams::branchingRatio() const
+{
+    // Power iteration; alpha is non-negative, so this converges to the
+    // Perron root.
+    std::array<double, Dims> v;
+    v.fill( 1.0 );
+    double ratio = 0.0;
+    for ( int iter = 0; iter < 100; ++iter )
+    {
+        std::array<double, Dims> w{};
+        for ( std::size_t i = 0; i < Dims; ++i )
+        {
+            for ( std::size_t j = 0; j < Dims; ++j )
+            {
+                w[i] += alpha[i][j] * v[j];
+            }
+        }
+        const double norm = *std::max_element( w.begin(), w.end() );
+        if ( norm <= 0.0 )
+        {
+            return 0.0;
+        }
+        for ( std::size_t i = 0; i < Dims; ++i )
+        {
+            v[i] = w[i] / norm;
+        }
+        ratio = norm;
+    }
+    return ratio;
+}
+
+std::expected<HawkesFit, std::string> MarketMicroStructure::fitHawkes( const Scenario& scenario )
+{
+    if ( scenario.events.size() < MinFitEvents || scenario.duration() == 0 )
+    {
+        return std::unexpected( std::string( "scenario too short to fit a Hawkes model (need at least " )
+                                + std::to_string( MinFitEvents ) + " events over a non-zero time span)" );
+    }
+
+    const Timestamp origin = scenario.events.front().time;
+    std::vector<TypedTime> events;
+    events.reserve( scenario.events.size() );
+    std::array<std::size_t, Dims> counts{};
+    for ( const auto& ev : scenario.events )
+    {
+        const auto kind = static_cast<std::size_t>( ev.kind );
+        events.push_back( { static_cast<double>( ev.time - origin ) * 1e-9, kind } );
+        ++counts[kind];
+    }
+    const double horizon = events.back().time;
+
+    HawkesFit best;
+    best.events         = events.size();
+    best.log_likelihood = -std::numeric_limits<double>::infinity();
+
+    const auto evaluate = [&]( double beta )
+    {
+        HawkesParams p;
+        const double log_likelihood = fitAtBeta( events, horizon, counts, beta, p );
+        if ( log_likelihood > best.log_likelihood )
+        {
+            best.params         = p;
+            best.log_likelihood = log_likelihood;
+        }
+        return log_likelihood;
+    };
+
+    // Coarse grid, then golden-section search in log(beta) between the
+    // best grid point's neighbours.
+    std::size_t best_grid = 0;
+    for ( std::size_t i = 0; i < Betas.size(); ++i )
+    {
+        const double before = best.log_likelihood;
+        evaluate( Betas[i] );
+        best_grid = best.log_likelihood > before ? i : best_grid;
+    }
+
+    constexpr double InvPhi = 0.6180339887498949;
+    double lo               = std::log( Betas[best_grid == 0 ? 0 : best_grid - 1] );
+    double hi               = std::log( Betas[std::min( best_grid + 1, Betas.size() - 1 )] );
+    double x1               = hi - InvPhi * ( hi - lo );
+    double x2               = lo + InvPhi * ( hi - lo );
+    double f1               = evaluate( std::exp( x1 ) );
+    double f2               = evaluate( std::exp( x2 ) );
+    for ( std::size_t step = 0; step < BetaRefinement; ++step )
+    {
+        if ( f1 < f2 )
+        {
+            lo = x1;
+            x1 = x2;
+            f1 = f2;
+            x2 = lo + InvPhi * ( hi - lo );
+            f2 = evaluate( std::exp( x2 ) );
+        }
+        else
+        {
+            hi = x2;
+            x2 = x1;
+            f2 = f1;
+            x1 = hi - InvPhi * ( hi - lo );
+            f1 = evaluate( std::exp( x1 ) );
+        }
+    }
+
+    if ( const double ratio = best.params.branchingRatio(); ratio > MaxBranchingRatio )
+    {
+        for ( auto& row : best.params.alpha )
+        {
+            for ( auto& a : row )
+            {
+                a *= MaxBranchingRatio / ratio;
+            }
+        }
+    }
+    return best;
+}
+
+HawkesFlow::HawkesFlow( std::span<const Symbol> symbols, const HawkesParams& params, std::uint64_t seed, std::uint64_t stream )
+    : symbols_( symbols ), params_( params ), rng_( seed, stream )
+{
+    assert( !symbols_.empty() );
+    assert( params_.branchingRatio() < 1.0 );
+    live_.reserve( MaxLiveIds );
+}
+
+double HawkesFlow::intensity( std::size_t kind ) const
+{
+    double lambda = params_.mu[kind];
+    for ( std::size_t j = 0; j < HawkesParams::Dims; ++j )
+    {
+        lambda += params_.alpha[kind][j] * excitation_[j];
+    }
+    return lambda;
+}
+
+void HawkesFlow::advance( double dt )
+{
+    const double decay = std::exp( -params_.beta * dt );
+    for ( auto& e : excitation_ )
+    {
+        e *= decay;
+    }
+    time_ += dt;
+}
+
+ScenarioEventKind HawkesFlow::nextKind()
+{
+    // Between events every intensity only decays, so the total at the
+    // current time bounds it until the next event.
+    while ( true )
+    {
+        double bound = 0.0;
+        for ( std::size_t i = 0; i < HawkesParams::Dims; ++i )
+        {
+            bound += intensity( i );
+        }
+        advance( -std::log( rng_.unit() ) / bound );
+
+        double pick = rng_.unit() * bound;
+        for ( std::size_t i = 0; i < HawkesParams::Dims; ++i )
+        {
+            pick -= intensity( i );
+            if ( pick <= 0.0 )
+            {
+                excitation_[i] += params_.beta;
+                return static_cast<ScenarioEventKind>( i );
+            }
+        }
+        // Rejected: the intensity decayed below the bound.
+    }
+}
+
+void HawkesFlow::next( EngineEvent& ev )
+{
+    const ScenarioEventKind kind = nextKind();
+
+    ev = EngineEvent{};
+    if ( kind == ScenarioEventKind::Cancel )
+    {
+        ev.type = EventType::CancelOrder;
+        if ( live_.empty() )
+        {
+            ev.cancel.order_id = next_id_;  // nothing live: a harmless reject
+            return;
+        }
+        const std::uint32_t slot = rng_.below( static_cast<std::uint32_t>( live_.size() ) );
+        ev.cancel.order_id       = live_[slot].id;
+        ev.cancel.symbol         = symbols_[live_[slot].symbol];
+        live_[slot]              = live_.back();
+        live_.pop_back();
+        return;
+    }
+
+    // Trades are market orders with no price; adds rest passively.
+    const Side side            = rng_.below( 2 ) == 0 ? Side::Buy : Side::Sell;
+    const bool trade           = kind == ScenarioEventKind::Trade;
+    const Price price          = trade ? 0 : MidPrice + ( side == Side::Buy ? -1 : 1 ) * static_cast<Price>( 1 + rng_.below( PassiveTicks ) );
+    const std::uint32_t symbol = rng_.below( static_cast<std::uint32_t>( symbols_.size() ) );
+
+    ev.type  = EventType::NewOrder;
+    ev.order = Order{ .id             = next_id_,
+                      .trader_id      = 1 + rng_.below( static_cast<std::uint32_t>( RandomFlow::MaxId ) ),
+                      .symbol         = symbols_[symbol],
+                      .side           = side,
+                      .type           = trade ? OrderType::Market : OrderType::Limit,
+                      .tif            = trade ? TimeInForce::IOC : TimeInForce::Day,
+                      .price          = price,
+                      .quantity       = static_cast<Quantity>( RandomFlow::MinQty + rng_.below( RandomFlow::MaxQty - RandomFlow::MinQty + 1 ) ),
+                      .filled_qty     = 0,
+                      .status         = OrderStatus::New,
+                      .submit_time    = 0,
+                      .accept_time    = 0,
+                      .queue_position = 0,
+                      .cl_ord_id      = {} };
+
+    // A trade never rests, so only adds are cancel candidates.
+    if ( trade )
+    {
+        ++next_id_;
+        return;
+    }
+    if ( live_.size() == MaxLiveIds )
+    {
+        live_[rng_.below( MaxLiveIds )] = { next_id_, symbol };
+    }
+    else
+    {
+        live_.push_back( { next_id_, symbol } );
+    }
+    ++next_id_;
+}
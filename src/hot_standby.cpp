@@ -0,0 +1,457 @@
+// ============================================================================
+// MarketMicrostructureEngine — Hot Standby Replica Implementation
+// ============================================================================
+
+#include <hot_standby.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace MarketMicroStructure
+{
+struct ReplicationHeader
+{
+    std::atomic<std::uint64_t> magic;  // stored last by the creator: the header is complete once it matches
+    std::uint32_t version;
+    std::uint32_t slot_size;
+    std::uint64_t capacity;
+
+    // Written by the primary.
+    alignas( 64 ) std::atomic<std::uint64_t> published;
+    std::atomic<std::uint64_t> primary_heartbeat;
+    std::atomic<std::uint32_t> closed;
+
+    // Written by the standby.
+    alignas( 64 ) std::atomic<std::uint64_t> applied;
+    std::atomic<std::uint64_t> standby_heartbeat;
+    std::atomic<std::uint32_t> attached;
+};
+
+}  // namespace MarketMicroStructure
+
+namespace
+{
+constexpr std::uint64_t ReplicationMagic   = 0x31'4C'50'45'52'4D'4D'4DULL;  // "MMMREPL1"
+constexpr std::uint32_t ReplicationVersion = 1;
+constexpr std::uint64_t MinCapacity        = 1024;
+constexpr std::uint64_t HeartbeatEvery     = 1024;  // standby: applied events between stamps
+constexpr auto HeartbeatInterval           = std::chrono::milliseconds( 1 );
+
+static_assert( std::atomic<std::uint64_t>::is_always_lock_free, "segment counters must be lock-free to be shared across processes" );
+static_assert( std::is_trivially_copyable_v<SequencedEvent>, "events are copied through shared memory" );
+static_assert( sizeof( ReplicationHeader ) % alignof( SequencedEvent ) == 0 );
+
+std::uint64_t monotonicNs()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+std::uint64_t nanos( std::chrono::milliseconds ms )
+{
+    return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( ms ).count() );
+}
+
+std::size_t segmentBytes( std::uint64_t capacity )
+{
+    return sizeof( ReplicationHeader ) + static_cast<std::size_t>( capacity ) * sizeof( SequencedEvent );
+}
+
+/// @brief shm_open names are a single path component with a leading slash.
+std::string shmName( const std::string& name )
+{
+    return name.starts_with( '/' ) ? name : "/" + name;
+}
+
+void apply( SimMatchingEngine& engine, const EngineEvent& ev )
+{
+    if ( ev.type == EventType::NewOrder )
+    {
+        engine.process_new_order( ev.order );
+    }
+    else
+    {
+        engine.process_cancel( ev.cancel );
+    }
+}
+
+}  // namespace
+
+ReplicationSegment::ReplicationSegment( std::string name, void* base, std::size_t bytes, bool owner )
+    : name_( std::move( name ) ), header_( static_cast<ReplicationHeader*>( base ) ), bytes_( bytes ), owner_( owner )
+{
+}
+
+ReplicationSegment::ReplicationSegment( ReplicationSegment&& other ) noexcept
+    : name_( std::move( other.name_ ) ), header_( std::exchange( other.header_, nullptr ) ), bytes_( other.bytes_ ), owner_( other.owner_ )
+{
+}
+
+ReplicationSegment& ReplicationSegment::operator=( ReplicationSegment&& other ) noexcept
+{
+    // other unmaps what this held.
+    std::swap( name_, other.name_ );
+    std::swap( header_, other.header_ );
+    std::swap( bytes_, other.bytes_ );
+    std::swap( owner_, other.owner_ );
+    return *this;
+}
+
+ReplicationSegment::~ReplicationSegment()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    if ( header_ != nullptr )
+    {
+        ::munmap( header_, bytes_ );
+        if ( owner_ )
+        {
+            ::shm_unlink( name_.c_str() );
+        }
+    }
+#endif
+}
+
+void ReplicationSegment::unlink()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    ::shm_unlink( name_.c_str() );
+#endif
+    owner_ = false;
+}
+
+SequencedEvent& ReplicationSegment::slot( std::uint64_t sequence ) const
+{
+    auto* slots = reinterpret_cast<SequencedEvent*>( reinterpret_cast<char*>( header_ ) + sizeof( ReplicationHeader ) );
+    return slots[sequence & ( header_->capacity - 1 )];
+}
+
+std::expected<ReplicationSegment, std::string> ReplicationSegment::create( const std::string& name, std::uint64_t capacity )
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    const std::string path  = shmName( name );
+    capacity                = std::bit_ceil( std::max( capacity, MinCapacity ) );
+    const std::size_t bytes = segmentBytes( capacity );
+
+    // A segment left behind by a crashed run would hand its stale counters
+    // to the new standby.
+    ::shm_unlink( path.c_str() );
+    const int fd = ::shm_open( path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if ( fd < 0 )
+    {
+        return std::unexpected( "cannot create shared memory '" + path + "': " + std::strerror( errno ) );
+    }
+    if ( ::ftruncate( fd, static_cast<off_t>( bytes ) ) != 0 )
+    {
+        const std::string error = std::strerror( errno );
+        ::close( fd );
+        ::shm_unlink( path.c_str() );
+        return std::unexpected( "cannot size shared memory '" + path + "': " + error );
+    }
+    void* base = ::mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if ( base == MAP_FAILED )
+    {
+        ::shm_unlink( path.c_str() );
+        return std::unexpected( "cannot map shared memory '" + path + "': " + std::strerror( errno ) );
+    }
+
+    auto* header      = ::new ( base ) ReplicationHeader{};
+    header->version   = ReplicationVersion;
+    header->slot_size = sizeof( SequencedEvent );
+    header->capacity  = capacity;
+    header->primary_heartbeat.store( monotonicNs(), std::memory_order_relaxed );
+    header->magic.store( ReplicationMagic, std::memory_order_release );
+    return ReplicationSegment( path, base, bytes, true );
+#else
+    (void)capacity;
+    return std::unexpected( "shared memory replication is not supported on this platform ('" + name + "')" );
+#endif
+}
+
+std::expected<ReplicationSegment, std::string> ReplicationSegment::attach( const std::string& name, std::chrono::milliseconds timeout )
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    const std::string path = shmName( name );
+    const auto deadline    = std::chrono::steady_clock::now() + timeout;
+
+    // The primary may not have created (or sized) the segment yet.
+    for ( ;; std::this_thread::sleep_for( HeartbeatInterval ) )
+    {
+        if ( std::chrono::steady_clock::now() > deadline )
+        {
+            return std::unexpected( "no primary published '" + path + "' within " + std::to_string( timeout.count() ) + " ms" );
+        }
+        const int fd = ::shm_open( path.c_str(), O_RDWR, 0 );
+        if ( fd < 0 )
+        {
+            if ( errno == ENOENT )
+            {
+                continue;
+            }
+            return std::unexpected( "cannot open shared memory '" + path + "': " + std::strerror( errno ) );
+        }
+
+        struct stat st{};
+        const bool sized = ::fstat( fd, &st ) == 0 && static_cast<std::size_t>( st.st_size ) >= segmentBytes( MinCapacity );
+        void* base       = sized ? ::mmap( nullptr, static_cast<std::size_t>( st.st_size ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) : MAP_FAILED;
+        ::close( fd );
+        if ( base == MAP_FAILED )
+        {
+            continue;
+        }
+
+        ReplicationSegment segment( path, base, static_cast<std::size_t>( st.st_size ), false );
+        const auto& header = segment.header();
+        if ( header.magic.load( std::memory_order_acquire ) != ReplicationMagic )
+        {
+            continue;  // still being initialised
+        }
+        if ( header.version != ReplicationVersion || header.slot_size != sizeof( SequencedEvent )
+             || segment.bytes_ != segmentBytes( header.capacity ) )
+        {
+            return std::unexpected( "'" + path + "' has an incompatible layout (built from different sources?)" );
+        }
+        return segment;
+    }
+#else
+    (void)timeout;
+    return std::unexpected( "shared memory replication is not supported on this platform ('" + name + "')" );
+#endif
+}
+
+ReplicaPublisher::ReplicaPublisher( ReplicationSegment segment, const ReplicationConfig& config )
+    : segment_( std::move( segment ) ), config_( config )
+{
+    heartbeat_ = std::jthread(
+        [header = &segment_.header()]( std::stop_token stop )
+        {
+            while ( !stop.stop_requested() )
+            {
+                header->primary_heartbeat.store( monotonicNs(), std::memory_order_release );
+                std::this_thread::sleep_for( HeartbeatInterval );
+            }
+        } );
+}
+
+std::expected<ReplicaPublisher, std::string> ReplicaPublisher::open( const std::string& name, const ReplicationConfig& config )
+{
+    auto segment = ReplicationSegment::create( name, config.max_lag );
+    if ( !segment )
+    {
+        return std::unexpected( segment.error() );
+    }
+
+    // Heartbeats start now, so a standby that attaches late does not find
+    // a stale one and take over at once.
+    ReplicaPublisher publisher( std::move( *segment ), config );
+    const auto deadline = std::chrono::steady_clock::now() + config.attach_timeout;
+    while ( publisher.segment_.header().attached.load( std::memory_order_acquire ) == 0 )
+    {
+        if ( std::chrono::steady_clock::now() > deadline )
+        {
+            return std::unexpected( "no standby attached to '" + name + "' within " + std::to_string( config.attach_timeout.count() ) + " ms" );
+        }
+        std::this_thread::sleep_for( HeartbeatInterval );
+    }
+    return publisher;
+}
+
+void ReplicaPublisher::publish( const EngineEvent& ev )
+{
+    if ( lost_ )
+    {
+        return;
+    }
+
+    ReplicationHeader& header = segment_.header();
+    if ( published_ - header.applied.load( std::memory_order_acquire ) >= config_.max_lag )
+    {
+        ++stalls_;
+        while ( published_ - header.applied.load( std::memory_order_acquire ) >= config_.max_lag )
+        {
+            if ( monotonicNs() - header.standby_heartbeat.load( std::memory_order_acquire ) > nanos( config_.takeover_timeout ) )
+            {
+                // The primary keeps trading without a standby rather than
+                // stall behind a dead one.
+                lost_ = true;
+                return;
+            }
+            // Already stalled: give a standby sharing this core its turn.
+            std::this_thread::yield();
+        }
+    }
+
+    SequencedEvent& slot = segment_.slot( published_ );
+    slot.sequence        = published_;
+    slot.event           = ev;
+    header.published.store( ++published_, std::memory_order_release );
+}
+
+void ReplicaPublisher::close()
+{
+    segment_.header().closed.store( 1, std::memory_order_release );
+}
+
+HotStandby::HotStandby( ReplicationSegment segment, SimMatchingEngine& engine, const ReplicationConfig& config )
+    : segment_( std::move( segment ) ), engine_( engine ), config_( config )
+{
+}
+
+std::expected<StandbyResult, std::string> HotStandby::run()
+{
+    ReplicationHeader& header = segment_.header();
+    StandbyResult result;
+    std::uint64_t applied = header.applied.load( std::memory_order_relaxed );
+
+    // Applies everything published so far; false on a sequence gap.
+    const auto catchUp = [&]( std::uint64_t published )
+    {
+        result.max_lag = std::max( result.max_lag, published - applied );
+        while ( applied < published )
+        {
+            const SequencedEvent& slot = segment_.slot( applied );
+            if ( slot.sequence != applied )
+            {
+                return false;
+            }
+            apply( engine_, slot.event );
+            header.applied.store( ++applied, std::memory_order_release );
+            if ( applied % HeartbeatEvery == 0 )
+            {
+                header.standby_heartbeat.store( monotonicNs(), std::memory_order_release );
+            }
+        }
+        return true;
+    };
+    const auto gap = [&]
+    {
+        return std::unexpected( "replication stream gap: expected sequence " + std::to_string( applied ) + ", found "
+                                + std::to_string( segment_.slot( applied ).sequence ) );
+    };
+
+    // The engine is already set up: announce readiness.
+    header.standby_heartbeat.store( monotonicNs(), std::memory_order_release );
+    header.attached.store( 1, std::memory_order_release );
+
+    for ( ;; )
+    {
+        const std::uint64_t published = header.published.load( std::memory_order_acquire );
+        if ( applied < published )
+        {
+            if ( !catchUp( published ) )
+            {
+                return gap();
+            }
+            continue;
+        }
+
+        // The final publish happens before close(): re-read after seeing it.
+        if ( header.closed.load( std::memory_order_acquire ) != 0 )
+        {
+            if ( header.published.load( std::memory_order_acquire ) == applied )
+            {
+                result.outcome = StandbyOutcome::PrimaryClosed;
+                result.applied = applied;
+                return result;
+            }
+            continue;
+        }
+
+        const std::uint64_t now       = monotonicNs();
+        const std::uint64_t heartbeat = header.primary_heartbeat.load( std::memory_order_acquire );
+        header.standby_heartbeat.store( now, std::memory_order_release );
+        if ( now > heartbeat && now - heartbeat > nanos( config_.takeover_timeout ) )
+        {
+            // Whatever the primary published before it died is in the ring.
+            if ( !catchUp( header.published.load( std::memory_order_acquire ) ) )
+            {
+                return gap();
+            }
+            result.outcome          = StandbyOutcome::Takeover;
+            result.applied          = applied;
+            result.heartbeat_age_ns = now - heartbeat;
+            result.takeover_ns      = monotonicNs() - now;
+
+            // A killed primary could not remove its segment.
+            segment_.unlink();
+            return result;
+        }
+    }
+}
+
+std::uint64_t MarketMicroStructure::bookDigest( const SimMatchingEngine& engine, std::span<const std::string_view> symbols )
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    const auto mix     = [&hash]( std::uint64_t value )
+    {
+        for ( int b = 0; b < 8; ++b, value >>= 8 )
+        {
+            hash = ( hash ^ ( value & 0xff ) ) * 0x100000001b3ULL;
+        }
+    };
+
+    for ( const std::string_view name : symbols )
+    {
+        const Symbol symbol( std::string( name ).c_str() );
+        const auto index = engine.findSymbol( symbol );
+        if ( !index )
+        {
+            continue;
+        }
+        const SimOrderBook& book = engine.book( *index );
+        const auto orders        = book.exportOrders( symbol );
+        mix( *index );
+        mix( orders.size() );
+        for ( const Order& order : orders )
+        {
+            mix( order.id );
+            mix( static_cast<std::uint64_t>( order.side ) );
+            mix( static_cast<std::uint64_t>( order.price ) );
+            mix( static_cast<std::uint64_t>( order.quantity ) );
+            mix( static_cast<std::uint64_t>( order.filled_qty ) );
+        }
+
+        const MarketDataState& md = book.marketData();
+        mix( static_cast<std::uint64_t>( md.best_bid ) );
+        mix( static_cast<std::uint64_t>( md.best_bid_qty ) );
+        mix( static_cast<std::uint64_t>( md.best_ask ) );
+        mix( static_cast<std::uint64_t>( md.best_ask_qty ) );
+        mix( static_cast<std::uint64_t>( md.last_trade_price ) );
+        mix( static_cast<std::uint64_t>( md.last_trade_qty ) );
+        mix( static_cast<std::uint64_t>( md.traded_volume ) );
+        mix( md.trade_count );
+    }
+
+    const EngineStats& stats = engine.stats();
+    mix( stats.accepted );
+    mix( stats.rejected );
+    mix( stats.cancelled );
+    mix( stats.cancel_rejects );
+    return hash;
+}
+
+void MarketMicroStructure::printStandby( std::ostream& out, const StandbyResult& result, std::uint64_t digest )
+{
+    out << "[Standby] outcome=" << ( result.outcome == StandbyOutcome::Takeover ? "takeover" : "primary_closed" ) << " applied=" << result.applied
+        << " max_lag=" << result.max_lag;
+    if ( result.outcome == StandbyOutcome::Takeover )
+    {
+        out << " heartbeat_age_us=" << result.heartbeat_age_ns / 1000 << " takeover_us=" << result.takeover_ns / 1000;
+    }
+    out << " digest=" << std::hex << digest << std::dec << "\n";
+}
@@ -0,0 +1,148 @@
+// ============================================================================
+// MarketMicrostructureEngine — Host Jitter Detector Implementation
+//
+// The measurement loop is deliberately minimal: read the TSC, compare with
+// the previous read, and only touch the histogram when the delta crosses the
+// threshold.  Converting ticks to nanoseconds happens once per gap, never per
+// iteration, so the loop cost stays in the low tens of cycles.
+// ============================================================================
+
+#include <jitter_detector.h>
+#include <thread_affinity.h>
+
+#include <bit>
+#include <iomanip>
+#include <thread>
+
+using namespace MarketMicroStructure;
+
+void JitterHistogram::record( std::uint64_t gap_ns )
+{
+    std::size_t bucket = gap_ns ? static_cast<std::size_t>( std::bit_width( gap_ns ) - 1 ) : 0;
+    if ( bucket >= Buckets )
+    {
+        bucket = Buckets - 1;
+    }
+    ++counts[bucket];
+}
+
+std::uint64_t JitterHistogram::total() const
+{
+    std::uint64_t sum = 0;
+    for ( auto c : counts )
+    {
+        sum += c;
+    }
+    return sum;
+}
+
+std::uint64_t JitterHistogram::quantileUpperBound( double q ) const
+{
+    const std::uint64_t n = total();
+    if ( n == 0 )
+    {
+        return 0;
+    }
+    const auto target  = static_cast<std::uint64_t>( q * static_cast<double>( n - 1 ) ) + 1;
+    std::uint64_t seen = 0;
+    for ( std::size_t i = 0; i < Buckets; ++i )
+    {
+        seen += counts[i];
+        if ( seen >= target )
+        {
+            return std::uint64_t{ 1 } << ( i + 1 );
+        }
+    }
+    return std::uint64_t{ 1 } << Buckets;
+}
+
+JitterDetector::JitterDetector( Config config, const TscClock& clock ) : config_( config ), clock_( clock ) {}
+
+JitterReport JitterDetector::measure( int core ) const
+{
+    JitterReport report;
+    report.core   = core;
+    report.pinned = pinCurrentThreadToCore( core );
+
+    const double ticks_per_ns   = clock_.ticksPerNs();
+    const auto threshold_ticks  = static_cast<std::uint64_t>( static_cast<double>( config_.gap_threshold.count() ) * ticks_per_ns );
+    const auto duration_ticks   = static_cast<std::uint64_t>( static_cast<double>( config_.duration.count() ) * ticks_per_ns );
+    std::uint64_t stolen_ticks  = 0;
+    std::uint64_t max_gap_ticks = 0;
+    std::uint64_t iterations    = 0;
+
+    const std::uint64_t start = clock_.ticks();
+    const std::uint64_t end   = start + duration_ticks;
+    std::uint64_t prev        = start;
+
+    while ( prev < end )
+    {
+        const std::uint64_t now = clock_.ticks();
+        const std::uint64_t gap = now - prev;
+        ++iterations;
+        if ( gap > threshold_ticks )
+        {
+            stolen_ticks += gap;
+            if ( gap > max_gap_ticks )
+            {
+                max_gap_ticks = gap;
+            }
+            report.gaps.record( static_cast<std::uint64_t>( static_cast<double>( gap ) / ticks_per_ns ) );
+        }
+        prev = now;
+    }
+
+    report.wall_ns    = static_cast<std::uint64_t>( static_cast<double>( prev - start ) / ticks_per_ns );
+    report.stolen_ns  = static_cast<std::uint64_t>( static_cast<double>( stolen_ticks ) / ticks_per_ns );
+    report.max_gap_ns = static_cast<std::uint64_t>( static_cast<double>( max_gap_ticks ) / ticks_per_ns );
+    report.iterations = iterations;
+    return report;
+}
+
+std::vector<JitterReport> JitterDetector::measureConcurrently( std::span<const int> cores ) const
+{
+    std::vector<JitterReport> reports( cores.size() );
+    std::vector<std::thread> workers;
+    workers.reserve( cores.size() );
+    for ( std::size_t i = 0; i < cores.size(); ++i )
+    {
+        workers.emplace_back( [this, &reports, i, core = cores[i]] { reports[i] = measure( core ); } );
+    }
+    for ( auto& w : workers )
+    {
+        w.join();
+    }
+    return reports;
+}
+
+bool JitterDetector::isNoisy( const JitterReport& report ) const
+{
+    return report.stolenFraction() > config_.max_stolen_fraction ||
+           report.max_gap_ns > static_cast<std::uint64_t>( config_.max_single_gap.count() );
+}
+
+void JitterDetector::print( std::ostream& out, std::string_view phase, std::span<const JitterReport> reports ) const
+{
+    // stolen_pct is printed fixed-point; the caller's stream state is put
+    // back afterwards so later report lines are unaffected.
+    const auto flags     = out.flags();
+    const auto precision = out.precision();
+    for ( const auto& r : reports )
+    {
+        out << "[Jitter] phase=" << phase << " core=" << r.core << ( r.pinned ? "" : "(unpinned)" ) << " wall_ns=" << r.wall_ns
+            << " gaps=" << r.gaps.total() << " stolen_ns=" << r.stolen_ns << " stolen_pct=" << std::fixed << std::setprecision( 4 )
+            << r.stolenFraction() * 100.0 << " max_gap_ns=" << r.max_gap_ns << " p99_gap_ns<=" << r.gaps.quantileUpperBound( 0.99 )
+            << " verdict=" << ( isNoisy( r ) ? "NOISY" : "quiet" ) << "\n";
+
+        for ( std::size_t i = 0; i < JitterHistogram::Buckets; ++i )
+        {
+            if ( r.gaps.counts[i] )
+            {
+                out << "[Jitter]   [" << ( std::uint64_t{ 1 } << i ) << ", " << ( std::uint64_t{ 1 } << ( i + 1 ) ) << ") ns: " << r.gaps.counts[i]
+                    << "\n";
+            }
+        }
+    }
+    out.flags( flags );
+    out.precision( precision );
+}
@@ -0,0 +1,754 @@
+// ============================================================================
+// MarketMicrostructureEngine — Block-Compressed Journal Implementation
+// ============================================================================
+
+#include <block_codec.h>
+#include <book_types.h>
+#include <journal.h>
+#include <sequencer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+constexpr char JournalMagic[8]         = { 'M', 'M', 'J', 'R', 'N', 'L', '1', '\0' };
+constexpr char TrailerMagic[8]         = { 'M', 'M', 'J', 'I', 'D', 'X', '1', '\0' };
+constexpr std::uint32_t BlockMagic     = 0x4B4C424AU;  // "JBLK"
+constexpr std::uint32_t JournalVersion = 1;
+constexpr char IndexMagic[8]           = { 'M', 'M', 'J', 'S', 'I', 'X', '1', '\0' };
+constexpr std::uint32_t IndexVersion   = 1;
+constexpr std::size_t FilterBitsPerId  = 16;
+constexpr std::uint32_t FilterProbes   = 4;
+
+struct JournalFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t record_size;
+    std::uint32_t block_records;
+};
+
+struct JournalBlockHeader
+{
+    std::uint32_t magic;
+    std::uint32_t records;
+    std::uint32_t stored_bytes;
+    std::uint32_t checksum;  ///< FNV-1a of the stored payload
+    std::uint64_t first_record;
+};
+
+struct JournalTrailer
+{
+    std::uint64_t index_offset;
+    std::uint64_t blocks;
+    std::uint64_t records;
+    char magic[8];
+};
+
+struct JournalIndexHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t record_size;
+    std::uint32_t filter_probes;
+};
+
+/// @brief Record layout of each journal kind.
+std::size_t recordSizeOf( JournalKind kind )
+{
+    return kind == JournalKind::Events ? sizeof( SequencedEvent ) : sizeof( SimTrade );
+}
+
+std::size_t idsPerRecord( JournalKind kind )
+{
+    return kind == JournalKind::Events ? 1 : 2;
+}
+
+/// @brief Index keys of one record.
+struct RecordKeys
+{
+    Timestamp time{ 0 };
+    OrderId ids[2]{};
+    std::size_t count{ 0 };
+};
+
+RecordKeys recordKeys( JournalKind kind, const std::uint8_t* record )
+{
+    if ( kind == JournalKind::Trades )
+    {
+        SimTrade trade;
+        std::memcpy( static_cast<void*>( &trade ), record, sizeof( trade ) );
+        return { .time = trade.time, .ids = { trade.maker_id, trade.taker_id }, .count = 2 };
+    }
+    SequencedEvent sequenced;
+    std::memcpy( static_cast<void*>( &sequenced ), record, sizeof( sequenced ) );
+    const EngineEvent& ev = sequenced.event;
+    return { .time = ev.event_time, .ids = { ev.type == EventType::CancelOrder ? ev.cancel.order_id : ev.order.id, 0 }, .count = 1 };
+}
+
+/// @brief Calls @p probe with each filter bit of @p id (double hashing over
+/// a splitmix64 finaliser).
+template <typename Probe>
+void forEachProbe( OrderId id, std::size_t bits, Probe&& probe )
+{
+    std::uint64_t h = static_cast<std::uint64_t>( id ) + 0x9E3779B97F4A7C15ULL;
+    h               = ( h ^ ( h >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    h               = ( h ^ ( h >> 27 ) ) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    const std::uint64_t h1 = h & 0xFFFFFFFFU;
+    const std::uint64_t h2 = ( h >> 32 ) | 1;
+    for ( std::uint32_t i = 0; i < FilterProbes; ++i )
+    {
+        if ( !probe( ( h1 + i * h2 ) % bits ) )
+        {
+            return;
+        }
+    }
+}
+
+/// @brief Keys and id filter of @p records decoded records at @p data.
+/// offset is left for the caller.
+JournalKeys blockKeys( JournalKind kind, std::size_t record_size, const std::uint8_t* data, std::uint64_t first_record, std::uint32_t records,
+                       std::vector<std::uint64_t>& filter )
+{
+    JournalKeys keys{ .first_record = first_record,
+                      .records      = records,
+                      .filter_words = static_cast<std::uint32_t>( ( records * idsPerRecord( kind ) * FilterBitsPerId + 63 ) / 64 ),
+                      .min_time     = std::numeric_limits<Timestamp>::max(),
+                      .min_id       = std::numeric_limits<OrderId>::max() };
+    filter.assign( keys.filter_words, 0 );
+    const std::size_t bits = std::size_t{ keys.filter_words } * 64;
+
+    for ( std::uint32_t r = 0; r < records; ++r )
+    {
+        const RecordKeys record = recordKeys( kind, data + std::size_t{ r } * record_size );
+        keys.min_time           = std::min( keys.min_time, record.time );
+        keys.max_time           = std::max( keys.max_time, record.time );
+        for ( std::size_t i = 0; i < record.count; ++i )
+        {
+            keys.min_id = std::min( keys.min_id, record.ids[i] );
+            keys.max_id = std::max( keys.max_id, record.ids[i] );
+            forEachProbe( record.ids[i], bits,
+                          [&filter]( std::size_t bit )
+                          {
+                              filter[bit / 64] |= std::uint64_t{ 1 } << ( bit % 64 );
+                              return true;
+                          } );
+        }
+    }
+    return keys;
+}
+
+std::uint32_t checksum32( const std::uint8_t* data, std::size_t size )
+{
+    std::uint32_t hash = 0x811c9dc5U;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hash = ( hash ^ data[i] ) * 0x01000193U;
+    }
+    return hash;
+}
+
+template <typename T>
+bool readExact( std::ifstream& in, T* out, std::size_t count = 1 )
+{
+    return static_cast<bool>( in.read( reinterpret_cast<char*>( out ), static_cast<std::streamsize>( sizeof( T ) * count ) ) );
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+// JournalWriter
+// ----------------------------------------------------------------------------
+
+std::expected<std::unique_ptr<JournalWriter>, std::string> JournalWriter::open( const std::string& path, JournalKind kind, std::size_t record_size,
+                                                                                const JournalConfig& config )
+{
+    if ( record_size != recordSizeOf( kind ) )
+    {
+        return std::unexpected( "journal '" + path + "': record size " + std::to_string( record_size ) + " does not match the journal kind" );
+    }
+    if ( config.staging_blocks == 0 || config.workers == 0 )
+    {
+        return std::unexpected( "journal '" + path + "': staging blocks and workers must be non-zero" );
+    }
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    if ( !file )
+    {
+        return std::unexpected( "cannot create journal '" + path + "'" );
+    }
+    std::ofstream sidecar( JournalIndex::sidecarPath( path ), std::ios::binary | std::ios::trunc );
+    if ( !sidecar )
+    {
+        return std::unexpected( "cannot create journal index '" + JournalIndex::sidecarPath( path ) + "'" );
+    }
+    return std::unique_ptr<JournalWriter>( new JournalWriter( std::move( file ), std::move( sidecar ), kind, record_size, config ) );
+}
+
+JournalWriter::JournalWriter( std::ofstream file, std::ofstream sidecar, JournalKind kind, std::size_t record_size, const JournalConfig& config )
+    : file_( std::move( file ) ),
+      sidecar_( std::move( sidecar ) ),
+      kind_( kind ),
+      record_size_( record_size ),
+      block_records_( static_cast<std::uint32_t>( std::max<std::size_t>( 1, config.block_bytes / record_size ) ) )
+{
+    JournalFileHeader header{};
+    std::memcpy( header.magic, JournalMagic, sizeof( JournalMagic ) );
+    header.version       = JournalVersion;
+    header.kind          = static_cast<std::uint32_t>( kind_ );
+    header.record_size   = static_cast<std::uint32_t>( record_size_ );
+    header.block_records = block_records_;
+    file_.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    offset_ = sizeof( header );
+
+    JournalIndexHeader index_header{};
+    std::memcpy( index_header.magic, IndexMagic, sizeof( IndexMagic ) );
+    index_header.version       = IndexVersion;
+    index_header.kind          = static_cast<std::uint32_t>( kind_ );
+    index_header.record_size   = static_cast<std::uint32_t>( record_size_ );
+    index_header.filter_probes = FilterProbes;
+    sidecar_.write( reinterpret_cast<const char*>( &index_header ), sizeof( index_header ) );
+
+    // Both buffers are written through once here, so the staging ring is
+    // faulted in before the first append.
+    const std::size_t raw_bytes = std::size_t{ block_records_ } * record_size_;
+    for ( std::size_t i = 0; i < config.staging_blocks; ++i )
+    {
+        auto slot = std::make_unique<Slot>();
+        slot->raw.resize( raw_bytes );
+        slot->stored.resize( blockCompressBound( raw_bytes ) );
+        slots_.push_back( std::move( slot ) );
+    }
+
+    for ( std::size_t w = 0; w < config.workers; ++w )
+    {
+        workers_.emplace_back( [this] { runWorker(); } );
+    }
+}
+
+JournalWriter::~JournalWriter()
+{
+    (void)close();
+}
+
+void JournalWriter::append( const void* record )
+{
+    if ( current_ == nullptr )
+    {
+        Slot& slot = *slots_[sealed_.load( std::memory_order_relaxed ) % slots_.size()];
+        if ( !slot.free.load( std::memory_order_acquire ) )
+        {
+            // Every staging block is still being compressed or written.
+            ++stalls_;
+            while ( !slot.free.load( std::memory_order_acquire ) )
+            {
+                std::this_thread::yield();
+            }
+        }
+        current_ = &slot;
+    }
+
+    std::memcpy( current_->raw.data() + std::size_t{ fill_ } * record_size_, record, record_size_ );
+    ++records_;
+    if ( ++fill_ == block_records_ )
+    {
+        seal();
+    }
+}
+
+void JournalWriter::seal()
+{
+    const std::uint64_t block = sealed_.load( std::memory_order_relaxed );
+    current_->block           = block;
+    current_->first_record    = records_ - fill_;
+    current_->records         = fill_;
+    current_->free.store( false, std::memory_order_relaxed );
+    sealed_.store( block + 1, std::memory_order_release );
+
+    // One wake per block, not per record.
+    wake_.fetch_add( 1, std::memory_order_release );
+    wake_.notify_all();
+
+    current_ = nullptr;
+    fill_    = 0;
+}
+
+void JournalWriter::runWorker()
+{
+    for ( ;; )
+    {
+        const std::uint64_t seen = wake_.load( std::memory_order_acquire );
+        std::uint64_t block      = claimed_.load( std::memory_order_relaxed );
+        if ( block < sealed_.load( std::memory_order_acquire ) )
+        {
+            if ( claimed_.compare_exchange_weak( block, block + 1, std::memory_order_acq_rel ) )
+            {
+                Slot& slot = *slots_[block % slots_.size()];
+                compress( slot );
+                commit( slot );
+            }
+            continue;
+        }
+        if ( stopping_.load( std::memory_order_acquire ) )
+        {
+            // The last seal happens before stopping_ is set: look again.
+            if ( claimed_.load( std::memory_order_relaxed ) >= sealed_.load( std::memory_order_acquire ) )
+            {
+                return;
+            }
+            continue;
+        }
+        wake_.wait( seen, std::memory_order_acquire );
+    }
+}
+
+void JournalWriter::compress( Slot& slot )
+{
+    const std::size_t raw_bytes = std::size_t{ slot.records } * record_size_;
+    std::size_t stored          = blockCompress( slot.raw.data(), raw_bytes, slot.stored.data(), slot.stored.size() );
+    if ( stored == 0 || stored >= raw_bytes )
+    {
+        stored = raw_bytes;  // incompressible: commit() writes the raw block
+    }
+    slot.stored_bytes = static_cast<std::uint32_t>( stored );
+    slot.checksum     = checksum32( stored == raw_bytes ? slot.raw.data() : slot.stored.data(), stored );
+    slot.keys         = blockKeys( kind_, record_size_, slot.raw.data(), slot.first_record, slot.records, slot.filter );
+}
+
+void JournalWriter::commit( Slot& slot )
+{
+    std::lock_guard lock( commit_mutex_ );
+    slot.compressed = true;
+
+    // Blocks finish out of order; write every one that is next in line.
+    const std::uint64_t first = next_commit_;
+    for ( ;; )
+    {
+        Slot& next = *slots_[next_commit_ % slots_.size()];
+        if ( !next.compressed || next.block != next_commit_ )
+        {
+            break;
+        }
+
+        const std::size_t raw_bytes = std::size_t{ next.records } * record_size_;
+        const JournalBlockHeader header{ .magic        = BlockMagic,
+                                         .records      = next.records,
+                                         .stored_bytes = next.stored_bytes,
+                                         .checksum     = next.checksum,
+                                         .first_record = next.first_record };
+        const std::uint8_t* payload = next.stored_bytes == raw_bytes ? next.raw.data() : next.stored.data();
+        file_.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        file_.write( reinterpret_cast<const char*>( payload ), next.stored_bytes );
+
+        next.keys.offset = offset_;
+        index_.push_back( { .offset = offset_, .first_record = next.first_record, .records = next.records, .stored_bytes = next.stored_bytes } );
+        offset_ += sizeof( header ) + next.stored_bytes;
+        raw_bytes_ += raw_bytes;
+        stored_bytes_ += next.stored_bytes;
+        ++next_commit_;
+    }
+    if ( next_commit_ == first )
+    {
+        return;
+    }
+
+    // One flush per batch, not per block.  The batch reaches the OS before
+    // its sidecar entries are written, so after a process crash an entry
+    // never points past the journal; what a crash can lose is the batch
+    // being written and its entries (rebuilt from the journal on open).
+    // Both are page-cache writes: a power loss is not covered.
+    file_.flush();
+    if ( !file_ && error_.empty() )
+    {
+        error_ = "journal write failed at block " + std::to_string( next_commit_ - 1 );
+    }
+    for ( std::uint64_t block = first; block < next_commit_; ++block )
+    {
+        const Slot& done = *slots_[block % slots_.size()];
+        sidecar_.write( reinterpret_cast<const char*>( &done.keys ), sizeof( done.keys ) );
+        sidecar_.write( reinterpret_cast<const char*>( done.filter.data() ), static_cast<std::streamsize>( done.filter.size() * sizeof( std::uint64_t ) ) );
+    }
+    sidecar_.flush();
+    if ( !sidecar_ && error_.empty() )
+    {
+        error_ = "journal index write failed at block " + std::to_string( next_commit_ - 1 );
+    }
+
+    // Slots go back to the appender only once their entries are written.
+    for ( std::uint64_t block = first; block < next_commit_; ++block )
+    {
+        Slot& done      = *slots_[block % slots_.size()];
+        done.compressed = false;
+        done.free.store( true, std::memory_order_release );
+    }
+}
+
+std::expected<void, std::string> JournalWriter::close()
+{
+    if ( closed_ )
+    {
+        return {};
+    }
+    closed_ = true;
+
+    if ( fill_ > 0 )
+    {
+        seal();
+    }
+    stopping_.store( true, std::memory_order_release );
+    wake_.fetch_add( 1, std::memory_order_release );
+    wake_.notify_all();
+    workers_.clear();  // joins
+
+    JournalTrailer trailer{ .index_offset = offset_, .blocks = index_.size(), .records = records_, .magic = {} };
+    std::memcpy( trailer.magic, TrailerMagic, sizeof( TrailerMagic ) );
+    file_.write( reinterpret_cast<const char*>( index_.data() ), static_cast<std::streamsize>( index_.size() * sizeof( JournalBlock ) ) );
+    file_.write( reinterpret_cast<const char*>( &trailer ), sizeof( trailer ) );
+    file_.flush();
+    if ( !file_ && error_.empty() )
+    {
+        error_ = "journal index write failed";
+    }
+    file_.close();
+    sidecar_.close();
+    if ( !error_.empty() )
+    {
+        return std::unexpected( error_ );
+    }
+    return {};
+}
+
+JournalStats JournalWriter::stats() const
+{
+    std::lock_guard lock( commit_mutex_ );
+    return { .records        = records_,
+             .blocks         = index_.size(),
+             .raw_bytes      = raw_bytes_,
+             .stored_bytes   = stored_bytes_,
+             .staging_stalls = stalls_ };
+}
+
+// ----------------------------------------------------------------------------
+// JournalReader
+// ----------------------------------------------------------------------------
+
+JournalReader::JournalReader( std::ifstream file, std::string path ) : file_( std::move( file ) ), path_( std::move( path ) ) {}
+
+std::expected<JournalReader, std::string> JournalReader::open( const std::string& path )
+{
+    std::ifstream file( path, std::ios::binary );
+    if ( !file )
+    {
+        return std::unexpected( "cannot open journal '" + path + "'" );
+    }
+
+    JournalFileHeader header{};
+    if ( !readExact( file, &header ) || std::memcmp( header.magic, JournalMagic, sizeof( JournalMagic ) ) != 0 )
+    {
+        return std::unexpected( "'" + path + "' is not a journal (bad magic)" );
+    }
+    if ( header.version != JournalVersion || header.record_size == 0 )
+    {
+        return std::unexpected( "'" + path + "' has unsupported journal version " + std::to_string( header.version ) );
+    }
+
+    JournalReader reader( std::move( file ), path );
+    reader.kind_        = static_cast<JournalKind>( header.kind );
+    reader.record_size_ = header.record_size;
+
+    std::ifstream& in = reader.file_;
+    in.seekg( 0, std::ios::end );
+    const auto size = static_cast<std::uint64_t>( in.tellg() );
+
+    // Clean close: the trailer points at a complete index.
+    JournalTrailer trailer{};
+    if ( size >= sizeof( header ) + sizeof( trailer ) )
+    {
+        in.seekg( static_cast<std::streamoff>( size - sizeof( trailer ) ) );
+        if ( readExact( in, &trailer ) && std::memcmp( trailer.magic, TrailerMagic, sizeof( TrailerMagic ) ) == 0
+             && trailer.index_offset + trailer.blocks * sizeof( JournalBlock ) + sizeof( trailer ) == size )
+        {
+            reader.index_.resize( trailer.blocks );
+            in.seekg( static_cast<std::streamoff>( trailer.index_offset ) );
+            if ( !readExact( in, reader.index_.data(), reader.index_.size() ) )
+            {
+                return std::unexpected( "'" + path + "': truncated block index" );
+            }
+            return reader;
+        }
+    }
+
+    // No trailer: walk the block headers up to the first incomplete block.
+    reader.recovered_    = true;
+    std::uint64_t offset = sizeof( header );
+    std::uint64_t next   = 0;
+    JournalBlockHeader block{};
+    while ( offset + sizeof( block ) <= size )
+    {
+        in.clear();
+        in.seekg( static_cast<std::streamoff>( offset ) );
+        if ( !readExact( in, &block ) || block.magic != BlockMagic || block.first_record != next
+             || offset + sizeof( block ) + block.stored_bytes > size )
+        {
+            break;
+        }
+        reader.index_.push_back( { .offset = offset, .first_record = block.first_record, .records = block.records, .stored_bytes = block.stored_bytes } );
+        offset += sizeof( block ) + block.stored_bytes;
+        next += block.records;
+    }
+    in.clear();
+    return reader;
+}
+
+std::size_t JournalReader::blockOf( std::uint64_t record ) const
+{
+    const auto after = std::upper_bound( index_.begin(), index_.end(), record,
+                                         []( std::uint64_t r, const JournalBlock& b ) { return r < b.first_record; } );
+    return static_cast<std::size_t>( after - index_.begin() ) - 1;
+}
+
+std::expected<std::span<const std::uint8_t>, std::string> JournalReader::block( std::size_t block )
+{
+    if ( block >= index_.size() )
+    {
+        return std::unexpected( "'" + path_ + "': no block " + std::to_string( block ) );
+    }
+    const JournalBlock& entry   = index_[block];
+    const std::size_t raw_bytes = std::size_t{ entry.records } * record_size_;
+    if ( block == cached_block_ )
+    {
+        return std::span<const std::uint8_t>( raw_.data(), raw_bytes );
+    }
+
+    JournalBlockHeader header{};
+    cached_block_ = static_cast<std::size_t>( -1 );
+    stored_.resize( entry.stored_bytes );
+    raw_.resize( raw_bytes );
+    file_.clear();
+    file_.seekg( static_cast<std::streamoff>( entry.offset ) );
+    if ( !readExact( file_, &header ) || header.magic != BlockMagic || !readExact( file_, stored_.data(), stored_.size() ) )
+    {
+        return std::unexpected( "'" + path_ + "': cannot read block " + std::to_string( block ) );
+    }
+    if ( checksum32( stored_.data(), stored_.size() ) != header.checksum )
+    {
+        return std::unexpected( "'" + path_ + "': checksum mismatch in block " + std::to_string( block ) );
+    }
+
+    if ( entry.stored_bytes == raw_bytes )
+    {
+        raw_.swap( stored_ );
+    }
+    else if ( !blockDecompress( stored_.data(), stored_.size(), raw_.data(), raw_bytes ) )
+    {
+        return std::unexpected( "'" + path_ + "': block " + std::to_string( block ) + " does not decode" );
+    }
+    cached_block_ = block;
+    return std::span<const std::uint8_t>( raw_.data(), raw_bytes );
+}
+
+std::expected<void, std::string> JournalReader::read( std::uint64_t record, void* out )
+{
+    if ( record >= records() )
+    {
+        return std::unexpected( "'" + path_ + "': no record " + std::to_string( record ) );
+    }
+    const std::size_t b = blockOf( record );
+    const auto data     = block( b );
+    if ( !data )
+    {
+        return std::unexpected( data.error() );
+    }
+    std::memcpy( out, data->data() + ( record - index_[b].first_record ) * record_size_, record_size_ );
+    return {};
+}
+
+// ----------------------------------------------------------------------------
+// JournalIndex
+// ----------------------------------------------------------------------------
+
+std::string JournalIndex::sidecarPath( const std::string& journal )
+{
+    return journal + ".idx";
+}
+
+std::expected<JournalIndex, std::string> JournalIndex::open( const std::string& path, JournalReader& journal )
+{
+    if ( journal.recordSize() != recordSizeOf( journal.kind() ) )
+    {
+        return std::unexpected( "'" + path + "': record size " + std::to_string( journal.recordSize() ) + " does not match the journal kind" );
+    }
+
+    JournalIndex index;
+    const std::vector<JournalBlock>& blocks = journal.index();
+    const std::string sidecar_path          = sidecarPath( path );
+    if ( std::ifstream in( sidecar_path, std::ios::binary ); in )
+    {
+        JournalIndexHeader header{};
+        if ( !readExact( in, &header ) || std::memcmp( header.magic, IndexMagic, sizeof( IndexMagic ) ) != 0 || header.version != IndexVersion )
+        {
+            return std::unexpected( "'" + sidecar_path + "' is not a journal index" );
+        }
+        if ( header.kind != static_cast<std::uint32_t>( journal.kind() ) || header.record_size != journal.recordSize()
+             || header.filter_probes != FilterProbes )
+        {
+            return std::unexpected( "'" + sidecar_path + "' does not belong to '" + path + "'" );
+        }
+
+        // Entries are taken while they agree with the journal's own index.
+        JournalKeys keys;
+        std::vector<std::uint64_t> filter;
+        while ( index.keys_.size() < blocks.size() && readExact( in, &keys ) )
+        {
+            const JournalBlock& block = blocks[index.keys_.size()];
+            if ( keys.offset != block.offset || keys.first_record != block.first_record || keys.records != block.records
+                 || keys.filter_words != ( keys.records * idsPerRecord( journal.kind() ) * FilterBitsPerId + 63 ) / 64 )
+            {
+                break;
+            }
+            filter.resize( keys.filter_words );
+            if ( !readExact( in, filter.data(), filter.size() ) )
+            {
+                break;
+            }
+            index.add( keys, filter.data() );
+        }
+    }
+
+    std::vector<std::uint64_t> filter;
+    for ( std::size_t b = index.keys_.size(); b < blocks.size(); ++b )
+    {
+        const auto data = journal.block( b );
+        if ( !data )
+        {
+            return std::unexpected( data.error() );
+        }
+        JournalKeys keys = blockKeys( journal.kind(), journal.recordSize(), data->data(), blocks[b].first_record, blocks[b].records, filter );
+        keys.offset      = blocks[b].offset;
+        index.add( keys, filter.data() );
+        ++index.rebuilt_;
+    }
+    index.buildSearchKeys();
+    return index;
+}
+
+void JournalIndex::add( const JournalKeys& keys, const std::uint64_t* filter )
+{
+    keys_.push_back( keys );
+    filter_at_.push_back( filters_.size() );
+    filters_.insert( filters_.end(), filter, filter + keys.filter_words );
+}
+
+void JournalIndex::buildSearchKeys()
+{
+    const std::size_t n = keys_.size();
+    max_time_upto_.resize( n );
+    min_time_from_.resize( n );
+    max_id_upto_.resize( n );
+    min_id_from_.resize( n );
+    for ( std::size_t b = 0; b < n; ++b )
+    {
+        max_time_upto_[b] = b == 0 ? keys_[b].max_time : std::max( max_time_upto_[b - 1], keys_[b].max_time );
+        max_id_upto_[b]   = b == 0 ? keys_[b].max_id : std::max( max_id_upto_[b - 1], keys_[b].max_id );
+    }
+    for ( std::size_t b = n; b-- > 0; )
+    {
+        min_time_from_[b] = b + 1 == n ? keys_[b].min_time : std::min( min_time_from_[b + 1], keys_[b].min_time );
+        min_id_from_[b]   = b + 1 == n ? keys_[b].min_id : std::min( min_id_from_[b + 1], keys_[b].min_id );
+    }
+}
+
+bool JournalIndex::mayReference( std::size_t block, OrderId id ) const
+{
+    const JournalKeys& keys = keys_[block];
+    if ( id < keys.min_id || id > keys.max_id )
+    {
+        return false;
+    }
+    const std::uint64_t* filter = filters_.data() + filter_at_[block];
+    bool present                = true;
+    forEachProbe( id, std::size_t{ keys.filter_words } * 64,
+                  [filter, &present]( std::size_t bit )
+                  {
+                      present = ( filter[bit / 64] >> ( bit % 64 ) ) & 1;
+                      return present;
+                  } );
+    return present;
+}
+
+std::expected<JournalMatches, std::string> JournalIndex::findTime( JournalReader& journal, Timestamp from, Timestamp to ) const
+{
+    JournalMatches matches;
+    if ( from >= to )
+    {
+        return matches;
+    }
+    // Every block before the first whose running max reaches @p from lies
+    // wholly before it.
+    std::size_t b = static_cast<std::size_t>( std::lower_bound( max_time_upto_.begin(), max_time_upto_.end(), from ) - max_time_upto_.begin() );
+    for ( ; b < keys_.size() && min_time_from_[b] < to; ++b )
+    {
+        const JournalKeys& keys = keys_[b];
+        if ( keys.max_time < from || keys.min_time >= to )
+        {
+            continue;
+        }
+        const auto data = journal.block( b );
+        if ( !data )
+        {
+            return std::unexpected( data.error() );
+        }
+        ++matches.blocks_decoded;
+        for ( std::uint32_t r = 0; r < keys.records; ++r )
+        {
+            const Timestamp time = recordKeys( journal.kind(), data->data() + std::size_t{ r } * journal.recordSize() ).time;
+            if ( time >= from && time < to )
+            {
+                matches.records.push_back( keys.first_record + r );
+            }
+        }
+    }
+    return matches;
+}
+
+std::expected<JournalMatches, std::string> JournalIndex::findOrder( JournalReader& journal, OrderId id ) const
+{
+    JournalMatches matches;
+    std::size_t b = static_cast<std::size_t>( std::lower_bound( max_id_upto_.begin(), max_id_upto_.end(), id ) - max_id_upto_.begin() );
+    for ( ; b < keys_.size() && min_id_from_[b] <= id; ++b )
+    {
+        if ( !mayReference( b, id ) )
+        {
+            continue;
+        }
+        const auto data = journal.block( b );
+        if ( !data )
+        {
+            return std::unexpected( data.error() );
+        }
+        ++matches.blocks_decoded;
+        const JournalKeys& keys = keys_[b];
+        for ( std::uint32_t r = 0; r < keys.records; ++r )
+        {
+            const RecordKeys record = recordKeys( journal.kind(), data->data() + std::size_t{ r } * journal.recordSize() );
+            if ( std::find( record.ids, record.ids + record.count, id ) != record.ids + record.count )
+            {
+                matches.records.push_back( keys.first_record + r );
+            }
+        }
+    }
+    return matches;
+}
+
+void MarketMicroStructure::printJournalStats( std::ostream& out, const std::string& name, const JournalStats& stats )
+{
+    out << "[Journal] name=" << name << " records=" << stats.records << " blocks=" << stats.blocks << " raw_bytes=" << stats.raw_bytes
+        << " stored_bytes=" << stats.stored_bytes << " ratio=" << stats.ratio() << " staging_stalls=" << stats.staging_stalls << "\n";
+}
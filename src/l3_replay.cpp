@@ -0,0 +1,529 @@
+// ============================================================================
+// MarketMicrostructureEngine — Historical L3 Replay Implementation
+//
+// A replay book keeps what the snapshots check: every resting order by id,
+// plus per-price level totals (shares and order count) on each side.
+// Feed books never cross, so nothing is matched here: executions and
+// deletes come from the exchange as their own messages.  Each order keeps
+// its arrival sequence, so the final book can be exported in queue order:
+// a modify that moves the price or adds shares loses priority, one that
+// only reduces shares keeps it.
+// ============================================================================
+
+#include <l3_replay.h>
+
+#include <common/types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+static_assert( std::endian::native == std::endian::little, "L3 files are little-endian; add byte swapping for this target" );
+
+namespace
+{
+struct Level
+{
+    std::uint64_t shares{ 0 };
+    std::uint32_t orders{ 0 };
+};
+
+enum class Execution
+{
+    Applied,
+    UnknownOrder,
+    OverExecuted,  ///< More shares than rest; the order is removed anyway
+};
+
+class ReplayBook
+{
+public:
+    bool add( std::uint64_t id, char side, std::int64_t price, std::uint32_t qty, std::uint64_t time )
+    {
+        if ( !orders_.try_emplace( id, Resting{ price, qty, side, next_seq_, time } ).second )
+        {
+            return false;
+        }
+        ++next_seq_;
+        join( side, price, qty );
+        return true;
+    }
+
+    bool modify( std::uint64_t id, std::int64_t price, std::uint32_t qty )
+    {
+        const auto it = orders_.find( id );
+        if ( it == orders_.end() )
+        {
+            return false;
+        }
+        Resting& order = it->second;
+        leave( order.side, order.price, order.qty );
+        if ( price != order.price || qty > order.qty )
+        {
+            order.seq = next_seq_++;
+        }
+        order.price = price;
+        order.qty   = qty;
+        if ( qty == 0 )
+        {
+            orders_.erase( it );
+            return true;
+        }
+        join( order.side, price, qty );
+        return true;
+    }
+
+    bool remove( std::uint64_t id )
+    {
+        const auto it = orders_.find( id );
+        if ( it == orders_.end() )
+        {
+            return false;
+        }
+        leave( it->second.side, it->second.price, it->second.qty );
+        orders_.erase( it );
+        return true;
+    }
+
+    Execution execute( std::uint64_t id, std::uint32_t qty )
+    {
+        const auto it = orders_.find( id );
+        if ( it == orders_.end() )
+        {
+            return Execution::UnknownOrder;
+        }
+        Resting& order = it->second;
+        if ( qty >= order.qty )
+        {
+            const bool exact = qty == order.qty;
+            leave( order.side, order.price, order.qty );
+            orders_.erase( it );
+            return exact ? Execution::Applied : Execution::OverExecuted;
+        }
+        Level& level = levelFor( order.side, order.price );
+        level.shares -= qty;
+        order.qty -= qty;
+        return Execution::Applied;
+    }
+
+    /// @brief Empty if the book's best @p depth levels (all if 0) on each
+    /// side equal @p rows; otherwise a description of the first difference.
+    std::string compare( std::span<const L3Message> rows, std::int64_t depth, std::uint64_t time ) const
+    {
+        std::string diff = compareSide( bids_, rows, 'B', depth );
+        if ( diff.empty() )
+        {
+            diff = compareSide( asks_, rows, 'S', depth );
+        }
+        return diff.empty() ? diff : "t=" + std::to_string( time ) + " " + diff;
+    }
+
+    std::size_t restingOrders() const { return orders_.size(); }
+
+    /// @brief Every resting order, oldest first, so each level replays in
+    /// queue order.  Executed shares are already off quantity.
+    std::vector<Order> exportOrders( const Symbol& symbol ) const
+    {
+        std::vector<std::pair<std::uint64_t, Order>> by_seq;
+        by_seq.reserve( orders_.size() );
+        for ( const auto& [id, resting] : orders_ )
+        {
+            Order order{};
+            order.id          = id;
+            order.symbol      = symbol;
+            order.side        = resting.side == 'B' ? Side::Buy : Side::Sell;
+            order.type        = OrderType::Limit;
+            order.tif         = TimeInForce::Day;
+            order.price       = resting.price;
+            order.quantity    = resting.qty;
+            order.status      = OrderStatus::New;
+            order.submit_time = resting.time;
+            order.accept_time = resting.time;
+            by_seq.emplace_back( resting.seq, order );
+        }
+        std::sort( by_seq.begin(), by_seq.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+
+        std::vector<Order> orders;
+        orders.reserve( by_seq.size() );
+        for ( const auto& entry : by_seq )
+        {
+            orders.push_back( entry.second );
+        }
+        return orders;
+    }
+
+private:
+    struct Resting
+    {
+        std::int64_t price;
+        std::uint32_t qty;
+        char side;
+        std::uint64_t seq;   ///< Arrival order; reset when priority is lost
+        std::uint64_t time;  ///< Feed time of the add
+    };
+
+    Level& levelFor( char side, std::int64_t price ) { return side == 'B' ? bids_[price] : asks_[price]; }
+
+    void join( char side, std::int64_t price, std::uint32_t qty )
+    {
+        Level& level = levelFor( side, price );
+        level.shares += qty;
+        ++level.orders;
+    }
+
+    void leave( char side, std::int64_t price, std::uint32_t qty )
+    {
+        if ( side == 'B' )
+        {
+            leaveSide( bids_, price, qty );
+        }
+        else
+        {
+            leaveSide( asks_, price, qty );
+        }
+    }
+
+    template <typename Side>
+    static void leaveSide( Side& levels, std::int64_t price, std::uint32_t qty )
+    {
+        const auto it = levels.find( price );
+        it->second.shares -= qty;
+        if ( --it->second.orders == 0 )
+        {
+            levels.erase( it );
+        }
+    }
+
+    template <typename Side>
+    static std::string compareSide( const Side& levels, std::span<const L3Message> rows, char side, std::int64_t depth )
+    {
+        const std::string name = side == 'B' ? "bid" : "ask";
+        auto level             = levels.begin();
+        std::size_t n          = 0;
+        for ( const L3Message& row : rows )
+        {
+            if ( row.side != side )
+            {
+                continue;
+            }
+            if ( level == levels.end() )
+            {
+                return name + " level " + std::to_string( n ) + ": book has no level, snapshot " + std::to_string( row.price ) + "x"
+                       + std::to_string( row.quantity );
+            }
+            if ( level->first != row.price || level->second.shares != row.quantity || level->second.orders != row.order_id )
+            {
+                return name + " level " + std::to_string( n ) + ": book " + std::to_string( level->first ) + "x"
+                       + std::to_string( level->second.shares ) + "(" + std::to_string( level->second.orders ) + ") snapshot "
+                       + std::to_string( row.price ) + "x" + std::to_string( row.quantity ) + "(" + std::to_string( row.order_id ) + ")";
+            }
+            ++level;
+            ++n;
+        }
+        if ( level != levels.end() && ( depth == 0 || static_cast<std::int64_t>( n ) < depth ) )
+        {
+            return name + " level " + std::to_string( n ) + ": book " + std::to_string( level->first ) + "x"
+                   + std::to_string( level->second.shares ) + ", snapshot has no level";
+        }
+        return {};
+    }
+
+    std::unordered_map<std::uint64_t, Resting> orders_;
+    std::uint64_t next_seq_{ 0 };
+    std::map<std::int64_t, Level, std::greater<>> bids_;
+    std::map<std::int64_t, Level> asks_;
+};
+
+L3SymbolResult replaySymbol( const std::string& name, std::span<const L3Message> messages, std::span<const std::size_t> indices )
+{
+    L3SymbolResult result;
+    result.messages = indices.size();
+
+    ReplayBook book;
+    std::vector<L3Message> snapshot;  // 'S' rows of the open snapshot
+    std::size_t snapshot_rows  = 0;   // rows still expected
+    std::int64_t snapshot_depth = 0;
+
+    const auto mismatch = [&result]( std::string what )
+    {
+        if ( result.mismatches++ == 0 )
+        {
+            result.first_mismatch = std::move( what );
+        }
+    };
+
+    for ( const std::size_t index : indices )
+    {
+        const L3Message& msg = messages[index];
+        bool known           = true;
+        bool check           = false;
+        switch ( msg.type )
+        {
+        case 'A': known = book.add( msg.order_id, msg.side, msg.price, msg.quantity, msg.time_ns ); break;
+        case 'M': known = book.modify( msg.order_id, msg.price, msg.quantity ); break;
+        case 'D': known = book.remove( msg.order_id ); break;
+        case 'E':
+            switch ( book.execute( msg.order_id, msg.quantity ) )
+            {
+            case Execution::Applied: break;
+            case Execution::UnknownOrder: known = false; break;
+            case Execution::OverExecuted: ++result.over_executions; break;
+            }
+            break;
+        case 'C':
+            if ( snapshot_rows != 0 )
+            {
+                mismatch( "t=" + std::to_string( msg.time_ns ) + " snapshot opened before the previous one was complete" );
+            }
+            snapshot.clear();
+            snapshot_rows  = msg.quantity;
+            snapshot_depth = msg.price;
+            check          = snapshot_rows == 0;  // asserts an empty book
+            break;
+        case 'S':
+            if ( snapshot_rows == 0 )
+            {
+                mismatch( "t=" + std::to_string( msg.time_ns ) + " snapshot row outside a snapshot" );
+                break;
+            }
+            snapshot.push_back( msg );
+            check = snapshot.size() == snapshot_rows;
+            break;
+        }
+
+        if ( !known )
+        {
+            ++result.unknown_orders;
+        }
+        if ( check )
+        {
+            ++result.snapshots;
+            if ( std::string diff = book.compare( snapshot, snapshot_depth, msg.time_ns ); !diff.empty() )
+            {
+                mismatch( std::move( diff ) );
+            }
+            snapshot.clear();
+            snapshot_rows = 0;
+        }
+    }
+
+    if ( snapshot_rows != 0 )
+    {
+        mismatch( "feed ended inside a snapshot" );
+    }
+    result.resting_orders = book.restingOrders();
+    result.book.orders    = book.exportOrders( Symbol( name.c_str() ) );
+    return result;
+}
+
+}  // namespace
+
+std::expected<L3Feed, std::string> MarketMicroStructure::loadL3Feed( const std::string& path )
+{
+    std::ifstream in( path, std::ios::binary );
+    if ( !in )
+    {
+        return std::unexpected( "cannot open L3 feed '" + path + "'" );
+    }
+
+    L3FileHeader header{};
+    if ( !in.read( reinterpret_cast<char*>( &header ), sizeof( header ) ) || std::memcmp( header.magic, L3Magic, sizeof( L3Magic ) ) != 0 )
+    {
+        return std::unexpected( "'" + path + "' is not an L3 feed (bad magic)" );
+    }
+
+    L3Feed feed;
+    std::vector<L3SymbolName> names( header.symbol_count );
+    feed.messages.resize( header.message_count );
+    if ( !in.read( reinterpret_cast<char*>( names.data() ), static_cast<std::streamsize>( names.size() * sizeof( L3SymbolName ) ) )
+         || !in.read( reinterpret_cast<char*>( feed.messages.data() ),
+                      static_cast<std::streamsize>( feed.messages.size() * sizeof( L3Message ) ) ) )
+    {
+        return std::unexpected( "'" + path + "' is truncated" );
+    }
+
+    feed.symbols.reserve( names.size() );
+    for ( const auto& name : names )
+    {
+        feed.symbols.emplace_back( name.name, strnlen( name.name, sizeof( name.name ) ) );
+    }
+
+    constexpr std::string_view Types = "AMDECS";
+    for ( std::size_t i = 0; i < feed.messages.size(); ++i )
+    {
+        const L3Message& msg = feed.messages[i];
+        const bool sided     = msg.type == 'A' || msg.type == 'S';
+        if ( msg.symbol >= header.symbol_count || Types.find( msg.type ) == std::string_view::npos
+             || ( sided && msg.side != 'B' && msg.side != 'S' ) )
+        {
+            return std::unexpected( "'" + path + "': malformed message " + std::to_string( i ) );
+        }
+    }
+    return feed;
+}
+
+std::expected<void, std::string> MarketMicroStructure::saveL3Feed( const std::string& path, const L3Feed& feed )
+{
+    std::ofstream out( path, std::ios::binary );
+    if ( !out )
+    {
+        return std::unexpected( "cannot create L3 feed '" + path + "'" );
+    }
+
+    L3FileHeader header{};
+    std::memcpy( header.magic, L3Magic, sizeof( L3Magic ) );
+    header.symbol_count  = static_cast<std::uint32_t>( feed.symbols.size() );
+    header.message_count = feed.messages.size();
+    out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    for ( const auto& symbol : feed.symbols )
+    {
+        L3SymbolName name{};
+        std::memcpy( name.name, symbol.data(), std::min( symbol.size(), sizeof( name.name ) ) );
+        out.write( reinterpret_cast<const char*>( &name ), sizeof( name ) );
+    }
+    out.write( reinterpret_cast<const char*>( feed.messages.data() ), static_cast<std::streamsize>( feed.messages.size() * sizeof( L3Message ) ) );
+
+    if ( !out.flush() )
+    {
+        return std::unexpected( "failed writing L3 feed '" + path + "'" );
+    }
+    return {};
+}
+
+std::size_t L3ReplayResult::messages() const
+{
+    std::size_t total = 0;
+    for ( const auto& s : symbols )
+    {
+        total += s.messages;
+    }
+    return total;
+}
+
+std::size_t L3ReplayResult::mismatches() const
+{
+    std::size_t total = 0;
+    for ( const auto& s : symbols )
+    {
+        total += s.mismatches;
+    }
+    return total;
+}
+
+L3ReplayResult MarketMicroStructure::replayL3( const L3Feed& feed, std::size_t threads )
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // Stable counting sort of message indices by symbol.
+    const std::size_t symbol_count = feed.symbols.size();
+    std::vector<std::size_t> offsets( symbol_count + 1, 0 );
+    for ( const L3Message& msg : feed.messages )
+    {
+        ++offsets[msg.symbol + 1];
+    }
+    for ( std::size_t s = 0; s < symbol_count; ++s )
+    {
+        offsets[s + 1] += offsets[s];
+    }
+    std::vector<std::size_t> indices( feed.messages.size() );
+    {
+        std::vector<std::size_t> cursor( offsets.begin(), offsets.end() - 1 );
+        for ( std::size_t i = 0; i < feed.messages.size(); ++i )
+        {
+            indices[cursor[feed.messages[i].symbol]++] = i;
+        }
+    }
+
+    L3ReplayResult result;
+    result.symbols.resize( symbol_count );
+    if ( threads == 0 )
+    {
+        threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+    result.threads = std::max<std::size_t>( 1, std::min( threads, symbol_count ) );
+
+    // Symbols are claimed one at a time, so a few heavy symbols do not
+    // leave the other workers idle behind a static split.
+    std::atomic<std::size_t> next_symbol{ 0 };
+    const auto worker = [&]
+    {
+        for ( std::size_t s = next_symbol.fetch_add( 1, std::memory_order_relaxed ); s < symbol_count;
+              s             = next_symbol.fetch_add( 1, std::memory_order_relaxed ) )
+        {
+            const std::span<const std::size_t> mine( indices.data() + offsets[s], offsets[s + 1] - offsets[s] );
+            result.symbols[s] = replaySymbol( feed.symbols[s], feed.messages, mine );
+        }
+    };
+    {
+        std::vector<std::jthread> pool;
+        for ( std::size_t t = 1; t < result.threads; ++t )
+        {
+            pool.emplace_back( worker );
+        }
+        worker();
+    }
+
+    result.elapsed_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count() );
+    return result;
+}
+
+void MarketMicroStructure::printL3Replay( std::ostream& out, const L3Feed& feed, const L3ReplayResult& result )
+{
+    std::size_t snapshots = 0, unknown = 0, over = 0, resting = 0;
+    for ( const auto& s : result.symbols )
+    {
+        snapshots += s.snapshots;
+        unknown += s.unknown_orders;
+        over += s.over_executions;
+        resting += s.resting_orders;
+    }
+    const double seconds = static_cast<double>( result.elapsed_ns ) * 1e-9;
+
+    out << "[L3Replay] symbols=" << feed.symbols.size() << " messages=" << result.messages() << " threads=" << result.threads
+        << " elapsed_ns=" << result.elapsed_ns
+        << " messages_per_sec=" << static_cast<std::uint64_t>( seconds > 0.0 ? static_cast<double>( result.messages() ) / seconds : 0.0 )
+        << " snapshots=" << snapshots << " mismatches=" << result.mismatches() << " unknown_orders=" << unknown
+        << " over_executions=" << over << " resting_orders=" << resting << "\n";
+
+    for ( std::size_t s = 0; s < result.symbols.size(); ++s )
+    {
+        const auto& r = result.symbols[s];
+        if ( r.mismatches != 0 || r.unknown_orders != 0 || r.over_executions != 0 )
+        {
+            out << "[L3Replay] symbol=" << feed.symbols[s] << " mismatches=" << r.mismatches << " unknown_orders=" << r.unknown_orders
+                << " over_executions=" << r.over_executions;
+            if ( !r.first_mismatch.empty() )
+            {
+                out << " first: " << r.first_mismatch;
+            }
+            out << "\n";
+        }
+    }
+}
+
+std::size_t MarketMicroStructure::restoreL3Books( SimMatchingEngine& engine, const L3Feed& feed, const L3ReplayResult& result )
+{
+    std::size_t failed = 0;
+    for ( std::size_t s = 0; s < feed.symbols.size(); ++s )
+    {
+        const SymbolIndex symbol = engine.add_symbol( feed.symbols[s] );
+        if ( !engine.restoreSymbol( symbol, result.symbols[s].book ) )
+        {
+            ++failed;
+        }
+    }
+    return failed;
+}
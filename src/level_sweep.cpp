@@ -0,0 +1,106 @@
+// ============================================================================
+// MarketMicrostructureEngine — Level Sweep Implementation
+//
+// AVX2 path: an in-register inclusive prefix sum over four 64-bit lanes
+// (two shift-and-add steps), plus a running carry broadcast from lane 3.
+// The first lane whose running total exceeds the budget ends the sweep.
+// Quantities are lot counts well below 2^63, so the signed compare is exact.
+// ============================================================================
+
+#include <level_sweep.h>
+
+#include <bit>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+/// @brief Scalar sweep over qty[0], qty[step], qty[2 * step], ...
+SweepResult sweepScalar( const std::uint64_t* qty, std::ptrdiff_t step, std::size_t n, std::uint64_t budget, SweepResult acc )
+{
+    for ( std::size_t i = acc.levels; i < n; ++i )
+    {
+        const std::uint64_t next = acc.volume + qty[static_cast<std::ptrdiff_t>( i ) * step];
+        if ( next > budget )
+        {
+            break;
+        }
+        acc.volume = next;
+        ++acc.levels;
+    }
+    return acc;
+}
+
+#if defined( __AVX2__ )
+/// @brief Inclusive prefix sum of four 64-bit lanes.
+inline __m256i prefixSum4( __m256i x )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    x = _mm256_add_epi64( x, _mm256_blend_epi32( _mm256_permute4x64_epi64( x, _MM_SHUFFLE( 2, 1, 0, 0 ) ), zero, 0x03 ) );
+    x = _mm256_add_epi64( x, _mm256_blend_epi32( _mm256_permute4x64_epi64( x, _MM_SHUFFLE( 1, 0, 0, 0 ) ), zero, 0x0F ) );
+    return x;
+}
+
+template <bool Descending>
+SweepResult sweepAvx2( const std::uint64_t* qty, std::size_t n, std::uint64_t budget )
+{
+    const __m256i limit = _mm256_set1_epi64x( static_cast<long long>( budget ) );
+    __m256i carry       = _mm256_setzero_si256();
+    SweepResult result;
+
+    for ( ; result.levels + 4 <= n; result.levels += 4 )
+    {
+        __m256i x;
+        if constexpr ( Descending )
+        {
+            // Levels qty[-i-3 .. -i], reversed so lane 0 is the best.
+            x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( qty - result.levels - 3 ) );
+            x = _mm256_permute4x64_epi64( x, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+        }
+        else
+        {
+            x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( qty + result.levels ) );
+        }
+        x = _mm256_add_epi64( prefixSum4( x ), carry );
+
+        const int over = _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpgt_epi64( x, limit ) ) );
+        if ( over != 0 )
+        {
+            const auto lane = static_cast<std::size_t>( std::countr_zero( static_cast<unsigned>( over ) ) );
+            alignas( 32 ) std::uint64_t lanes[4];
+            _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), x );
+            result.volume = lane == 0 ? static_cast<std::uint64_t>( _mm256_extract_epi64( carry, 0 ) ) : lanes[lane - 1];
+            result.levels += lane;
+            return result;
+        }
+        carry = _mm256_permute4x64_epi64( x, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+    }
+
+    result.volume = static_cast<std::uint64_t>( _mm256_extract_epi64( carry, 0 ) );
+    return sweepScalar( qty, Descending ? -1 : 1, n, budget, result );
+}
+#endif
+
+}  // namespace
+
+SweepResult MarketMicroStructure::sweepAscending( const std::uint64_t* qty, std::size_t n, std::uint64_t budget )
+{
+#if defined( __AVX2__ )
+    return sweepAvx2<false>( qty, n, budget );
+#else
+    return sweepScalar( qty, 1, n, budget, {} );
+#endif
+}
+
+SweepResult MarketMicroStructure::sweepDescending( const std::uint64_t* qty, std::size_t n, std::uint64_t budget )
+{
+#if defined( __AVX2__ )
+    return sweepAvx2<true>( qty, n, budget );
+#else
+    return sweepScalar( qty, -1, n, budget, {} );
+#endif
+}
@@ -2,85 +2,710 @@
 // MarketMicrostructureEngine — Simulation Entry Point
 //
 // Drives a high-throughput market simulation by generating random NewOrder
-// and CancelOrder events, pushing them through a lock-free SPSC ring buffer
-// (HPRingBuffer) to an asynchronous EventLoop that dispatches them into
-// the HFTToolset MatchingEngine.
+// and CancelOrder events (RandomFlow: batched, vectorized draws; or the
+// clustered HawkesFlow with --flow=hawkes), pushing them through a
+// lock-free SPSC ring buffer (HPRingBuffer) to an asynchronous EventLoop
+// that dispatches them into the HFTToolset MatchingEngine.
 //
 // Simulation parameters:
 //   - Symbols:   XAUUSD, EURUSD, BTCUSD
 //   - Events:    1,000,000 (configurable via MAX_TRY)
 //   - Buffer:    8,192 slots, heap-allocated (~9 MB)
 //   - Timing:    Measured end-to-end via HFTToolset ScopeTimer
+//
+// Before the timed region a warm-up phase pushes a synthetic flow through
+// the same ring and EventLoop (cycling every ring slot and the matching code
+// paths), then resets engine state; the simulation engine's arenas are
+// pre-faulted up front and --mlock pins all pages.
+//
+// Run with --help for the optional flags (event count, engine, warm-up,
+// core pinning, host-jitter calibration).
 // ============================================================================
 
 #include <common/types.h>
+#include <hawkes_flow.h>
+#include <hot_standby.h>
+#include <jitter_detector.h>
+#include <journal.h>
+#include <l3_replay.h>
 #include <market/market_data_publisher.h>
 #include <market/matching_engine.h>
+#include <memory_accounting.h>
+#include <partitioned_replay.h>
+#include <random_flow.h>
+#include <scaling_bench.h>
+#include <scenario_loader.h>
+#include <sharded_engine.h>
 #include <sim_event_loop.h>
+#include <sim_matching_engine.h>
+#include <sim_options.h>
+#include <sim_universe.h>
+#include <thread_affinity.h>
+#include <tsc_clock.h>
+#include <warmup.h>
 
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
 #include <random>
 #include <ScopeTimer.hpp>
+#include <string_view>
+#include <type_traits>
 
 using namespace MarketMicroStructure;
 using namespace HFTToolset;
 
-const std::array<Symbol, 3> Symbols = { Symbol( "XAUUSD" ), Symbol( "EURUSD" ), Symbol( "BTCUSD" ) };
+const std::array<Symbol, 3> Symbols                = { Symbol( "XAUUSD" ), Symbol( "EURUSD" ), Symbol( "BTCUSD" ) };
+constexpr std::array<std::string_view, 3> SymbolNames = { "XAUUSD", "EURUSD", "BTCUSD" };
+
+void reportMemory( std::ostream& out, const ProcessMemoryStats& baseline )
+{
+    MemoryRegistry::instance().report( out );
+    reportProcessMemory( out, baseline );
+}
+
+/// @brief Pushes the synthetic warm-up flow through the real ring and loop,
+/// waits until the engine has consumed all of it, then resets engine state.
+template <typename Engine>
+void warmUp( Engine& engine, BasicEventLoop<Engine>& loop, EventLoopBuffer& events, const SimOptions& options )
+{
+    WarmupFlow flow( Symbols, options.warmup_events );
+
+    std::uint64_t pushed = loop.processedCount();
+    EngineEvent ev;
+    while ( flow.next( ev ) )
+    {
+        while ( !events.push( ev ) )
+            ;
+        ++pushed;
+    }
+
+    while ( loop.processedCount() != pushed )
+        ;
+
+    // The flow cancels every id it issued; the simulation engine can also
+    // drop the emptied levels and rewind its (already faulted) arenas.
+    if constexpr ( std::is_same_v<Engine, SimMatchingEngine> )
+    {
+        engine.endSession();
+    }
+}
+
+/// @brief The generator that feeds the timed region, and its seed.
+struct FlowSource
+{
+    std::uint64_t seed{ 0 };
+    std::optional<HawkesParams> hawkes;  ///< Set for --flow=hawkes
+};
+
+/// @brief Hands @p count events from @p flow to @p push (the ring, or the
+/// shard router), stamping each one as it goes in.  With @p pacing, a
+/// Hawkes event is held back until its simulated time has elapsed since the
+/// first push, so bursts hit the engine as bursts.  Every DriftSampleEvents
+/// events the clock's drift is sampled; that never re-anchors, so the
+/// threads stamping with the same clock are unaffected.
+template <typename Flow, typename Push>
+void produce( Flow& flow, Push&& push, std::uint64_t count, TscClock& clock, bool pacing )
+{
+    constexpr uint64_t DriftSampleEvents = 65'536;
+
+    const Timestamp start = clock.now();
+    EngineEvent ev;
+
+    uint64_t MAX_TRY{ count };
+    while ( MAX_TRY > 0 )
+    {
+        flow.next( ev );
+        if constexpr ( std::is_same_v<Flow, HawkesFlow> )
+        {
+            while ( pacing && clock.now() - start < flow.time() )
+                ;
+        }
+        ev.event_time = clock.now();
+        push( ev );
+        MAX_TRY--;
+        if ( MAX_TRY % DriftSampleEvents == 0 )
+        {
+            clock.sampleDrift();
+        }
+    }
+}
+
+/// @brief "[Symbols]" line: a symbol table as a reader thread sees it.
+void printSymbols( std::ostream& out, const SymbolTable& table )
+{
+    out << "[Symbols] version=" << table.version << " listed=";
+    const char* sep = "";
+    for ( SymbolIndex i = 0; i < table.size; ++i )
+    {
+        const auto& entry = table.entry( i );
+        if ( entry.listed )
+        {
+            out << sep << entry.name;
+            sep = ",";
+        }
+    }
+    out << " delisted=";
+    sep = "";
+    for ( SymbolIndex i = 0; i < table.size; ++i )
+    {
+        const auto& entry = table.entry( i );
+        if ( !entry.listed )
+        {
+            out << sep << entry.name << "(dropped=" << entry.dropped_orders << ")";
+            sep = ",";
+        }
+    }
+    out << "\n";
+}
+
+/// @brief Optional sinks fed during the timed region of the single-engine
+/// simulation.  Warm-up traffic reaches none of them: a standby runs the
+/// same warm-up flow itself.
+struct SessionOutputs
+{
+    ReplicaPublisher* replica{ nullptr };  ///< Hot standby feed, producer thread
+    JournalWriter* events{ nullptr };      ///< Inbound event journal, producer thread
+    JournalWriter* trades{ nullptr };      ///< Trade journal, matching thread (simulation engine only)
+};
+
+template <typename Engine>
+void runSimulation( Engine& engine, const SimOptions& options, TscClock& event_clock, const FlowSource& flow,
+                    const SessionOutputs& outputs = {} )
+{
+    BasicEventLoop<Engine> loop( engine );
+    loop.setPrefetchDistance( options.prefetch_distance );
+
+    // Heap-allocate: EventLoopBuffer is ~9 MB (EngineEvent x 8192 slots)
+    // and must not live on the stack to avoid stack overflow.
+    auto events = makeEventLoopBuffer();
+    auto task   = loop.runAsync( *events, options.loop_core );
+
+    if ( options.warmup_events > 0 )
+    {
+        NScopeTimers::start( "Warm-Up" );
+        warmUp( engine, loop, *events, options );
+        NScopeTimers::endAndLog( "Warm-Up" );
+    }
+
+    // The loop is idle after warm-up, and the first timed push publishes the
+    // callback, and any re-anchored clock, to it.
+    event_clock.checkDrift();
+    if constexpr ( std::is_same_v<Engine, SimMatchingEngine> )
+    {
+        if ( outputs.trades != nullptr )
+        {
+            engine.onTrade( [trades = outputs.trades]( const SimTrade& trade ) { trades->append( trade ); } );
+        }
+    }
+
+    // Symbols listed during the run are in the flow from the start: their
+    // orders are rejected until they are listed, and again once delisted.
+    std::vector<Symbol> flow_symbols( Symbols.begin(), Symbols.end() );
+    for ( const SymbolChange& change : options.symbol_changes )
+    {
+        const Symbol symbol( change.name.c_str() );
+        if ( change.list && std::find( flow_symbols.begin(), flow_symbols.end(), symbol ) == flow_symbols.end() )
+        {
+            flow_symbols.push_back( symbol );
+        }
+    }
+
+    // Control fences count every event the loop has dispatched, warm-up
+    // included; the loop is idle here, so that is everything pushed so far.
+    const std::uint64_t fence_base = loop.processedCount();
+    std::size_t posted             = 0;
+    const auto post_changes        = [&]( std::uint64_t pushed )
+    {
+        for ( ; posted < options.symbol_changes.size() && options.symbol_changes[posted].at_event <= pushed; ++posted )
+        {
+            const SymbolChange& change = options.symbol_changes[posted];
+            const auto control =
+                SymbolControl::make( change.list ? SymbolControl::Kind::List : SymbolControl::Kind::Delist, change.name, fence_base + pushed );
+            while ( !loop.postControl( control ) )
+                ;
+        }
+    };
+
+    NScopeTimers::start( "Main Duration" );
+
+    auto push = [&events, &outputs, &post_changes, sequence = std::uint64_t{ 0 }]( const EngineEvent& ev ) mutable
+    {
+        post_changes( sequence );
+        if ( outputs.replica != nullptr )
+        {
+            outputs.replica->publish( ev );
+        }
+        if ( outputs.events != nullptr )
+        {
+            outputs.events->append( SequencedEvent{ sequence, ev } );
+        }
+        ++sequence;
+        while ( !events->push( ev ) )
+            ;
+    };
+    if ( flow.hawkes )
+    {
+        HawkesFlow hawkes( flow_symbols, *flow.hawkes, flow.seed );
+        produce( hawkes, push, options.events, event_clock, options.flow_pacing );
+    }
+    else
+    {
+        RandomFlow uniform( flow_symbols, flow.seed );
+        produce( uniform, push, options.events, event_clock, false );
+    }
+
+    while ( !events->empty() )
+        ;
 
-EngineEvent buildEvent()
+    // Changes scheduled at or past the last event run once it is matched.
+    // The table is read here, on the producer thread, while the loop runs.
+    if ( !options.symbol_changes.empty() )
+    {
+        post_changes( options.events );
+        while ( loop.controlsApplied() != posted )
+            ;
+        if constexpr ( std::is_same_v<Engine, SimMatchingEngine> )
+        {
+            printSymbols( std::cout, *engine.symbolTable() );
+        }
+    }
+
+    loop.setWaitForDone();
+
+    task.join();
+
+    NScopeTimers::endAndLog( "Main Duration" );
+
+    if ( outputs.replica != nullptr )
+    {
+        outputs.replica->close();
+    }
+}
+
+/// @brief The simulation on a ShardedEngine: the producer routes each event
+/// to its symbol's shard, and shards rebalance as the flow runs.  There is
+/// no warm-up phase; the shard engines are pre-faulted instead.
+void runShardedSimulation( const SimOptions& options, TscClock& event_clock, const FlowSource& flow )
 {
-    static std::mt19937 rng( std::random_device{}() );
-
-    std::uniform_int_distribution<int> symbol_dist( 0, Symbols.size() - 1 );
-    std::uniform_int_distribution<int> type_dist( 0, 1 );
-    std::uniform_int_distribution<int> price_dist( 90, 110 );
-    std::uniform_int_distribution<int> qty_dist( 1, 500 );
-    std::uniform_int_distribution<OrderId> order_id_dist( 1, 10'000 );
-
-    int type = type_dist( rng );
-
-    if ( type == 0 )
-    {
-        auto the_order = Order{ .id             = order_id_dist( rng ),
-                                .trader_id      = order_id_dist( rng ),
-                                .symbol         = Symbols[symbol_dist( rng )],
-                                .side           = ( rng() % 2 == 0 ? Side::Buy : Side::Sell ),
-                                .type           = OrderType::Limit,
-                                .tif            = TimeInForce::Day,
-                                .price          = price_dist( rng ),
-                                .quantity       = qty_dist( rng ),
-                                .filled_qty     = qty_dist( rng ),
-                                .status         = OrderStatus::New,
-                                .submit_time    = 0,
-                                .accept_time    = 0,
-                                .queue_position = 0,
-                                .cl_ord_id      = {} };
-        Timestamp ts   = std::chrono::steady_clock::now().time_since_epoch().count();
-
-        // New order event
-        EngineEvent ev;
-        ev.type       = EventType::NewOrder;
-        ev.order      = the_order;
-        ev.event_time = ts;
-        return ev;
+    ShardedEngine engine( event_clock, { .shards           = options.shards,
+                                         .first_core       = options.loop_core,
+                                         .prefault_orders  = options.prefault_orders,
+                                         .rebalance_window = options.rebalance_window } );
+    for ( auto name : SymbolNames )
+    {
+        engine.add_symbol( name );
+    }
+
+    // Runs on the merger thread; read only after stop() has joined it.
+    struct SequencedTally
+    {
+        std::uint64_t reports{ 0 };
+        std::uint64_t trades{ 0 };
+        std::uint64_t next{ 0 };  ///< Sequence number the next report must carry
+        bool in_order{ true };
+    } tally;
+    if ( options.sequenced )
+    {
+        const int merger_core = options.loop_core < 0 ? -1 : options.loop_core + static_cast<int>( options.shards );
+        engine.sequenceOutputs(
+            [&tally]( const ReplayOutput& out )
+            {
+                if ( out.kind == ReplayOutputKind::Trade )
+                {
+                    ++tally.trades;
+                    tally.in_order = tally.in_order && out.event + 1 == tally.next;
+                    return;
+                }
+                tally.in_order = tally.in_order && out.event == tally.next;
+                tally.next     = out.event + 1;
+                ++tally.reports;
+            },
+            merger_core );
+    }
+    engine.start();
+
+    NScopeTimers::start( "Main Duration" );
+
+    const auto route = [&engine]( const EngineEvent& ev ) { engine.route( ev ); };
+    if ( flow.hawkes )
+    {
+        HawkesFlow hawkes( Symbols, *flow.hawkes, flow.seed );
+        produce( hawkes, route, options.events, event_clock, options.flow_pacing );
     }
     else
     {
-        Timestamp ts = std::chrono::steady_clock::now().time_since_epoch().count();
+        RandomFlow uniform( Symbols, flow.seed );
+        produce( uniform, route, options.events, event_clock, false );
+    }
+    engine.stop();
+
+    NScopeTimers::endAndLog( "Main Duration" );
+    engine.report( std::cout );
+    if ( options.sequenced )
+    {
+        std::cout << "[Sequencer] events=" << options.events << " reports=" << tally.reports << " trades=" << tally.trades
+                  << " in_order=" << tally.in_order << "\n";
+    }
+}
+
+/// @brief --replica: mirrors the primary publishing @p options.replica
+/// until it closes or fails.  The engine is set up and warmed exactly like
+/// the primary's simulation engine, so the books match order for order.
+int runHotStandby( const SimOptions& options, TscClock& clock )
+{
+    SimMatchingEngine engine( clock );
+    for ( auto name : SymbolNames )
+    {
+        engine.add_symbol( name );
+    }
+    engine.reserve( options.prefault_orders );
+
+    // Same flow and the same counters as the primary's warm-up, applied
+    // directly: there is no ring on this side.
+    WarmupFlow warmup( Symbols, options.warmup_events );
+    EngineEvent ev;
+    while ( warmup.next( ev ) )
+    {
+        if ( ev.type == EventType::NewOrder )
+        {
+            engine.process_new_order( ev.order );
+        }
+        else
+        {
+            engine.process_cancel( ev.cancel );
+        }
+    }
+    engine.endSession();
+
+    auto segment = ReplicationSegment::attach( options.replica, options.replication.attach_timeout );
+    if ( !segment )
+    {
+        std::cerr << segment.error() << "\n";
+        return 1;
+    }
+    HotStandby standby( std::move( *segment ), engine, options.replication );
+    const auto result = standby.run();
+    if ( !result )
+    {
+        std::cerr << result.error() << "\n";
+        return 1;
+    }
+    printStandby( std::cout, *result, bookDigest( engine, SymbolNames ) );
+    return 0;
+}
+
+/// @brief "[BookFile]" line: where the books live and what they hold.
+void printBookFile( std::ostream& out, const char* when, const SimMatchingEngine& engine, const MappedBookFile& file )
+{
+    std::size_t resting = 0;
+    for ( SymbolIndex s = 0; s < engine.symbolCount(); ++s )
+    {
+        resting += engine.book( s ).restingOrders();
+    }
+    out << "[BookFile] " << when << " path=" << file.path() << " restored=" << file.restored() << " symbols=" << engine.symbolCount()
+        << " resting=" << resting << " used_bytes=" << file.usedBytes() << " capacity=" << file.capacity()
+        << " live_block_bytes=" << file.liveBlockBytes() << " requested_bytes=" << file.liveRequestedBytes()
+        << " rounding_waste_bytes=" << file.liveBlockBytes() - file.liveRequestedBytes() << " storage_rejects=" << engine.stats().storage_rejects
+        << " digest=" << std::hex << bookDigest( engine, SymbolNames ) << std::dec << "\n";
+}
+
+/// @brief --journal-info: decodes and checks every block of a journal.
+int runJournalInfo( const std::string& path )
+{
+    auto reader = JournalReader::open( path );
+    if ( !reader )
+    {
+        std::cerr << reader.error() << "\n";
+        return 1;
+    }
+
+    std::uint64_t stored_bytes = 0;
+    std::size_t bad_blocks     = 0;
+    for ( std::size_t b = 0; b < reader->index().size(); ++b )
+    {
+        stored_bytes += reader->index()[b].stored_bytes;
+        if ( const auto block = reader->block( b ); !block )
+        {
+            std::cerr << block.error() << "\n";
+            ++bad_blocks;
+        }
+    }
+    const std::uint64_t raw_bytes = reader->records() * reader->recordSize();
+    std::cout << "[JournalInfo] kind=" << ( reader->kind() == JournalKind::Events ? "events" : "trades" ) << " records=" << reader->records()
+              << " record_bytes=" << reader->recordSize() << " blocks=" << reader->index().size() << " raw_bytes=" << raw_bytes
+              << " stored_bytes=" << stored_bytes << " ratio=" << ( raw_bytes != 0 ? static_cast<double>( stored_bytes ) / static_cast<double>( raw_bytes ) : 0.0 )
+              << " recovered=" << reader->recovered() << " bad_blocks=" << bad_blocks << "\n";
+    return bad_blocks == 0 ? 0 : 2;
+}
+
+/// @brief --journal-find: an order-id or time lookup through the journal's
+/// sidecar index.  Prints at most MaxPrinted matches, then the summary.
+int runJournalFind( const SimOptions& options )
+{
+    constexpr std::size_t MaxPrinted = 1000;
+
+    auto reader = JournalReader::open( options.journal_find );
+    if ( !reader )
+    {
+        std::cerr << reader.error() << "\n";
+        return 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    auto index       = JournalIndex::open( options.journal_find, *reader );
+    if ( !index )
+    {
+        std::cerr << index.error() << "\n";
+        return 1;
+    }
+    const auto loaded  = std::chrono::steady_clock::now();
+    const auto matches = options.find_order ? index->findOrder( *reader, *options.find_order )
+                                            : index->findTime( *reader, *options.find_from, options.find_to );
+    const auto found   = std::chrono::steady_clock::now();
+    if ( !matches )
+    {
+        std::cerr << matches.error() << "\n";
+        return 1;
+    }
 
-        // Cancel event
-        EngineEvent ev;
-        ev.type            = EventType::CancelOrder;
-        ev.cancel.order_id = order_id_dist( rng );
-        ev.event_time      = ts;
-        return ev;
+    for ( std::size_t i = 0; i < std::min( matches->records.size(), MaxPrinted ); ++i )
+    {
+        const std::uint64_t record = matches->records[i];
+        if ( reader->kind() == JournalKind::Events )
+        {
+            SequencedEvent sequenced;
+            (void)reader->read( record, &sequenced );
+            const EngineEvent& ev = sequenced.event;
+            const bool is_new     = ev.type == EventType::NewOrder;
+            std::cout << "[JournalEvent] record=" << record << " sequence=" << sequenced.sequence << " type=" << ( is_new ? "new" : "cancel" )
+                      << " order=" << ( is_new ? ev.order.id : ev.cancel.order_id ) << " time=" << ev.event_time;
+            if ( is_new )
+            {
+                std::cout << " side=" << ( ev.order.side == Side::Buy ? "buy" : "sell" ) << " price=" << ev.order.price
+                          << " qty=" << ev.order.quantity;
+            }
+            std::cout << "\n";
+        }
+        else
+        {
+            SimTrade trade;
+            (void)reader->read( record, &trade );
+            std::cout << "[JournalTrade] record=" << record << " maker=" << trade.maker_id << " taker=" << trade.taker_id << " price=" << trade.price
+                      << " qty=" << trade.quantity << " time=" << trade.time << "\n";
+        }
     }
+    std::cout << "[JournalFind] matches=" << matches->records.size() << " blocks_decoded=" << matches->blocks_decoded
+              << " blocks_total=" << index->blocks() << " index_rebuilt=" << index->rebuilt()
+              << " load_us=" << std::chrono::duration<double, std::micro>( loaded - start ).count()
+              << " lookup_us=" << std::chrono::duration<double, std::micro>( found - loaded ).count() << "\n";
+    return 0;
 }
 
-int main()
+int main( int argc, char** argv )
 {
+    const auto parsed = parseSimOptions( argc, argv );
+    if ( !parsed )
+    {
+        std::cerr << parsed.error();
+        return 1;
+    }
+    const SimOptions& options = *parsed;
+    if ( options.show_help )
+    {
+        std::cout << simOptionsUsage( argv[0] );
+        return 0;
+    }
+
+    // Event timestamps, the simulation-layer engines' clock, the benchmarks'
+    // timers and the jitter detector all use this one calibration;
+    // HFTToolset's engine takes its own Clock type.
+    TscClock tsc_clock;
+    std::cout << "[TscClock] invariant_tsc=" << tsc_clock.usingTsc() << " ticks_per_ns=" << tsc_clock.ticksPerNs() << "\n";
+
+    // Calibrate the exact cores the simulation will use, concurrently, so a
+    // noisy host is visible before any engine number is trusted.
+    const JitterDetector jitter( { .duration = options.calibrate_duration, .gap_threshold = options.calibrate_threshold }, tsc_clock );
+    const std::array<int, 2> sim_cores = { options.producer_core, options.loop_core };
+    if ( options.calibrate )
+    {
+        jitter.print( std::cout, "before", jitter.measureConcurrently( sim_cores ) );
+    }
+
+    pinCurrentThreadToCore( options.producer_core );
+
+    if ( options.lock_memory )
+    {
+        if ( auto locked = lockAllMemory(); !locked )
+        {
+            std::cerr << locked.error() << "\n";
+        }
+    }
+
+    const auto memory_baseline = ProcessMemoryStats::sample();
+
     HFTToolset::Clock clock;
 
+    if ( options.shards > 0 && options.engine != EngineBackend::Sim )
+    {
+        std::cerr << "--shards moves books between engines and needs --engine=sim\n";
+        return 1;
+    }
+    if ( options.sequenced && options.shards == 0 )
+    {
+        std::cerr << "--sequenced merges shard outputs and needs --shards\n";
+        return 1;
+    }
+    if ( !options.replica_publish.empty() && ( options.engine != EngineBackend::Sim || options.shards > 0 ) )
+    {
+        std::cerr << "--replica-publish mirrors a single simulation engine and needs --engine=sim without --shards\n";
+        return 1;
+    }
+
+    if ( !options.journal_dir.empty() && ( options.engine != EngineBackend::Sim || options.shards > 0 ) )
+    {
+        std::cerr << "--journal records a single simulation engine and needs --engine=sim without --shards\n";
+        return 1;
+    }
+
+    if ( !options.book_file.empty() && ( options.engine != EngineBackend::Sim || options.shards > 0 || !options.replica_publish.empty() ) )
+    {
+        std::cerr << "--book-file keeps a single simulation engine and needs --engine=sim without --shards or --replica-publish\n";
+        return 1;
+    }
+
+    // The standby and the event journal only see events, so neither could
+    // follow a listing, and a book file rebuilt from that journal would miss it.
+    if ( !options.symbol_changes.empty()
+         && ( options.engine != EngineBackend::Sim || options.shards > 0 || !options.replica_publish.empty() || !options.journal_dir.empty()
+              || !options.book_file.empty() ) )
+    {
+        std::cerr << "--list / --delist run on a single simulation engine's loop and need --engine=sim without --shards, --replica-publish, "
+                     "--journal or --book-file\n";
+        return 1;
+    }
+
+    if ( !options.replica.empty() )
+    {
+        return runHotStandby( options, tsc_clock );
+    }
+
+    if ( !options.journal_info.empty() )
+    {
+        return runJournalInfo( options.journal_info );
+    }
+
+    if ( !options.journal_find.empty() )
+    {
+        if ( options.find_order.has_value() == options.find_from.has_value() )
+        {
+            std::cerr << "--journal-find needs exactly one of --find-order and --find-time\n";
+            return 1;
+        }
+        return runJournalFind( options );
+    }
+
+    if ( !options.l3_replay.empty() )
+    {
+        const auto feed = loadL3Feed( options.l3_replay );
+        if ( !feed )
+        {
+            std::cerr << feed.error() << "\n";
+            return 1;
+        }
+        const auto result = replayL3( *feed, options.replay_threads );
+        printL3Replay( std::cout, *feed, result );
+
+        // The rebuilt books must load into the simulation engine as they are.
+        SimMatchingEngine engine( tsc_clock );
+        const std::size_t failed = restoreL3Books( engine, *feed, result );
+        std::cout << "[L3Replay] restored_symbols=" << feed->symbols.size() - failed << " restore_failures=" << failed << "\n";
+        return result.mismatches() == 0 && failed == 0 ? 0 : 2;
+    }
+
+    if ( !options.partitioned_replay.empty() )
+    {
+        const auto scenario = loadScenario( options.partitioned_replay );
+        if ( !scenario )
+        {
+            std::cerr << scenario.error() << "\n";
+            return 1;
+        }
+        const auto result = replayPartitioned( *scenario, { .partitions = options.replay_threads, .first_core = options.replay_first_core } );
+        printPartitionedReplay( std::cout, *scenario, result );
+        return 0;
+    }
+
+    if ( options.stress_bench )
+    {
+        if ( options.engine == EngineBackend::Fixed )
+        {
+            std::cerr << "--stress needs add_symbol(); --engine=fixed has a compile-time symbol set\n";
+            return 1;
+        }
+        if ( options.engine == EngineBackend::Sim )
+        {
+            runStressBenchmark<SimMatchingEngine>( options.stress_names, options.stress, options.stress_save_dir, clock, tsc_clock, std::cout );
+        }
+        else
+        {
+            runStressBenchmark<HFTToolset::MatchingEngine>( options.stress_names, options.stress, options.stress_save_dir, clock, tsc_clock,
+                                                            std::cout );
+        }
+        return 0;
+    }
+
+    if ( options.scaling_bench )
+    {
+        if ( options.engine == EngineBackend::Fixed )
+        {
+            std::cerr << "--scaling-bench needs add_symbol(); --engine=fixed has a compile-time symbol set\n";
+            return 1;
+        }
+        if ( options.engine == EngineBackend::Sim )
+        {
+            runScalingBenchmark<SimMatchingEngine>( options.scaling, clock, tsc_clock, std::cout );
+        }
+        else
+        {
+            runScalingBenchmark<HFTToolset::MatchingEngine>( options.scaling, clock, tsc_clock, std::cout );
+        }
+        return 0;
+    }
+
+    // Print the seed so any run's order flow can be replayed with --seed.
+    std::random_device entropy;
+    FlowSource flow;
+    flow.seed = options.seed != 0 ? options.seed : ( std::uint64_t{ entropy() } << 32 ) | entropy();
+    std::cout << "[Flow] seed=" << flow.seed << "\n";
+
+    if ( options.flow == FlowModel::Hawkes )
+    {
+        flow.hawkes.emplace();
+        if ( !options.flow_scenario.empty() )
+        {
+            const auto scenario = loadScenario( options.flow_scenario );
+            if ( !scenario )
+            {
+                std::cerr << scenario.error() << "\n";
+                return 1;
+            }
+            const auto fit = fitHawkes( *scenario );
+            if ( !fit )
+            {
+                std::cerr << fit.error() << "\n";
+                return 1;
+            }
+            flow.hawkes = fit->params;
+            std::cout << "[Hawkes] fitted events=" << fit->events << " log_likelihood=" << fit->log_likelihood << "\n";
+        }
+        const HawkesParams& params = *flow.hawkes;
+        std::cout << "[Hawkes] beta=" << params.beta << " mu=" << params.mu[0] << "," << params.mu[1] << "," << params.mu[2]
+                  << " branching=" << params.branchingRatio() << "\n";
+    }
+
     // Subscribe to market data streams
     // md_pub.onTopOfBook([](const TopOfBook& tob) {
     //     // std::cout << "[TOB] " << tob.symbol
@@ -97,39 +722,169 @@ int main()
     //     //           << "\n";
     // });
 
-    HFTToolset::MatchingEngine engine( clock );
-    engine.add_symbol( "XAUUSD" );
-    engine.add_symbol( "EURUSD" );
-    engine.add_symbol( "BTCUSD" );
-
-    EventLoop loop( engine );
+    if ( options.shards > 0 )
+    {
+        runShardedSimulation( options, tsc_clock, flow );
 
-    // Heap-allocate: EventLoopBuffer is ~9 MB (EngineEvent x 8192 slots)
-    // and must not live on the stack to avoid stack overflow.
-    auto events = makeEventLoopBuffer();
-    auto task   = loop.runAsync( *events );
+        if ( options.memory_report )
+        {
+            reportMemory( std::cout, memory_baseline );
+        }
+    }
+    else if ( options.engine == EngineBackend::Fixed )
+    {
+        // Books and pools are inline std::arrays: too large for the stack.
+        auto engine = std::make_unique<SimUniverseEngine>( tsc_clock );
 
-    NScopeTimers::start( "Main Duration" );
+        runSimulation( *engine, options, tsc_clock, flow );
 
-    uint64_t MAX_TRY{ 1'000'000 };
-    // uint64_t MAX_TRY{ 5 };
-    while ( MAX_TRY > 0 )
+        if ( options.memory_report )
+        {
+            std::cout << "[Memory] fixed_universe bytes=" << sizeof( SimUniverseEngine ) << "\n";
+            reportMemory( std::cout, memory_baseline );
+        }
+    }
+    else if ( options.engine == EngineBackend::Sim )
     {
-        if ( events->push( buildEvent() ) )
+        // Declared first: the engine's books may live in it.
+        std::unique_ptr<MappedBookFile> book_file;
+        SimMatchingEngine engine( tsc_clock );
+        if ( !options.book_file.empty() )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            auto opened      = MappedBookFile::open( options.book_file, SimMatchingEngine::persistentLayout(), options.book_file_mb << 20 );
+            if ( !opened )
+            {
+                std::cerr << opened.error() << "\n";
+                return 1;
+            }
+            book_file = std::move( *opened );
+            if ( const auto attached = engine.attach( *book_file ); !attached )
+            {
+                std::cerr << attached.error() << "\n";
+                return 1;
+            }
+            const auto attached_at = std::chrono::steady_clock::now();
+            printBookFile( std::cout, "attach", engine, *book_file );
+            std::cout << "[BookFile] attach_us=" << std::chrono::duration<double, std::micro>( attached_at - start ).count() << "\n";
+        }
+        // A restored file brings its own symbols, delistings included.
+        if ( !book_file || !book_file->restored() )
         {
-            MAX_TRY--;
-            continue;
+            for ( auto name : SymbolNames )
+            {
+                engine.add_symbol( name );
+            }
+        }
+        const std::size_t reserved = engine.reserve( options.prefault_orders );
+        if ( book_file && reserved < options.prefault_orders )
+        {
+            std::cout << "[BookFile] reserved_orders=" << reserved << " requested=" << options.prefault_orders << " (file too small for the full reservation)\n";
+        }
+
+        std::optional<ReplicaPublisher> replica;
+        if ( !options.replica_publish.empty() )
+        {
+            auto opened = ReplicaPublisher::open( options.replica_publish, options.replication );
+            if ( !opened )
+            {
+                std::cerr << opened.error() << "\n";
+                return 1;
+            }
+            replica.emplace( std::move( *opened ) );
+        }
+
+        std::unique_ptr<JournalWriter> event_journal;
+        std::unique_ptr<JournalWriter> trade_journal;
+        if ( !options.journal_dir.empty() )
+        {
+            std::error_code ec;
+            std::filesystem::create_directories( options.journal_dir, ec );
+            auto events = JournalWriter::open( options.journal_dir + "/events.journal", JournalKind::Events, sizeof( SequencedEvent ), options.journal );
+            auto trades = JournalWriter::open( options.journal_dir + "/trades.journal", JournalKind::Trades, sizeof( SimTrade ), options.journal );
+            if ( !events || !trades )
+            {
+                std::cerr << ( events ? trades.error() : events.error() ) << "\n";
+                return 1;
+            }
+            event_journal = std::move( *events );
+            trade_journal = std::move( *trades );
+        }
+
+        // Warm-up ends in endSession(), which would empty restored books.
+        SimOptions session_options = options;
+        if ( book_file && book_file->restored() )
+        {
+            session_options.warmup_events = 0;
+        }
+        runSimulation( engine, session_options, tsc_clock, flow,
+                       { .replica = replica ? &*replica : nullptr, .events = event_journal.get(), .trades = trade_journal.get() } );
+
+        for ( auto* journal : { event_journal.get(), trade_journal.get() } )
+        {
+            if ( journal == nullptr )
+            {
+                continue;
+            }
+            if ( const auto closed = journal->close(); !closed )
+            {
+                std::cerr << closed.error() << "\n";
+                return 1;
+            }
+            printJournalStats( std::cout, journal == event_journal.get() ? "events" : "trades", journal->stats() );
+        }
+
+        if ( replica )
+        {
+            std::cout << "[Primary] published=" << replica->published() << " stalls=" << replica->stalls() << " standby_lost=" << replica->lost()
+                      << " digest=" << std::hex << bookDigest( engine, SymbolNames ) << std::dec << "\n";
+        }
+
+        if ( options.memory_report )
+        {
+            engine.reportMemory( std::cout );
+            reportMemory( std::cout, memory_baseline );
+        }
+
+        if ( book_file )
+        {
+            // The books stay in the file for the next run.
+            book_file->flush();
+            printBookFile( std::cout, "close", engine, *book_file );
+        }
+        else
+        {
+            // Per-symbol arenas are rewound, not freed order by order.
+            NScopeTimers::start( "Session Teardown" );
+            engine.endSession();
+            NScopeTimers::endAndLog( "Session Teardown" );
         }
     }
+    else
+    {
+        HFTToolset::MatchingEngine engine( clock );
+        engine.add_symbol( "XAUUSD" );
+        engine.add_symbol( "EURUSD" );
+        engine.add_symbol( "BTCUSD" );
 
-    while ( !events->empty() )
-        ;
+        runSimulation( engine, options, tsc_clock, flow );
 
-    loop.setWaitForDone();
+        if ( options.memory_report )
+        {
+            reportMemory( std::cout, memory_baseline );
+        }
+    }
 
-    task.join();
+    // Every thread reading the clock has been joined: safe to re-anchor.
+    const auto drift = tsc_clock.checkDrift();
+    const auto& stats = tsc_clock.driftStats();
+    std::cout << "[TscClock] drift_ns=" << drift.drift_ns << " recalibrated=" << drift.recalibrated << " checks=" << stats.checks
+              << " max_drift_ns=" << stats.max_drift_ns << " recalibrations=" << stats.recalibrations << "\n";
 
-    NScopeTimers::endAndLog( "Main Duration" );
+    if ( options.calibrate )
+    {
+        jitter.print( std::cout, "after", jitter.measureConcurrently( sim_cores ) );
+    }
 
     return 0;
 }
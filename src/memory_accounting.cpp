@@ -0,0 +1,65 @@
+// ============================================================================
+// MarketMicrostructureEngine — Memory Accounting Implementation
+// ============================================================================
+
+#include <memory_accounting.h>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/resource.h>
+#endif
+
+using namespace MarketMicroStructure;
+
+MemoryRegistry& MemoryRegistry::instance()
+{
+    static MemoryRegistry registry;
+    return registry;
+}
+
+MemoryAccount& MemoryRegistry::account( std::string_view name )
+{
+    std::lock_guard lock( mutex_ );
+    if ( const auto it = by_name_.find( name ); it != by_name_.end() )
+    {
+        return *it->second;
+    }
+    MemoryAccount& account = accounts_.emplace_back( std::string( name ) );
+    by_name_.emplace( account.name(), &account );
+    return account;
+}
+
+void MemoryRegistry::report( std::ostream& out ) const
+{
+    std::lock_guard lock( mutex_ );
+    for ( const auto& account : accounts_ )
+    {
+        out << "[Memory] " << account.name() << " live_bytes=" << account.liveBytes() << " peak_bytes=" << account.peakBytes()
+            << " allocations=" << account.allocations() << "\n";
+    }
+}
+
+ProcessMemoryStats ProcessMemoryStats::sample()
+{
+    ProcessMemoryStats stats;
+#if defined( __unix__ ) || defined( __APPLE__ )
+    rusage usage{};
+    if ( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+#if defined( __APPLE__ )
+        stats.peak_rss_bytes = static_cast<std::size_t>( usage.ru_maxrss );  // bytes on macOS
+#else
+        stats.peak_rss_bytes = static_cast<std::size_t>( usage.ru_maxrss ) * 1024;  // KiB on Linux
+#endif
+        stats.minor_faults = static_cast<std::uint64_t>( usage.ru_minflt );
+        stats.major_faults = static_cast<std::uint64_t>( usage.ru_majflt );
+    }
+#endif
+    return stats;
+}
+
+void MarketMicroStructure::reportProcessMemory( std::ostream& out, const ProcessMemoryStats& baseline )
+{
+    const auto now = ProcessMemoryStats::sample();
+    out << "[Memory] process peak_rss_bytes=" << now.peak_rss_bytes << " minor_faults=" << ( now.minor_faults - baseline.minor_faults )
+        << " major_faults=" << ( now.major_faults - baseline.major_faults ) << "\n";
+}
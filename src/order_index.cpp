@@ -0,0 +1,137 @@
+// ============================================================================
+// MarketMicrostructureEngine — Order Index Implementation
+// ============================================================================
+
+#include <order_index.h>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+using namespace MarketMicroStructure;
+
+OrderIndex::OrderIndex( BookStorage storage, std::size_t initial_capacity ) : storage_( storage ), slots_( storage ), filter_( storage )
+{
+    slots_.assign( std::bit_ceil( std::max<std::size_t>( initial_capacity, 16 ) ), Slot{} );
+    mask_ = slots_.size() - 1;
+    filter_.reset( slots_.size() * FilterCountersPerSlot );
+}
+
+void OrderIndex::rebind( BookStorage storage )
+{
+    storage_ = storage;
+    slots_.rebind( storage );
+    filter_.rebind( storage );
+}
+
+bool OrderIndex::insert( OrderKey id, Entry entry )
+{
+    if ( ( size_ + 1 ) * 2 > slots_.size() )
+    {
+        grow();
+    }
+
+    for ( std::size_t i = home( id );; i = ( i + 1 ) & mask_ )
+    {
+        Slot& slot = slots_[i];
+        if ( !slot.occupied() )
+        {
+            slot.id    = id;
+            slot.entry = entry;
+            filter_.add( id );
+            ++size_;
+            return true;
+        }
+        if ( slot.id == id )
+        {
+            return false;
+        }
+    }
+}
+
+OrderIndex::Entry* OrderIndex::find( OrderKey id )
+{
+    for ( std::size_t i = home( id );; i = ( i + 1 ) & mask_ )
+    {
+        Slot& slot = slots_[i];
+        if ( !slot.occupied() )
+        {
+            return nullptr;
+        }
+        if ( slot.id == id )
+        {
+            return &slot.entry;
+        }
+    }
+}
+
+bool OrderIndex::erase( OrderKey id )
+{
+    std::size_t i = home( id );
+    for ( ;; i = ( i + 1 ) & mask_ )
+    {
+        if ( !slots_[i].occupied() )
+        {
+            return false;
+        }
+        if ( slots_[i].id == id )
+        {
+            break;
+        }
+    }
+
+    // Backward-shift: pull later members of the probe run into the hole so
+    // lookups never need tombstones.
+    for ( std::size_t j = ( i + 1 ) & mask_;; j = ( j + 1 ) & mask_ )
+    {
+        if ( !slots_[j].occupied() )
+        {
+            break;
+        }
+        const std::size_t h = home( slots_[j].id );
+        // Move j into the hole at i unless its home lies cyclically in (i, j].
+        const bool stays = ( i <= j ) ? ( i < h && h <= j ) : ( i < h || h <= j );
+        if ( !stays )
+        {
+            slots_[i] = slots_[j];
+            i         = j;
+        }
+    }
+
+    slots_[i] = Slot{};
+    filter_.remove( id );
+    --size_;
+    return true;
+}
+
+void OrderIndex::clear()
+{
+    std::fill( slots_.begin(), slots_.end(), Slot{} );
+    filter_.reset( slots_.size() * FilterCountersPerSlot );
+    size_ = 0;
+}
+
+void OrderIndex::reserve( std::size_t entries )
+{
+    while ( entries * 2 > slots_.size() )
+    {
+        grow();
+    }
+}
+
+void OrderIndex::grow()
+{
+    BookVector<Slot> old( storage_ );
+    old.assign( slots_.size() * 2, Slot{} );
+    old.swap( slots_ );
+    mask_ = slots_.size() - 1;
+    size_ = 0;
+    filter_.reset( slots_.size() * FilterCountersPerSlot );  // refilled by insert() below
+    for ( const Slot& slot : old )
+    {
+        if ( slot.occupied() )
+        {
+            insert( slot.id, slot.entry );
+        }
+    }
+}
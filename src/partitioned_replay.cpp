@@ -0,0 +1,273 @@
+// ============================================================================
+// MarketMicrostructureEngine — Symbol-Partitioned Parallel Replay Implementation
+//
+// Each partition thread builds its engine itself, after pinning, so the
+// books and arenas are first-touched on the partition's own core.  Outputs
+// collect in a per-partition vector already in (time, event, seq) order.
+// Scenario times never decrease and each partition walks its events in
+// feed order.
+// ============================================================================
+
+#include <partitioned_replay.h>
+#include <sim_matching_engine.h>
+#include <thread_affinity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <span>
+#include <thread>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+/// @brief now() is whatever the partition loop last set: the recorded time
+/// of the event being replayed.
+struct ReplayClock
+{
+    Timestamp current{ 0 };
+    Timestamp now() const { return current; }
+};
+
+bool outputBefore( const ReplayOutput& a, const ReplayOutput& b )
+{
+    if ( a.time != b.time )
+    {
+        return a.time < b.time;
+    }
+    if ( a.event != b.event )
+    {
+        return a.event < b.event;
+    }
+    return a.seq < b.seq;
+}
+
+/// @brief Greedy longest-first assignment of symbols to the partition with
+/// the fewest events so far.  Ties go to the lower index, so the split only
+/// depends on the scenario.
+std::vector<std::size_t> assignSymbols( const std::vector<std::size_t>& symbol_events, std::size_t partitions,
+                                        std::vector<std::size_t>& partition_events )
+{
+    std::vector<std::size_t> order( symbol_events.size() );
+    std::iota( order.begin(), order.end(), std::size_t{ 0 } );
+    std::stable_sort( order.begin(), order.end(), [&]( std::size_t a, std::size_t b ) { return symbol_events[a] > symbol_events[b]; } );
+
+    std::vector<std::size_t> owner( symbol_events.size() );
+    partition_events.assign( partitions, 0 );
+    for ( const std::size_t s : order )
+    {
+        const auto lightest = static_cast<std::size_t>(
+            std::min_element( partition_events.begin(), partition_events.end() ) - partition_events.begin() );
+        owner[s] = lightest;
+        partition_events[lightest] += symbol_events[s];
+    }
+    return owner;
+}
+
+std::vector<ReplayOutput> replayPartition( const Scenario& scenario, std::span<const std::size_t> events, int core )
+{
+    pinCurrentThreadToCore( core );
+
+    ReplayClock clock;
+    SimMatchingEngine engine( clock );
+    std::vector<Symbol> symbols( scenario.symbols.size() );
+    std::vector<bool> added( scenario.symbols.size(), false );
+    std::vector<std::uint32_t> scenario_symbol;  // engine SymbolIndex -> scenario symbol
+    for ( const std::size_t i : events )
+    {
+        const std::uint32_t s = scenario.events[i].symbol;
+        if ( !added[s] )
+        {
+            added[s]   = true;
+            symbols[s] = Symbol( scenario.symbols[s].c_str() );
+            engine.add_symbol( scenario.symbols[s] );
+            scenario_symbol.push_back( s );
+        }
+    }
+
+    std::vector<ReplayOutput> out;
+    out.reserve( events.size() + events.size() / 4 );
+
+    std::uint64_t event = 0;
+    std::uint32_t seq   = 0;
+    engine.onTrade(
+        [&]( const SimTrade& trade )
+        {
+            out.push_back( { .time     = trade.time,
+                             .event    = event,
+                             .seq      = ++seq,
+                             .symbol   = scenario_symbol[trade.symbol],
+                             .kind     = ReplayOutputKind::Trade,
+                             .order_id = trade.taker_id,
+                             .maker_id = trade.maker_id,
+                             .price    = trade.price,
+                             .quantity = trade.quantity } );
+        } );
+
+    for ( const std::size_t i : events )
+    {
+        const ScenarioEvent& ev = scenario.events[i];
+        clock.current           = ev.time;
+        event                   = i;
+        seq                     = 0;
+
+        // The execution report is seq 0 but only known once the engine
+        // returns; reserve its slot ahead of any fills.
+        const std::size_t report = out.size();
+        out.push_back( { .time = ev.time, .event = i, .seq = 0, .symbol = ev.symbol, .order_id = ev.order_id } );
+
+        const EngineStats before       = engine.stats();
+        const EngineEvent engine_event = toEngineEvent( ev, symbols[ev.symbol] );
+        if ( engine_event.type == EventType::NewOrder )
+        {
+            engine.process_new_order( engine_event.order );
+            out[report].kind     = engine.stats().accepted != before.accepted ? ReplayOutputKind::Accepted : ReplayOutputKind::Rejected;
+            out[report].price    = ev.price;
+            out[report].quantity = ev.quantity;
+        }
+        else
+        {
+            engine.process_cancel( engine_event.cancel );
+            out[report].kind = engine.stats().cancelled != before.cancelled ? ReplayOutputKind::Cancelled : ReplayOutputKind::CancelRejected;
+        }
+    }
+    return out;
+}
+
+/// @brief k-way merge over the partition streams with a binary heap of
+/// cursors, one per non-empty partition.
+std::vector<ReplayOutput> mergeOutputs( const std::vector<std::vector<ReplayOutput>>& streams )
+{
+    struct Cursor
+    {
+        const ReplayOutput* next;
+        const ReplayOutput* end;
+    };
+    // std heap functions keep the largest on top, so invert the order.
+    const auto later = []( const Cursor& a, const Cursor& b ) { return outputBefore( *b.next, *a.next ); };
+
+    std::size_t total = 0;
+    std::vector<Cursor> heap;
+    for ( const auto& stream : streams )
+    {
+        total += stream.size();
+        if ( !stream.empty() )
+        {
+            heap.push_back( { stream.data(), stream.data() + stream.size() } );
+        }
+    }
+    std::make_heap( heap.begin(), heap.end(), later );
+
+    std::vector<ReplayOutput> merged;
+    merged.reserve( total );
+    while ( !heap.empty() )
+    {
+        std::pop_heap( heap.begin(), heap.end(), later );
+        Cursor& top = heap.back();
+        merged.push_back( *top.next );
+        if ( ++top.next == top.end )
+        {
+            heap.pop_back();
+        }
+        else
+        {
+            std::push_heap( heap.begin(), heap.end(), later );
+        }
+    }
+    return merged;
+}
+
+}  // namespace
+
+std::uint64_t PartitionedReplayResult::checksum() const
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    const auto mix     = [&hash]( std::uint64_t value )
+    {
+        for ( int b = 0; b < 8; ++b, value >>= 8 )
+        {
+            hash = ( hash ^ ( value & 0xff ) ) * 0x100000001b3ULL;
+        }
+    };
+    for ( const auto& o : outputs )
+    {
+        mix( o.time );
+        mix( o.event );
+        mix( o.seq );
+        mix( o.symbol );
+        mix( static_cast<std::uint64_t>( o.kind ) );
+        mix( o.order_id );
+        mix( o.maker_id );
+        mix( static_cast<std::uint64_t>( o.price ) );
+        mix( static_cast<std::uint64_t>( o.quantity ) );
+    }
+    return hash;
+}
+
+PartitionedReplayResult MarketMicroStructure::replayPartitioned( const Scenario& scenario, const PartitionedReplayConfig& config )
+{
+    PartitionedReplayResult result;
+    const std::size_t symbol_count = scenario.symbols.size();
+    if ( symbol_count == 0 )
+    {
+        return result;
+    }
+
+    std::size_t partitions = config.partitions != 0 ? config.partitions : std::max( 1u, std::thread::hardware_concurrency() );
+    partitions             = std::min( partitions, symbol_count );
+
+    std::vector<std::size_t> symbol_events( symbol_count, 0 );
+    for ( const auto& ev : scenario.events )
+    {
+        ++symbol_events[ev.symbol];
+    }
+    const auto owner = assignSymbols( symbol_events, partitions, result.partition_events );
+
+    std::vector<std::vector<std::size_t>> events( partitions );
+    for ( std::size_t p = 0; p < partitions; ++p )
+    {
+        events[p].reserve( result.partition_events[p] );
+    }
+    for ( std::size_t i = 0; i < scenario.events.size(); ++i )
+    {
+        events[owner[scenario.events[i].symbol]].push_back( i );
+    }
+
+    std::vector<std::vector<ReplayOutput>> streams( partitions );
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve( partitions );
+        for ( std::size_t p = 0; p < partitions; ++p )
+        {
+            const int core = config.first_core < 0 ? -1 : config.first_core + static_cast<int>( p );
+            pool.emplace_back( [&, p, core] { streams[p] = replayPartition( scenario, events[p], core ); } );
+        }
+    }
+    const auto replayed = std::chrono::steady_clock::now();
+
+    result.outputs = mergeOutputs( streams );
+    const auto merged = std::chrono::steady_clock::now();
+
+    result.replay_ns = static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( replayed - start ).count() );
+    result.merge_ns  = static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( merged - replayed ).count() );
+    result.trades    = static_cast<std::uint64_t>(
+        std::count_if( result.outputs.begin(), result.outputs.end(), []( const ReplayOutput& o ) { return o.kind == ReplayOutputKind::Trade; } ) );
+    return result;
+}
+
+void MarketMicroStructure::printPartitionedReplay( std::ostream& out, const Scenario& scenario, const PartitionedReplayResult& result )
+{
+    const auto [lightest, heaviest] = std::minmax_element( result.partition_events.begin(), result.partition_events.end() );
+    const double seconds            = static_cast<double>( result.replay_ns ) * 1e-9;
+
+    out << "[PartitionedReplay] symbols=" << scenario.symbols.size() << " events=" << scenario.events.size()
+        << " partitions=" << result.partition_events.size() << " partition_events_min=" << ( result.partition_events.empty() ? 0 : *lightest )
+        << " partition_events_max=" << ( result.partition_events.empty() ? 0 : *heaviest ) << " replay_ns=" << result.replay_ns
+        << " merge_ns=" << result.merge_ns
+        << " events_per_sec=" << static_cast<std::uint64_t>( seconds > 0.0 ? static_cast<double>( scenario.events.size() ) / seconds : 0.0 )
+        << " outputs=" << result.outputs.size() << " trades=" << result.trades << " checksum=" << std::hex << result.checksum() << std::dec
+        << "\n";
+}
@@ -0,0 +1,68 @@
+// ============================================================================
+// MarketMicrostructureEngine — Random Order Flow Implementation
+// ============================================================================
+
+#include <random_flow.h>
+
+#include <cassert>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+RandomFlow::RandomFlow( std::span<const Symbol> symbols, std::uint64_t seed, std::uint64_t stream )
+    : symbols_( symbols ), rng_( seed, stream ), id_symbols_( MaxId + 1, NotIssued )
+{
+    assert( !symbols_.empty() );
+}
+
+void RandomFlow::refill()
+{
+    rng_.fillBounded( kinds_.data(), BatchSize, 2 );
+    rng_.fillBounded( symbol_indices_.data(), BatchSize, static_cast<std::uint32_t>( symbols_.size() ) );
+    rng_.fillBounded( sides_.data(), BatchSize, 2 );
+    rng_.fillUniform( prices_.data(), BatchSize, MinPrice, MaxPrice );
+    rng_.fillUniform( quantities_.data(), BatchSize, MinQty, MaxQty );
+    rng_.fillUniform( filled_.data(), BatchSize, MinQty, MaxQty );
+    rng_.fillUniform( ids_.data(), BatchSize, MinId, MaxId );
+    rng_.fillUniform( trader_ids_.data(), BatchSize, MinId, MaxId );
+    cursor_ = 0;
+}
+
+void RandomFlow::next( EngineEvent& ev )
+{
+    if ( cursor_ == BatchSize )
+    {
+        refill();
+    }
+    const std::size_t i = cursor_++;
+
+    ev = EngineEvent{};
+    if ( kinds_[i] == 0 )
+    {
+        ev.type  = EventType::NewOrder;
+        ev.order = Order{ .id             = static_cast<OrderId>( ids_[i] ),
+                          .trader_id      = static_cast<TraderId>( trader_ids_[i] ),
+                          .symbol         = symbols_[symbol_indices_[i]],
+                          .side           = sides_[i] == 0 ? Side::Buy : Side::Sell,
+                          .type           = OrderType::Limit,
+                          .tif            = TimeInForce::Day,
+                          .price          = prices_[i],
+                          .quantity       = quantities_[i],
+                          .filled_qty     = filled_[i],
+                          .status         = OrderStatus::New,
+                          .submit_time    = 0,
+                          .accept_time    = 0,
+                          .queue_position = 0,
+                          .cl_ord_id      = {} };
+        id_symbols_[ids_[i]] = symbol_indices_[i];
+    }
+    else
+    {
+        ev.type            = EventType::CancelOrder;
+        ev.cancel.order_id = static_cast<OrderId>( ids_[i] );
+        if ( id_symbols_[ids_[i]] != NotIssued )
+        {
+            ev.cancel.symbol = symbols_[id_symbols_[ids_[i]]];
+        }
+    }
+}
@@ -0,0 +1,218 @@
+// ============================================================================
+// MarketMicrostructureEngine — Scaling Benchmark Implementation
+//
+// Every operation is timed individually in TscClock ticks (converted to ns
+// with the same calibration the simulation uses).  Random choices are drawn
+// before the timed section so only the engine call is inside the
+// measurement.  The clock's drift is checked between configurations, while
+// no engine is reading it.
+// ============================================================================
+
+#include <market/matching_engine.h>
+#include <memory_accounting.h>
+#include <scaling_bench.h>
+#include <sim_matching_engine.h>
+#include <tsc_clock.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <type_traits>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+constexpr OrderPrice MidPrice    = 10'000;
+constexpr OrderQty RestingQty    = 1'000'000;  // deep enough that one-lot matches never exhaust an order
+constexpr std::size_t MaxSymbols = 100'000;
+
+/// @brief One resting order the benchmark knows about.
+struct LiveOrder
+{
+    OrderId id;
+    std::uint32_t symbol;
+    Side side;
+    OrderPrice price;
+};
+
+ScalingResult summarize( std::vector<std::uint64_t>& ticks, double ticks_per_ns )
+{
+    ScalingResult r;
+    r.samples = ticks.size();
+    if ( ticks.empty() )
+    {
+        return r;
+    }
+    std::sort( ticks.begin(), ticks.end() );
+    auto at = [&]( double q )
+    {
+        const auto idx = static_cast<std::size_t>( q * static_cast<double>( ticks.size() - 1 ) );
+        return static_cast<std::uint64_t>( static_cast<double>( ticks[idx] ) / ticks_per_ns );
+    };
+
+    double sum = 0.0;
+    for ( auto t : ticks )
+    {
+        sum += static_cast<double>( t );
+    }
+    r.p50_ns  = at( 0.50 );
+    r.p90_ns  = at( 0.90 );
+    r.p99_ns  = at( 0.99 );
+    r.p999_ns = at( 0.999 );
+    r.max_ns  = at( 1.0 );
+    r.mean_ns = sum / static_cast<double>( ticks.size() ) / ticks_per_ns;
+    return r;
+}
+
+Order makeOrder( OrderId id, const Symbol& symbol, Side side, OrderType type, OrderPrice price, OrderQty qty )
+{
+    Order order{};
+    order.id       = id;
+    order.symbol   = symbol;
+    order.side     = side;
+    order.type     = type;
+    order.tif      = TimeInForce::Day;
+    order.price    = price;
+    order.quantity = qty;
+    order.status   = OrderStatus::New;
+    return order;
+}
+
+/// @brief HFTToolset::MatchingEngine needs an HFTToolset::Clock; the sim
+/// engines stamp with the process's TscClock like the simulation does.
+template <typename Engine>
+Engine makeEngine( Clock& clock, TscClock& tsc )
+{
+    if constexpr ( std::is_same_v<Engine, MatchingEngine> )
+    {
+        return Engine( clock );
+    }
+    else
+    {
+        return Engine( tsc );
+    }
+}
+
+template <typename Engine>
+std::vector<ScalingResult> runConfiguration( const ScalingBenchConfig& config, Clock& clock, TscClock& tsc, std::size_t symbol_count,
+                                             std::size_t depth )
+{
+    const double ticks_per_ns = tsc.ticksPerNs();
+    std::mt19937_64 rng( config.seed );
+
+    const std::uint64_t build_start = tsc.ticks();
+
+    Engine engine = makeEngine<Engine>( clock, tsc );
+    std::vector<Symbol> symbols;
+    symbols.reserve( symbol_count );
+    for ( std::size_t s = 0; s < symbol_count; ++s )
+    {
+        const std::string name = "SYM" + std::to_string( s );
+        engine.add_symbol( name.c_str() );
+        symbols.emplace_back( name.c_str() );
+    }
+    if constexpr ( requires { engine.reserve( depth ); } )
+    {
+        engine.reserve( depth / symbol_count + 1 );
+    }
+
+    // Populate: round-robin over symbols, alternating sides, cycling through
+    // levels_per_side price levels on each side of the mid.
+    std::vector<LiveOrder> live;
+    live.reserve( depth );
+    OrderId next_id = 1;
+    for ( std::size_t i = 0; i < depth; ++i )
+    {
+        const auto symbol      = static_cast<std::uint32_t>( i % symbol_count );
+        const Side side        = ( i / symbol_count ) % 2 == 0 ? Side::Buy : Side::Sell;
+        const auto level       = static_cast<OrderPrice>( 1 + ( i / ( 2 * symbol_count ) ) % config.levels_per_side );
+        const OrderPrice price = side == Side::Buy ? MidPrice - level : MidPrice + level;
+        engine.process_new_order( makeOrder( next_id, symbols[symbol], side, OrderType::Limit, price, RestingQty ) );
+        live.push_back( { next_id++, symbol, side, price } );
+    }
+
+    const std::uint64_t build_ns = static_cast<std::uint64_t>( static_cast<double>( tsc.ticks() - build_start ) / ticks_per_ns );
+
+    std::vector<std::uint64_t> add_ticks, cancel_ticks, match_ticks;
+    add_ticks.reserve( config.samples );
+    cancel_ticks.reserve( config.samples );
+    match_ticks.reserve( config.samples );
+    std::uniform_int_distribution<std::size_t> pick( 0, depth - 1 );
+
+    for ( std::size_t n = 0; n < config.samples; ++n )
+    {
+        // Cancel a random resting order, then replace it on the same symbol,
+        // side and price so the depth profile is unchanged.
+        LiveOrder& victim = live[pick( rng )];
+        CancelRequest cancel{};
+        cancel.order_id = victim.id;
+
+        std::uint64_t t0 = tsc.ticks();
+        engine.process_cancel( cancel );
+        cancel_ticks.push_back( tsc.ticks() - t0 );
+
+        victim.id       = next_id++;
+        const Order add = makeOrder( victim.id, symbols[victim.symbol], victim.side, OrderType::Limit, victim.price, RestingQty );
+        t0              = tsc.ticks();
+        engine.process_new_order( add );
+        add_ticks.push_back( tsc.ticks() - t0 );
+
+        // Marketable one-lot order against a side known to have liquidity.
+        const LiveOrder& target = live[pick( rng )];
+        const Side aggressor    = target.side == Side::Buy ? Side::Sell : Side::Buy;
+        const Order take        = makeOrder( next_id++, symbols[target.symbol], aggressor, OrderType::Market, target.price, 1 );
+        t0                      = tsc.ticks();
+        engine.process_new_order( take );
+        match_ticks.push_back( tsc.ticks() - t0 );
+    }
+
+    std::vector<ScalingResult> results;
+    for ( auto [op, ticks] : { std::pair<std::string_view, std::vector<std::uint64_t>*>{ "add", &add_ticks },
+                               { "cancel", &cancel_ticks },
+                               { "match", &match_ticks } } )
+    {
+        ScalingResult r = summarize( *ticks, ticks_per_ns );
+        r.symbols       = symbol_count;
+        r.depth         = depth;
+        r.op            = op;
+        r.build_ns      = build_ns;
+        results.push_back( r );
+    }
+    return results;
+}
+
+}  // namespace
+
+template <typename Engine>
+std::vector<ScalingResult> MarketMicroStructure::runScalingBenchmark( const ScalingBenchConfig& config, Clock& clock, TscClock& tsc,
+                                                                      std::ostream& out )
+{
+    std::vector<ScalingResult> all;
+    for ( std::size_t depth : config.depths )
+    {
+        for ( std::size_t symbol_count : config.symbol_counts )
+        {
+            if ( depth == 0 || symbol_count == 0 || symbol_count > MaxSymbols )
+            {
+                continue;
+            }
+            for ( const auto& r : runConfiguration<Engine>( config, clock, tsc, symbol_count, depth ) )
+            {
+                out << "[Scaling] symbols=" << r.symbols << " depth=" << r.depth << " op=" << r.op << " samples=" << r.samples
+                    << " mean_ns=" << static_cast<std::uint64_t>( r.mean_ns ) << " p50_ns=" << r.p50_ns << " p90_ns=" << r.p90_ns
+                    << " p99_ns=" << r.p99_ns << " p999_ns=" << r.p999_ns << " max_ns=" << r.max_ns << " build_ns=" << r.build_ns
+                    << " peak_rss_bytes=" << ProcessMemoryStats::sample().peak_rss_bytes << "\n";
+                all.push_back( r );
+            }
+            tsc.checkDrift();
+        }
+    }
+    return all;
+}
+
+template std::vector<ScalingResult> MarketMicroStructure::runScalingBenchmark<MatchingEngine>( const ScalingBenchConfig&, Clock&, TscClock&,
+                                                                                                std::ostream& );
+template std::vector<ScalingResult> MarketMicroStructure::runScalingBenchmark<SimMatchingEngine>( const ScalingBenchConfig&, Clock&, TscClock&,
+                                                                                                std::ostream& );
@@ -0,0 +1,170 @@
+// ============================================================================
+// MarketMicrostructureEngine — Scenario Loader Implementation
+// ============================================================================
+
+#include <scenario_loader.h>
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+template <typename T>
+bool parseNumber( std::string_view text, T& out )
+{
+    const auto* end = text.data() + text.size();
+    auto [ptr, ec]  = std::from_chars( text.data(), end, out );
+    return ec == std::errc{} && ptr == end;
+}
+
+/// @brief Splits off the next whitespace-separated field of @p line.
+std::string_view nextField( std::string_view& line )
+{
+    const auto begin = line.find_first_not_of( " \t\r" );
+    if ( begin == std::string_view::npos )
+    {
+        line = {};
+        return {};
+    }
+    line             = line.substr( begin );
+    const auto end   = line.find_first_of( " \t\r" );
+    const auto field = line.substr( 0, end );
+    line             = end == std::string_view::npos ? std::string_view{} : line.substr( end );
+    return field;
+}
+
+bool parseKind( std::string_view text, ScenarioEventKind& out )
+{
+    if ( text.size() != 1 )
+    {
+        return false;
+    }
+    switch ( text[0] )
+    {
+    case 'A': out = ScenarioEventKind::Add; return true;
+    case 'X': out = ScenarioEventKind::Cancel; return true;
+    case 'T': out = ScenarioEventKind::Trade; return true;
+    default: return false;
+    }
+}
+
+bool parseSide( std::string_view text, Side& out )
+{
+    if ( text == "B" )
+    {
+        out = Side::Buy;
+        return true;
+    }
+    if ( text == "S" )
+    {
+        out = Side::Sell;
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+std::expected<Scenario, std::string> MarketMicroStructure::loadScenario( const std::string& path )
+{
+    std::ifstream in( path );
+    if ( !in )
+    {
+        return std::unexpected( "cannot open scenario '" + path + "'" );
+    }
+
+    Scenario scenario;
+    std::unordered_map<std::string, std::uint32_t> symbol_ids;
+
+    std::string text;
+    for ( std::size_t line_no = 1; std::getline( in, text ); ++line_no )
+    {
+        std::string_view line = text;
+        line                  = line.substr( 0, line.find( '#' ) );
+        if ( line.find_first_not_of( " \t\r" ) == std::string_view::npos )
+        {
+            continue;
+        }
+
+        ScenarioEvent ev;
+        const auto time   = nextField( line );
+        const auto kind   = nextField( line );
+        const auto symbol = nextField( line );
+        const auto side   = nextField( line );
+        const auto price  = nextField( line );
+        const auto qty    = nextField( line );
+        const auto id     = nextField( line );
+
+        const bool ok = parseNumber( time, ev.time ) && parseKind( kind, ev.kind ) && !symbol.empty() && parseSide( side, ev.side )
+                        && parseNumber( price, ev.price ) && parseNumber( qty, ev.quantity ) && parseNumber( id, ev.order_id )
+                        && nextField( line ).empty();
+        if ( !ok )
+        {
+            return std::unexpected( path + ":" + std::to_string( line_no ) + ": malformed scenario event" );
+        }
+        if ( !scenario.events.empty() && ev.time < scenario.events.back().time )
+        {
+            return std::unexpected( path + ":" + std::to_string( line_no ) + ": time goes backwards" );
+        }
+
+        const auto [it, inserted] = symbol_ids.try_emplace( std::string( symbol ), static_cast<std::uint32_t>( scenario.symbols.size() ) );
+        if ( inserted )
+        {
+            scenario.symbols.emplace_back( symbol );
+        }
+        ev.symbol = it->second;
+        scenario.events.push_back( ev );
+    }
+
+    return scenario;
+}
+
+std::expected<void, std::string> MarketMicroStructure::saveScenario( const std::string& path, const Scenario& scenario )
+{
+    std::ofstream out( path );
+    if ( !out )
+    {
+        return std::unexpected( "cannot create scenario '" + path + "'" );
+    }
+
+    static constexpr char Kinds[] = { 'A', 'X', 'T' };
+    for ( const auto& ev : scenario.events )
+    {
+        out << ev.time << ' ' << Kinds[static_cast<std::size_t>( ev.kind )] << ' ' << scenario.symbols[ev.symbol] << ' '
+            << ( ev.side == Side::Buy ? 'B' : 'S' ) << ' ' << ev.price << ' ' << ev.quantity << ' ' << ev.order_id << '\n';
+    }
+    if ( !out.flush() )
+    {
+        return std::unexpected( "failed writing scenario '" + path + "'" );
+    }
+    return {};
+}
+
+EngineEvent MarketMicroStructure::toEngineEvent( const ScenarioEvent& ev, const Symbol& symbol )
+{
+    EngineEvent out{};
+    if ( ev.kind == ScenarioEventKind::Cancel )
+    {
+        out.type            = EventType::CancelOrder;
+        out.cancel.order_id = ev.order_id;
+        out.cancel.symbol   = symbol;
+        return out;
+    }
+
+    const bool trade   = ev.kind == ScenarioEventKind::Trade;
+    out.type           = EventType::NewOrder;
+    out.order.id       = ev.order_id;
+    out.order.symbol   = symbol;
+    out.order.side     = ev.side;
+    out.order.type     = trade ? OrderType::Market : OrderType::Limit;
+    out.order.tif      = trade ? TimeInForce::IOC : TimeInForce::Day;
+    out.order.price    = ev.price;
+    out.order.quantity = ev.quantity;
+    out.order.status   = OrderStatus::New;
+    return out;
+}
@@ -0,0 +1,118 @@
+// ============================================================================
+// MarketMicrostructureEngine — Global Sequencer Implementation
+// ============================================================================
+
+#include <sequencer.h>
+#include <thread_affinity.h>
+
+#include <algorithm>
+#include <bit>
+
+using namespace MarketMicroStructure;
+
+SequenceMerger::SequenceMerger( std::vector<OutputRing*> rings, Sink sink )
+    : rings_( std::move( rings ) ), pending_( rings_.size() ), window_( InitialWindow ), sink_( std::move( sink ) )
+{
+}
+
+SequenceMerger::~SequenceMerger()
+{
+    if ( thread_.joinable() )
+    {
+        stopping_.store( true, std::memory_order_release );
+        thread_.join();
+    }
+}
+
+void SequenceMerger::start( int core )
+{
+    thread_ = std::thread(
+        [this, core]
+        {
+            pinCurrentThreadToCore( core );
+            run();
+        } );
+}
+
+void SequenceMerger::finish( std::uint64_t end )
+{
+    end_.store( end, std::memory_order_relaxed );
+    stopping_.store( true, std::memory_order_release );
+    if ( thread_.joinable() )
+    {
+        thread_.join();
+    }
+}
+
+void SequenceMerger::run()
+{
+    for ( ;; )
+    {
+        // Drain first, unconditionally: a shard must never wait on the
+        // merger, whatever sequence number the merger is waiting for.
+        for ( std::size_t s = 0; s < rings_.size(); ++s )
+        {
+            while ( auto out = rings_[s]->pop() )
+            {
+                collect( s, *out );
+            }
+        }
+
+        while ( emitNext() )
+            ;
+        if ( stopping_.load( std::memory_order_acquire ) && next_.load( std::memory_order_relaxed ) >= end_.load( std::memory_order_relaxed ) )
+        {
+            return;
+        }
+    }
+}
+
+void SequenceMerger::collect( std::size_t shard, const ReplayOutput& output )
+{
+    if ( output.kind == ReplayOutputKind::Trade )
+    {
+        pending_[shard].push_back( output );
+        return;
+    }
+
+    const std::uint64_t offset = output.event - next_.load( std::memory_order_relaxed );
+    if ( offset >= window_.size() )
+    {
+        growWindow( offset + 1 );
+    }
+    Slot& slot  = window_[output.event & ( window_.size() - 1 )];
+    slot.closed = true;
+    slot.report = output;
+    slot.fills.swap( pending_[shard] );
+}
+
+bool SequenceMerger::emitNext()
+{
+    const std::uint64_t next = next_.load( std::memory_order_relaxed );
+    Slot& slot               = window_[next & ( window_.size() - 1 )];
+    if ( !slot.closed )
+    {
+        return false;
+    }
+
+    sink_( slot.report );
+    for ( const ReplayOutput& fill : slot.fills )
+    {
+        sink_( fill );
+    }
+    slot.closed = false;
+    slot.fills.clear();  // keeps its buffer for the pending vector it is swapped with next
+    next_.store( next + 1, std::memory_order_release );
+    return true;
+}
+
+void SequenceMerger::growWindow( std::size_t slots )
+{
+    const std::uint64_t next = next_.load( std::memory_order_relaxed );
+    std::vector<Slot> grown( std::bit_ceil( std::max( slots, window_.size() * 2 ) ) );
+    for ( std::uint64_t s = next; s < next + window_.size(); ++s )
+    {
+        grown[s & ( grown.size() - 1 )] = std::move( window_[s & ( window_.size() - 1 )] );
+    }
+    window_.swap( grown );
+}
@@ -0,0 +1,534 @@
+// ============================================================================
+// MarketMicrostructureEngine — Sharded Engine Implementation
+//
+// A shard thread owns its engine outright; the producer only touches a
+// shard through its ring and its one-slot command mailbox.  The producer
+// never has more than one migration in flight, so a mailbox never holds two
+// commands at once.
+// ============================================================================
+
+#include <sharded_engine.h>
+#include <thread_affinity.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+ShardedEngine::ShardedEngine( ClockRef clock, ShardConfig config ) : clock_( clock ), config_( config )
+{
+    assert( config_.shards > 0 && "at least one shard" );
+    shards_.reserve( config_.shards );
+    for ( std::size_t s = 0; s < config_.shards; ++s )
+    {
+        shards_.push_back( std::make_unique<Shard>() );
+        shards_.back()->events = makeRingBuffer<SequencedEventRing>();
+    }
+}
+
+ShardedEngine::~ShardedEngine()
+{
+    stop();
+}
+
+SymbolIndex ShardedEngine::add_symbol( std::string_view name )
+{
+    assert( !started_ && "symbols are fixed once the shards run" );
+
+    const Symbol symbol( std::string( name ).c_str() );
+    const auto idx            = static_cast<SymbolIndex>( names_.size() );
+    const auto [it, inserted] = lookup_.try_emplace( symbol, idx );
+    if ( !inserted )
+    {
+        return it->second;
+    }
+    names_.emplace_back( name );
+    routes_.push_back( { .shard = idx % shards_.size() } );
+    return idx;
+}
+
+void ShardedEngine::sequenceOutputs( SequenceMerger::Sink sink, int core )
+{
+    assert( !started_ && "outputs are wired before the shards run" );
+
+    std::vector<OutputRing*> rings;
+    for ( const auto& shard : shards_ )
+    {
+        shard->outputs = makeRingBuffer<OutputRing>();
+        rings.push_back( shard->outputs.get() );
+    }
+    merger_      = std::make_unique<SequenceMerger>( std::move( rings ), std::move( sink ) );
+    merger_core_ = core;
+}
+
+void ShardedEngine::start()
+{
+    if ( started_ )
+    {
+        return;
+    }
+    started_ = true;
+    if ( merger_ )
+    {
+        merger_->start( merger_core_ );
+    }
+    for ( std::size_t s = 0; s < shards_.size(); ++s )
+    {
+        Shard& shard   = *shards_[s];
+        const int core = config_.first_core < 0 ? -1 : config_.first_core + static_cast<int>( s );
+        shard.thread   = std::thread( [this, &shard, core] { runShard( shard, core ); } );
+    }
+    for ( const auto& shard : shards_ )
+    {
+        while ( !shard->ready.load( std::memory_order_acquire ) )
+            ;
+    }
+}
+
+void ShardedEngine::runShard( Shard& shard, int core )
+{
+    pinCurrentThreadToCore( core );
+
+    shard.engine = std::make_unique<SimMatchingEngine>( clock_ );
+    for ( const auto& name : names_ )
+    {
+        shard.engine->add_symbol( name );
+    }
+    if ( config_.prefault_orders > 0 )
+    {
+        shard.engine->reserve( config_.prefault_orders );
+    }
+    shard.ready.store( true, std::memory_order_release );
+
+    SimMatchingEngine& engine = *shard.engine;
+    std::uint64_t processed   = 0;
+
+    // Fills go out as they happen, tagged with the event being dispatched;
+    // its report follows once the engine returns.  Both carry the event's
+    // own time rather than the engine clock's, so the merged stream does not
+    // depend on when a shard got to the event.
+    std::uint64_t sequence = 0;
+    Timestamp event_time   = 0;
+    std::uint32_t fills    = 0;
+    if ( shard.outputs )
+    {
+        engine.onTrade(
+            [&]( const SimTrade& trade )
+            {
+                publish( shard, { .time     = event_time,
+                                  .event    = sequence,
+                                  .seq      = ++fills,
+                                  .symbol   = trade.symbol,
+                                  .kind     = ReplayOutputKind::Trade,
+                                  .order_id = trade.taker_id,
+                                  .maker_id = trade.maker_id,
+                                  .price    = trade.price,
+                                  .quantity = trade.quantity } );
+            } );
+    }
+
+    for ( ;; )
+    {
+        // Pop first, then look at the mailbox: an event pushed after a
+        // command was posted makes that command visible here before the
+        // event is dispatched.
+        auto next = shard.events->pop();
+        serviceCommand( shard, processed );
+        if ( !next )
+        {
+            if ( shard.stopping.load( std::memory_order_acquire ) && shard.events->empty() )
+            {
+                return;
+            }
+            continue;
+        }
+
+        const EngineEvent& ev    = next->event;
+        const EngineStats before = engine.stats();
+        sequence                 = next->sequence;
+        event_time               = ev.event_time;
+        fills                    = 0;
+        if ( ev.type == EventType::NewOrder )
+        {
+            engine.process_new_order( ev.order );
+        }
+        else
+        {
+            engine.process_cancel( ev.cancel );
+        }
+
+        if ( shard.outputs )
+        {
+            const EngineStats& after = engine.stats();
+            const bool is_new        = ev.type == EventType::NewOrder;
+            ReplayOutputKind kind;
+            if ( is_new )
+            {
+                kind = after.accepted != before.accepted ? ReplayOutputKind::Accepted : ReplayOutputKind::Rejected;
+            }
+            else
+            {
+                kind = after.cancelled != before.cancelled ? ReplayOutputKind::Cancelled : ReplayOutputKind::CancelRejected;
+            }
+            const auto symbol = engine.findSymbol( is_new ? ev.order.symbol : ev.cancel.symbol );
+            publish( shard, { .time     = ev.event_time,
+                              .event    = sequence,
+                              .seq      = 0,
+                              .symbol   = symbol.value_or( NoSymbol ),
+                              .kind     = kind,
+                              .order_id = is_new ? ev.order.id : ev.cancel.order_id,
+                              .price    = is_new ? ev.order.price : OrderPrice{},
+                              .quantity = is_new ? ev.order.quantity : OrderQty{} } );
+        }
+        shard.processed.store( ++processed, std::memory_order_release );
+    }
+}
+
+void ShardedEngine::serviceCommand( Shard& shard, std::uint64_t processed )
+{
+    Command* command = shard.command.load( std::memory_order_acquire );
+    if ( !command || command->fence > processed )
+    {
+        return;
+    }
+
+    switch ( command->kind )
+    {
+    case Command::Kind::Snapshot:
+        command->state = shard.engine->exportSymbol( command->symbol );
+        break;
+    case Command::Kind::Restore:
+        command->restored = shard.engine->restoreSymbol( command->symbol, command->state );
+        break;
+    case Command::Kind::Drop:
+        shard.engine->extractSymbol( command->symbol );
+        break;
+    }
+    shard.command.store( nullptr, std::memory_order_relaxed );
+    command->done.store( true, std::memory_order_release );
+}
+
+void ShardedEngine::post( Shard& shard, Command& command )
+{
+    assert( shard.command.load( std::memory_order_relaxed ) == nullptr && "one command per shard at a time" );
+    command.fence = shard.pushed;
+    shard.command.store( &command, std::memory_order_release );
+}
+
+void ShardedEngine::publish( Shard& shard, const ReplayOutput& output )
+{
+    // The merger drains every ring continuously, so this only waits out a
+    // momentary burst.
+    while ( !shard.outputs->push( output ) )
+        ;
+}
+
+void ShardedEngine::push( Shard& shard, const SequencedEvent& ev )
+{
+    while ( !shard.events->push( ev ) )
+        ;
+    ++shard.pushed;
+}
+
+SymbolIndex ShardedEngine::symbolFor( const EngineEvent& ev ) const
+{
+    const Symbol& symbol = ev.type == EventType::NewOrder ? ev.order.symbol : ev.cancel.symbol;
+    const auto it        = lookup_.find( symbol );
+    return it == lookup_.end() ? NoSymbol : it->second;
+}
+
+void ShardedEngine::route( const EngineEvent& ev )
+{
+    // The sequencer: arrival order is the order of record.
+    const SequencedEvent sequenced{ routed_++, ev };
+    const SymbolIndex idx = symbolFor( ev );
+    if ( idx == NoSymbol )
+    {
+        push( *shards_[sequenced.sequence % shards_.size()], sequenced );
+        return;
+    }
+
+    Route& route          = routes_[idx];
+    ++route.routed;
+    ++route.window;
+    if ( migration_ && migration_->record.symbol == idx && migration_->stage != Migration::Stage::Drop )
+    {
+        migration_->held.push_back( sequenced );
+    }
+    else
+    {
+        push( *shards_[route.shard], sequenced );
+    }
+
+    if ( migration_ )
+    {
+        advanceMigration();
+    }
+    if ( config_.rebalance_window > 0 && ++window_events_ >= config_.rebalance_window )
+    {
+        rebalance();
+        window_events_ = 0;
+        for ( Route& r : routes_ )
+        {
+            r.window = 0;
+        }
+    }
+}
+
+bool ShardedEngine::migrate( SymbolIndex symbol, std::size_t to )
+{
+    if ( migration_ || symbol >= routes_.size() || to >= shards_.size() || routes_[symbol].shard == to )
+    {
+        return false;
+    }
+
+    migration_                  = std::make_unique<Migration>();
+    migration_->record          = { .symbol = symbol, .from = routes_[symbol].shard, .to = to, .at_event = routed_ };
+    migration_->snapshot.kind   = Command::Kind::Snapshot;
+    migration_->snapshot.symbol = symbol;
+    migration_->restore.kind    = Command::Kind::Restore;
+    migration_->restore.symbol  = symbol;
+    migration_->drop.kind       = Command::Kind::Drop;
+    migration_->drop.symbol     = symbol;
+    post( *shards_[migration_->record.from], migration_->snapshot );
+    return true;
+}
+
+void ShardedEngine::advanceMigration()
+{
+    Migration& m = *migration_;
+    switch ( m.stage )
+    {
+    case Migration::Stage::Snapshot:
+        if ( !m.snapshot.done.load( std::memory_order_acquire ) )
+        {
+            return;
+        }
+        // Transfer: the old shard still holds the book, so a failed
+        // restore costs nothing but the held events' wait.
+        m.restore.state = std::move( m.snapshot.state );
+        m.record.orders = m.restore.state.orders.size();
+        post( *shards_[m.record.to], m.restore );
+        m.stage = Migration::Stage::Restore;
+        [[fallthrough]];
+
+    case Migration::Stage::Restore:
+        if ( !m.restore.done.load( std::memory_order_acquire ) )
+        {
+            return;
+        }
+        m.record.restored = m.restore.restored;
+        m.record.held     = m.held.size();
+        if ( !m.record.restored )
+        {
+            // An id collided on the new shard: the symbol stays where it
+            // is, and its held events follow everything pushed before.
+            for ( const SequencedEvent& ev : m.held )
+            {
+                push( *shards_[m.record.from], ev );
+            }
+            finishMigration();
+            return;
+        }
+
+        // Resume on the new shard; the old copy is dropped behind it.
+        routes_[m.record.symbol].shard = m.record.to;
+        for ( const SequencedEvent& ev : m.held )
+        {
+            push( *shards_[m.record.to], ev );
+        }
+        m.held.clear();
+        post( *shards_[m.record.from], m.drop );
+        m.stage = Migration::Stage::Drop;
+        [[fallthrough]];
+
+    case Migration::Stage::Drop:
+        // The commands live in the Migration, so the drop must have run
+        // before the Migration can go.
+        if ( m.drop.done.load( std::memory_order_acquire ) )
+        {
+            finishMigration();
+        }
+        return;
+    }
+}
+
+void ShardedEngine::finishMigration()
+{
+    history_.push_back( migration_->record );
+    migration_.reset();
+}
+
+void ShardedEngine::rebalance()
+{
+    if ( migration_ || shards_.size() < 2 )
+    {
+        return;
+    }
+
+    std::vector<std::uint64_t> load( shards_.size(), 0 );
+    std::uint64_t total = 0;
+    for ( const Route& r : routes_ )
+    {
+        load[r.shard] += r.window;
+        total += r.window;
+    }
+    const auto hot    = static_cast<std::size_t>( std::max_element( load.begin(), load.end() ) - load.begin() );
+    const auto cold   = static_cast<std::size_t>( std::min_element( load.begin(), load.end() ) - load.begin() );
+    const double mean = static_cast<double>( total ) / static_cast<double>( shards_.size() );
+    if ( total == 0 || static_cast<double>( load[hot] ) <= config_.imbalance * mean )
+    {
+        return;
+    }
+
+    // Move the busiest symbol that still leaves the idle shard no busier
+    // than the hot one.  Anything larger just moves the hot spot (a symbol
+    // carrying most of the shard never qualifies), and would bounce back at
+    // the next check.
+    SymbolIndex best        = NoSymbol;
+    std::uint64_t best_load = 0;
+    for ( SymbolIndex s = 0; s < routes_.size(); ++s )
+    {
+        const Route& r = routes_[s];
+        if ( r.shard == hot && r.window > best_load && 2 * r.window <= load[hot] - load[cold] )
+        {
+            best      = s;
+            best_load = r.window;
+        }
+    }
+    if ( best != NoSymbol )
+    {
+        migrate( best, cold );
+    }
+}
+
+void ShardedEngine::drain()
+{
+    while ( migration_ )
+    {
+        advanceMigration();
+    }
+    for ( const auto& shard : shards_ )
+    {
+        while ( shard->processed.load( std::memory_order_acquire ) != shard->pushed )
+            ;
+    }
+}
+
+void ShardedEngine::stop()
+{
+    if ( !started_ )
+    {
+        return;
+    }
+    drain();
+    if ( merger_ )
+    {
+        merger_->finish( routed_ );
+    }
+    for ( const auto& shard : shards_ )
+    {
+        shard->stopping.store( true, std::memory_order_release );
+    }
+    for ( const auto& shard : shards_ )
+    {
+        if ( shard->thread.joinable() )
+        {
+            shard->thread.join();
+        }
+    }
+    started_ = false;
+}
+
+std::vector<ShardLoad> ShardedEngine::shardLoads() const
+{
+    std::vector<ShardLoad> loads( shards_.size() );
+    for ( std::size_t s = 0; s < shards_.size(); ++s )
+    {
+        loads[s].routed  = shards_[s]->pushed;
+        loads[s].backlog = shards_[s]->pushed - shards_[s]->processed.load( std::memory_order_acquire );
+    }
+    for ( const Route& r : routes_ )
+    {
+        loads[r.shard].window += r.window;
+        ++loads[r.shard].symbols;
+    }
+    return loads;
+}
+
+std::vector<SymbolLoad> ShardedEngine::symbolLoads() const
+{
+    std::vector<SymbolLoad> loads;
+    loads.reserve( routes_.size() );
+    for ( const Route& r : routes_ )
+    {
+        loads.push_back( { .shard = r.shard, .routed = r.routed, .window = r.window } );
+    }
+    return loads;
+}
+
+EngineStats ShardedEngine::stats() const
+{
+    EngineStats total;
+    for ( const auto& shard : shards_ )
+    {
+        if ( !shard->engine )
+        {
+            continue;
+        }
+        const EngineStats& s = shard->engine->stats();
+        total.accepted += s.accepted;
+        total.rejected += s.rejected;
+        total.cancelled += s.cancelled;
+        total.cancel_rejects += s.cancel_rejects;
+        total.cancel_filtered += s.cancel_filtered;
+    }
+    return total;
+}
+
+std::vector<Order> ShardedEngine::restingOrders( SymbolIndex symbol ) const
+{
+    const auto& engine = shards_[routes_[symbol].shard]->engine;
+    return engine->book( symbol ).exportOrders( Symbol( names_[symbol].c_str() ) );
+}
+
+void ShardedEngine::report( std::ostream& out ) const
+{
+    const auto loads = shardLoads();
+    const auto total = stats();
+    out << "[Shards] shards=" << shards_.size() << " symbols=" << names_.size() << " routed=" << routed_
+        << " migrations=" << history_.size() << " accepted=" << total.accepted << " cancelled=" << total.cancelled << "\n";
+
+    for ( std::size_t s = 0; s < shards_.size(); ++s )
+    {
+        out << "[Shard] id=" << s << " symbols=" << loads[s].symbols << " routed=" << loads[s].routed << " backlog=" << loads[s].backlog;
+        if ( shards_[s]->engine )
+        {
+            out << " accepted=" << shards_[s]->engine->stats().accepted;
+        }
+        out << "\n";
+    }
+
+    // The busiest symbols only: a universe can hold thousands.
+    constexpr std::size_t HottestSymbols = 5;
+    std::vector<SymbolIndex> hottest( routes_.size() );
+    for ( SymbolIndex s = 0; s < hottest.size(); ++s )
+    {
+        hottest[s] = s;
+    }
+    const std::size_t shown = std::min( HottestSymbols, hottest.size() );
+    std::partial_sort( hottest.begin(), hottest.begin() + static_cast<std::ptrdiff_t>( shown ), hottest.end(),
+                       [this]( SymbolIndex a, SymbolIndex b ) { return routes_[a].routed > routes_[b].routed; } );
+    for ( std::size_t i = 0; i < shown; ++i )
+    {
+        const Route& r = routes_[hottest[i]];
+        out << "[ShardSymbol] symbol=" << names_[hottest[i]] << " shard=" << r.shard << " routed=" << r.routed << "\n";
+    }
+
+    for ( const auto& m : history_ )
+    {
+        out << "[Migration] symbol=" << names_[m.symbol] << " from=" << m.from << " to=" << m.to << " at_event=" << m.at_event
+            << " orders=" << m.orders << " held=" << m.held << " restored=" << m.restored << "\n";
+    }
+}
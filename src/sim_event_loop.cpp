@@ -6,25 +6,133 @@
 //   - NewOrder    → process_new_order()
 //   - CancelOrder → process_cancel()
 //
+// In prefetch mode (runPrefetched) events are claimed in batches into a
+// thread-local window first, so the look-ahead is over events this thread
+// already owns and prefetch hints never race the producer.
+//
 // Shutdown is signalled atomically via setWaitForDone(); the loop exits
 // once the flag is raised and the buffer is observed empty.
+//
+// Controls are checked after each pop and before the popped event is
+// dispatched.  The producer posts a control before pushing the event that
+// follows it, so by the time that event is popped the control is visible.
+// In prefetch mode the look-ahead may have prefetched for an event on the
+// far side of a control; that only wastes the hint.
 // ============================================================================
 
 #include <sim_event_loop.h>
+#include <sim_universe.h>
+#include <thread_affinity.h>
 #include <assert.h>
 
+#include <algorithm>
+
 using namespace MarketMicroStructure;
 using namespace HFTToolset;
 
-EventLoop::EventLoop( MatchingEngine& engine ) : engine_( engine ) {}
+namespace
+{
+template <typename Engine>
+concept TakesSymbolControls = requires( Engine& e, std::string_view name, SymbolSpec spec ) {
+    e.add_symbol( name, spec );
+    e.remove_symbol( name );
+};
+
+}  // namespace
+
+SymbolControl SymbolControl::make( Kind kind, std::string_view name, std::uint64_t fence, SymbolSpec spec )
+{
+    assert( name.size() < SymbolControl{}.name.size() && "control symbol names are limited to 31 characters" );
+
+    SymbolControl control{ .kind = kind, .spec = spec, .fence = fence };
+    name.copy( control.name.data(), std::min( name.size(), control.name.size() - 1 ) );
+    return control;
+}
+
+template <typename Engine>
+BasicEventLoop<Engine>::BasicEventLoop( Engine& engine ) : engine_( engine ) {}
+
+template <typename Engine>
+std::thread BasicEventLoop<Engine>::runAsync( EventLoopBuffer& events, int core )
+{
+    return std::thread(
+        [this, &events, core]
+        {
+            pinCurrentThreadToCore( core );
+            run( events );
+        } );
+}
+
+template <typename Engine>
+void BasicEventLoop<Engine>::dispatch( const EngineEvent& ev )
+{
+    switch ( ev.type )
+    {
+        case EventType::NewOrder:
+            engine_.process_new_order( ev.order );
+            break;
+        case EventType::CancelOrder:
+            engine_.process_cancel( ev.cancel );
+            break;
+        default:
+            assert(false && "Unknown event type");
+            break;
+    }
+}
 
-std::thread EventLoop::runAsync( EventLoopBuffer& events )
+template <typename Engine>
+void BasicEventLoop<Engine>::serviceControls( std::uint64_t processed )
 {
-    return std::thread( &EventLoop::run, this, std::ref( events ) );
+    if constexpr ( TakesSymbolControls<Engine> )
+    {
+        for ( ;; )
+        {
+            if ( !pending_ )
+            {
+                pending_ = controls_.pop();
+                if ( !pending_ )
+                {
+                    return;
+                }
+            }
+            if ( pending_->fence > processed )
+            {
+                return;
+            }
+
+            if ( pending_->kind == SymbolControl::Kind::List )
+            {
+                engine_.add_symbol( pending_->name.data(), pending_->spec );
+            }
+            else
+            {
+                engine_.remove_symbol( pending_->name.data() );
+            }
+            pending_.reset();
+            // Single writer, like processed_.
+            controls_applied_.store( controls_applied_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+    }
 }
 
-void EventLoop::run( EventLoopBuffer& events )
+template <typename Engine>
+void BasicEventLoop<Engine>::run( EventLoopBuffer& events )
 {
+    if constexpr ( requires( const Engine& e, const EngineEvent& ev ) {
+                       e.prefetchEvent( ev );
+                       e.prefetchResting( ev );
+                   } )
+    {
+        if ( prefetch_distance_ > 0 )
+        {
+            runPrefetched( events );
+            return;
+        }
+    }
+
+    // Single writer: a plain store publishes the count without an RMW.
+    std::uint64_t processed = processed_.load( std::memory_order_relaxed );
+
     while ( !isDone() )
     {
         while ( !events.empty() )
@@ -32,19 +140,81 @@ void EventLoop::run( EventLoopBuffer& events )
             auto ev = events.pop();
             if ( ev )
             {
-                switch ( ev->type )
+                serviceControls( processed );
+                dispatch( *ev );
+                processed_.store( ++processed, std::memory_order_release );
+            }
+        }
+        serviceControls( processed );
+    }
+    serviceControls( processed );
+}
+
+template <typename Engine>
+void BasicEventLoop<Engine>::runPrefetched( EventLoopBuffer& events )
+{
+    if constexpr ( requires( const Engine& e, const EngineEvent& ev ) {
+                       e.prefetchEvent( ev );
+                       e.prefetchResting( ev );
+                   } )
+    {
+        const std::size_t far  = prefetch_distance_;
+        const std::size_t near = std::max<std::size_t>( far / 2, 1 );
+
+        std::array<EngineEvent, MaxBatch> window;
+        std::uint64_t processed = processed_.load( std::memory_order_relaxed );
+
+        while ( !isDone() )
+        {
+            while ( !events.empty() )
+            {
+                std::size_t count = 0;
+                while ( count < MaxBatch )
                 {
-                    case EventType::NewOrder:
-                        engine_.process_new_order( ev->order );
-                        break;
-                    case EventType::CancelOrder:
-                        engine_.process_cancel( ev->cancel );
-                        break;
-                    default:
-                        assert(false && "Unknown event type");
+                    auto ev = events.pop();
+                    if ( !ev )
+                    {
                         break;
+                    }
+                    window[count++] = std::move( *ev );
+                }
+
+                // Prime the pipeline: stage 1 for the first `far` events,
+                // stage 2 for the first `near`.
+                for ( std::size_t i = 0; i < std::min( far, count ); ++i )
+                {
+                    engine_.prefetchEvent( window[i] );
+                }
+                for ( std::size_t i = 0; i < std::min( near, count ); ++i )
+                {
+                    engine_.prefetchResting( window[i] );
+                }
+
+                for ( std::size_t i = 0; i < count; ++i )
+                {
+                    if ( i + far < count )
+                    {
+                        engine_.prefetchEvent( window[i + far] );
+                    }
+                    if ( i + near < count )
+                    {
+                        engine_.prefetchResting( window[i + near] );
+                    }
+                    serviceControls( processed );
+                    dispatch( window[i] );
+                    processed_.store( ++processed, std::memory_order_release );
                 }
             }
+            serviceControls( processed );
         }
+        serviceControls( processed );
+    }
+    else
+    {
+        assert(false && "Engine has no prefetch hooks");
     }
 }
+
+template class MarketMicroStructure::BasicEventLoop<MatchingEngine>;
+template class MarketMicroStructure::BasicEventLoop<SimMatchingEngine>;
+template class MarketMicroStructure::BasicEventLoop<SimUniverseEngine>;
@@ -0,0 +1,546 @@
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Matching Engine Implementation
+// ============================================================================
+
+#include <sim_matching_engine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <new>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+SimMatchingEngine::SimMatchingEngine( ClockRef clock )
+    : clock_( clock ),
+      index_resource_( MemoryRegistry::instance().account( "order_index" ) ),
+      heap_state_( std::make_unique<EngineState>( BookStorage( &index_resource_ ) ) ),
+      state_( heap_state_.get() )
+{
+    publishTable();
+}
+
+std::uint64_t SimMatchingEngine::persistentLayout()
+{
+    // Bump the leading version whenever a persisted type changes meaning
+    // without changing size.
+    std::uint64_t signature = 1;
+    for ( const std::size_t size : { sizeof( EngineState ), sizeof( StoredSymbol ), sizeof( SimOrderBook ), sizeof( SimOrderBook::Node ),
+                                     sizeof( SimOrderBook::ColdOrder ), sizeof( SimOrderBook::Level ), sizeof( OrderIndex ), sizeof( MarketDataState ) } )
+    {
+        signature = ( signature ^ size ) * 0x100000001b3ULL;
+    }
+    return signature;
+}
+
+std::expected<void, std::string> SimMatchingEngine::attach( MappedBookFile& file )
+{
+    if ( file_ != nullptr || !symbols_.empty() )
+    {
+        return std::unexpected( "a book file must be attached before any symbol is added" );
+    }
+    BookStorage storage = file.storage();
+
+    if ( !file.restored() || file.root() == 0 )
+    {
+        const std::uint64_t root = storage.allocate( sizeof( EngineState ), alignof( EngineState ) );
+        state_                   = ::new ( storage.at<void>( root ) ) EngineState( storage );
+        file.setRoot( root );
+    }
+    else
+    {
+        EngineState& state = *storage.at<EngineState>( file.root() );
+        if ( state.events_started != state.events_applied )
+        {
+            return std::unexpected( "'" + file.path() + "' was left in the middle of an event; rebuild it from the event journal" );
+        }
+        state.index.rebind( storage );
+        state.symbols.rebind( storage );
+        state_ = &state;
+    }
+    heap_state_.reset();
+    file_ = &file;
+
+    // One slot and one rebind per symbol: nothing here scales with orders.
+    for ( SymbolIndex i = 0; i < state_->symbols.size(); ++i )
+    {
+        const StoredSymbol& stored = state_->symbols[i];
+        const std::string name( stored.name.data() );
+        symbols_.push_back( std::make_unique<SymbolSlot>( name, stored.spec, MemoryRegistry::instance().account( "book/" + name ), file_ ) );
+        if ( stored.listed )
+        {
+            symbol_lookup_.emplace( Symbol( name.c_str() ), i );
+        }
+
+        SymbolSlot& slot = *symbols_.back();
+        slot.listed      = stored.listed;
+        slot.book        = storage.at<SimOrderBook>( stored.book );
+        slot.book->rebind( state_->index, storage );
+        slot.book->setTradeSink( &on_trade_ );
+    }
+    publishTable();
+    return {};
+}
+
+// Listing and delisting change the books too, so a book file brackets them
+// like any event.
+SymbolIndex SimMatchingEngine::add_symbol( std::string_view name, SymbolSpec spec )
+{
+    ++state_->events_started;
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    const SymbolIndex idx = listSymbol( name, spec );
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    ++state_->events_applied;
+    return idx;
+}
+
+std::optional<std::size_t> SimMatchingEngine::remove_symbol( std::string_view name )
+{
+    ++state_->events_started;
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    const auto dropped = delistSymbol( name );
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    ++state_->events_applied;
+    return dropped;
+}
+
+SymbolIndex SimMatchingEngine::listSymbol( std::string_view name, SymbolSpec spec )
+{
+    assert( spec.tick_size > 0 && spec.lot_size > 0 && "tick and lot size must be positive" );
+
+    const Symbol symbol( std::string( name ).c_str() );
+    if ( auto existing = findSymbol( symbol ) )
+    {
+        return *existing;
+    }
+
+    // A delisted symbol comes back under its old index, with a fresh book
+    // for the new spec.
+    for ( SymbolIndex i = 0; i < symbols_.size(); ++i )
+    {
+        SymbolSlot& slot = *symbols_[i];
+        if ( slot.listed || slot.name != name )
+        {
+            continue;
+        }
+        destroyBook( i );
+        slot.arena.reset();
+        slot.spec = spec;
+        if ( file_ != nullptr )
+        {
+            state_->symbols[i].spec = spec;
+        }
+        setListed( i, true );
+        createBook( i );
+        symbol_lookup_.emplace( symbol, i );
+        publishTable( i );
+        return i;
+    }
+
+    const auto idx = static_cast<SymbolIndex>( symbols_.size() );
+    auto& account  = MemoryRegistry::instance().account( "book/" + std::string( name ) );
+    symbols_.push_back( std::make_unique<SymbolSlot>( std::string( name ), spec, account, file_ ) );
+    symbol_lookup_.emplace( symbol, idx );
+    if ( file_ != nullptr )
+    {
+        StoredSymbol& stored = state_->symbols.emplace_back();
+        assert( name.size() < stored.name.size() && "book file symbol names are limited to 31 characters" );
+        name.copy( stored.name.data(), stored.name.size() - 1 );
+        stored.spec = spec;
+    }
+    createBook( idx );
+    publishTable( idx );
+    return idx;
+}
+
+std::optional<std::size_t> SimMatchingEngine::delistSymbol( std::string_view name )
+{
+    const Symbol symbol( std::string( name ).c_str() );
+    const auto idx = findSymbol( symbol );
+    if ( !idx )
+    {
+        return std::nullopt;
+    }
+
+    // The index is engine-wide, so each resting order is erased from it;
+    // the book and its arena go in one piece.
+    SymbolSlot& slot  = *symbols_[*idx];
+    const auto orders = slot.book->exportOrders( symbol );
+    for ( const Order& order : orders )
+    {
+        state_->index.erase( order.id );
+    }
+    destroyBook( *idx );
+    slot.arena.release();
+    setListed( *idx, false );
+    createBook( *idx );
+    symbol_lookup_.erase( symbol );
+    slot.dropped_orders = orders.size();
+    publishTable( *idx );
+    return orders.size();
+}
+
+void SimMatchingEngine::setListed( SymbolIndex symbol, bool listed )
+{
+    symbols_[symbol]->listed = listed;
+    if ( file_ != nullptr )
+    {
+        state_->symbols[symbol].listed = listed;
+    }
+}
+
+void SimMatchingEngine::publishTable()
+{
+    auto table     = std::make_shared<SymbolTable>();
+    table->version = ++table_version_;
+    table->size    = symbols_.size();
+    std::array<std::shared_ptr<SymbolTable::Shard>, SymbolTable::LookupShards> shards;
+    for ( auto& shard : shards )
+    {
+        shard = std::make_shared<SymbolTable::Shard>();
+    }
+    std::shared_ptr<SymbolTable::Chunk> chunk;
+    for ( SymbolIndex i = 0; i < symbols_.size(); ++i )
+    {
+        if ( i % SymbolTable::ChunkEntries == 0 )
+        {
+            chunk = std::make_shared<SymbolTable::Chunk>();
+            table->chunks.push_back( chunk );
+        }
+        const SymbolSlot& slot = *symbols_[i];
+        chunk->push_back( { slot.name, slot.spec, slot.listed, slot.dropped_orders } );
+        if ( slot.listed )
+        {
+            const Symbol symbol( slot.name.c_str() );
+            shards[SymbolTable::shardOf( symbol )]->emplace( symbol, i );
+        }
+    }
+    std::copy( shards.begin(), shards.end(), table->lookup.begin() );
+    table_.store( std::move( table ), std::memory_order_release );
+}
+
+void SimMatchingEngine::publishTable( SymbolIndex symbol )
+{
+    const auto previous    = table_.load( std::memory_order_relaxed );
+    auto table             = std::make_shared<SymbolTable>( *previous );
+    table->version         = ++table_version_;
+    table->size            = symbols_.size();
+    const SymbolSlot& slot = *symbols_[symbol];
+
+    const std::size_t chunk = symbol / SymbolTable::ChunkEntries;
+    auto entries            = chunk < table->chunks.size() ? std::make_shared<SymbolTable::Chunk>( *table->chunks[chunk] ) : std::make_shared<SymbolTable::Chunk>();
+    const SymbolTable::Entry entry{ slot.name, slot.spec, slot.listed, slot.dropped_orders };
+    if ( symbol % SymbolTable::ChunkEntries < entries->size() )
+    {
+        ( *entries )[symbol % SymbolTable::ChunkEntries] = entry;
+    }
+    else
+    {
+        entries->push_back( entry );
+    }
+    if ( chunk < table->chunks.size() )
+    {
+        table->chunks[chunk] = std::move( entries );
+    }
+    else
+    {
+        table->chunks.push_back( std::move( entries ) );
+    }
+
+    const Symbol name( slot.name.c_str() );
+    auto& shard = table->lookup[SymbolTable::shardOf( name )];
+    auto lookup = std::make_shared<SymbolTable::Shard>( *shard );
+    if ( slot.listed )
+    {
+        lookup->insert_or_assign( name, symbol );
+    }
+    else
+    {
+        lookup->erase( name );
+    }
+    shard = std::move( lookup );
+    table_.store( std::move( table ), std::memory_order_release );
+}
+
+std::optional<SymbolIndex> SymbolTable::find( const Symbol& symbol ) const
+{
+    const Shard& shard = *lookup[shardOf( symbol )];
+    const auto it      = shard.find( symbol );
+    if ( it == shard.end() )
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void SimMatchingEngine::createBook( SymbolIndex symbol )
+{
+    SymbolSlot& slot           = *symbols_[symbol];
+    const std::uint64_t offset = slot.storage.allocate( sizeof( SimOrderBook ), alignof( SimOrderBook ) );
+    slot.book                  = ::new ( slot.storage.at<void>( offset ) ) SimOrderBook( symbol, slot.spec, state_->index, slot.storage );
+    slot.book->setTradeSink( &on_trade_ );
+    if ( slot.listed )
+    {
+        slot.book->reserve( reserved_orders_ );
+    }
+    if ( file_ != nullptr )
+    {
+        state_->symbols[symbol].book = offset;
+    }
+}
+
+void SimMatchingEngine::destroyBook( SymbolIndex symbol )
+{
+    SymbolSlot& slot = *symbols_[symbol];
+    slot.book->~SimOrderBook();
+    slot.storage.deallocate( slot.storage.offsetOf( slot.book ), sizeof( SimOrderBook ), alignof( SimOrderBook ) );
+    slot.book = nullptr;
+}
+
+std::size_t SimMatchingEngine::reserve( std::size_t orders_per_symbol )
+{
+    // A book file keeps half its unused tail for the order flow; the
+    // reservation is halved until it fits in the other half.
+    if ( file_ != nullptr )
+    {
+        while ( orders_per_symbol > 0 && reservationBytes( orders_per_symbol ) > ( file_->capacity() - file_->usedBytes() ) / 2 )
+        {
+            orders_per_symbol /= 2;
+        }
+    }
+    reserved_orders_ = orders_per_symbol;
+    state_->index.reserve( orders_per_symbol * symbols_.size() );
+    for ( auto& slot : symbols_ )
+    {
+        if ( !slot->listed )
+        {
+            continue;
+        }
+        // Twice the node pool and cold table: room for the ladders and one
+        // regrowth.  Book file pages are faulted in as they are reached.
+        if ( file_ == nullptr )
+        {
+            slot->arena.prefault( 2 * orders_per_symbol * ( sizeof( SimOrderBook::Node ) + sizeof( SimOrderBook::ColdOrder ) ) );
+        }
+        slot->book->reserve( orders_per_symbol );
+    }
+    return orders_per_symbol;
+}
+
+std::optional<SymbolIndex> SimMatchingEngine::findSymbol( const Symbol& symbol ) const
+{
+    const auto it = symbol_lookup_.find( symbol );
+    if ( it == symbol_lookup_.end() )
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::optional<Order> SimMatchingEngine::findOrder( OrderKey id ) const
+{
+    const OrderIndex::Entry* entry = state_->index.find( id );
+    if ( !entry )
+    {
+        return std::nullopt;
+    }
+    const SymbolSlot& slot = *symbols_[entry->symbol];
+    return slot.book->restingOrder( entry->node, Symbol( slot.name.c_str() ) );
+}
+
+// The counter pair brackets the event for a book file: the signal fences
+// keep the compiler from moving book writes outside it.
+void SimMatchingEngine::process_new_order( const Order& order )
+{
+    ++state_->events_started;
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    newOrder( order );
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    ++state_->events_applied;
+}
+
+void SimMatchingEngine::process_cancel( const CancelRequest& cancel )
+{
+    ++state_->events_started;
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    cancelOrder( cancel );
+    std::atomic_signal_fence( std::memory_order_seq_cst );
+    ++state_->events_applied;
+}
+
+void SimMatchingEngine::newOrder( const Order& order )
+{
+    Stats& stats      = state_->stats;
+    // Duplicate-id check: a fresh id is almost always a certain filter miss.
+    const auto symbol = findSymbol( order.symbol );
+    if ( !symbol || ( state_->index.mayContain( order.id ) && state_->index.find( order.id ) ) )
+    {
+        ++stats.rejected;
+        return;
+    }
+
+    // A full book file must not throw mid-event: refuse any order whose
+    // worst-case growth (book pools, ladder, index) it could not hold.
+    SimOrderBook& book = *symbols_[*symbol]->book;
+    if ( file_ != nullptr && !file_->fits( book.submitAllocations( order ), state_->index.insertAllocations() ) )
+    {
+        ++stats.rejected;
+        ++stats.storage_rejects;
+        return;
+    }
+
+    const auto result = book.submit( order, clock_.now() );
+    if ( result == SimOrderBook::SubmitResult::Rejected )
+    {
+        ++stats.rejected;
+        return;
+    }
+    ++stats.accepted;
+}
+
+void SimMatchingEngine::cancelOrder( const CancelRequest& cancel )
+{
+    Stats& stats      = state_->stats;
+    OrderIndex& index = state_->index;
+
+    // Certain miss (unknown, filled or already cancelled id): no index probe.
+    if ( !index.mayContain( cancel.order_id ) )
+    {
+        ++stats.cancel_rejects;
+        ++stats.cancel_filtered;
+        return;
+    }
+
+    const OrderIndex::Entry* entry = index.find( cancel.order_id );
+    if ( !entry )
+    {
+        ++stats.cancel_rejects;
+        return;
+    }
+
+    const OrderIndex::Entry resting = *entry;
+    index.erase( cancel.order_id );
+    symbols_[resting.symbol]->book->cancel( resting.node );
+    ++stats.cancelled;
+}
+
+void SimMatchingEngine::prefetchEvent( const EngineEvent& ev ) const
+{
+    if ( ev.type == EventType::CancelOrder )
+    {
+        state_->index.prefetch( ev.cancel.order_id );
+        return;
+    }
+
+    // New orders probe the index too (duplicate-id check and insert).
+    state_->index.prefetch( ev.order.id );
+    if ( const auto symbol = findSymbol( ev.order.symbol ) )
+    {
+        symbols_[*symbol]->book->prefetchLevels( ev.order.side, ev.order.price );
+    }
+}
+
+void SimMatchingEngine::prefetchResting( const EngineEvent& ev ) const
+{
+    if ( ev.type == EventType::CancelOrder )
+    {
+        if ( const OrderIndex::Entry* entry = state_->index.find( ev.cancel.order_id ) )
+        {
+            symbols_[entry->symbol]->book->prefetchNode( entry->node );
+        }
+        return;
+    }
+
+    if ( const auto symbol = findSymbol( ev.order.symbol ) )
+    {
+        symbols_[*symbol]->book->prefetchMatchHead( ev.order.side );
+    }
+}
+
+std::size_t SimMatchingEngine::reservationBytes( std::size_t orders_per_symbol ) const
+{
+    std::size_t listed = 0;
+    std::size_t bytes  = 0;
+    for ( const auto& slot : symbols_ )
+    {
+        if ( slot->listed )
+        {
+            ++listed;
+            for ( const std::size_t request : slot->book->reserveAllocations( orders_per_symbol ) )
+            {
+                bytes += MappedBookFile::blockBytes( request );
+            }
+        }
+    }
+    for ( const std::size_t request : state_->index.reserveAllocations( orders_per_symbol * listed ) )
+    {
+        bytes += MappedBookFile::blockBytes( request );
+    }
+    return bytes;
+}
+
+void SimMatchingEngine::endSession()
+{
+    state_->index.clear();
+    for ( SymbolIndex i = 0; i < symbols_.size(); ++i )
+    {
+        destroyBook( i );
+        symbols_[i]->arena.reset();
+        createBook( i );
+    }
+}
+
+SymbolBookState SimMatchingEngine::exportSymbol( SymbolIndex symbol ) const
+{
+    const SymbolSlot& slot = *symbols_[symbol];
+    return { slot.book->exportOrders( Symbol( slot.name.c_str() ) ), slot.book->marketData() };
+}
+
+SymbolBookState SimMatchingEngine::extractSymbol( SymbolIndex symbol )
+{
+    SymbolSlot& slot      = *symbols_[symbol];
+    SymbolBookState state = exportSymbol( symbol );
+    for ( const Order& order : state.orders )
+    {
+        state_->index.erase( order.id );
+    }
+    destroyBook( symbol );
+    slot.arena.reset();
+    createBook( symbol );
+    return state;
+}
+
+bool SimMatchingEngine::restoreSymbol( SymbolIndex symbol, const SymbolBookState& state )
+{
+    SimOrderBook& book = *symbols_[symbol]->book;
+    for ( const Order& order : state.orders )
+    {
+        if ( state_->index.find( order.id ) || !book.restore( order ) )
+        {
+            // Back to the empty book: nothing of a partial restore stays
+            // in the book or the order index.
+            extractSymbol( symbol );
+            return false;
+        }
+    }
+    book.restoreTradeState( state.market_data );
+    return true;
+}
+
+void SimMatchingEngine::reportMemory( std::ostream& out ) const
+{
+    for ( const auto& slot : symbols_ )
+    {
+        const auto usage = slot->book->memoryUsage();
+        out << "[Memory] book/" << slot->name << " orders_bytes=" << usage.orders << " levels_bytes=" << usage.levels
+            << " market_data_bytes=" << usage.market_data << " arena_used=" << slot->arena.usedBytes()
+            << " arena_reserved=" << slot->arena.reservedBytes() << " resting=" << slot->book->restingOrders()
+            << " tombstones=" << slot->book->tombstones() << "\n";
+    }
+    out << "[Memory] order_index bytes=" << state_->index.memoryBytes() << " entries=" << state_->index.size() << "\n";
+    if ( file_ != nullptr )
+    {
+        out << "[Memory] book_file used=" << file_->usedBytes() << " capacity=" << file_->capacity() << "\n";
+    }
+}
@@ -0,0 +1,404 @@
+// ============================================================================
+// MarketMicrostructureEngine — Command-Line Options Implementation
+//
+// Flags use the "--name" / "--name=value" form.  Values are parsed with
+// std::from_chars so malformed numbers are rejected rather than silently
+// truncated.
+// ============================================================================
+
+#include <sim_options.h>
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <vector>
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+template <typename T>
+bool parseNumber( std::string_view text, T& out )
+{
+    const auto* end = text.data() + text.size();
+    auto [ptr, ec]  = std::from_chars( text.data(), end, out );
+    return ec == std::errc{} && ptr == end;
+}
+
+/// Parses a comma-separated list of positive integers, e.g. "3,100,1000".
+bool parseSizeList( std::string_view text, std::vector<std::size_t>& out )
+{
+    std::vector<std::size_t> values;
+    while ( !text.empty() )
+    {
+        const auto comma  = text.find( ',' );
+        std::size_t value = 0;
+        if ( !parseNumber( text.substr( 0, comma ), value ) || value == 0 )
+        {
+            return false;
+        }
+        values.push_back( value );
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr( comma + 1 );
+    }
+    if ( values.empty() )
+    {
+        return false;
+    }
+    out = std::move( values );
+    return true;
+}
+
+/// Parses "EVENT:NAME[,EVENT:NAME...]" into @p out, keeping it ordered by
+/// event; entries at the same event keep their command-line order.
+bool parseSymbolChanges( std::string_view text, bool list, std::vector<SymbolChange>& out )
+{
+    std::vector<SymbolChange> changes;
+    while ( !text.empty() )
+    {
+        const auto comma = text.find( ',' );
+        const auto entry = text.substr( 0, comma );
+        const auto colon = entry.find( ':' );
+        SymbolChange change;
+        change.list = list;
+        if ( colon == std::string_view::npos || !parseNumber( entry.substr( 0, colon ), change.at_event ) )
+        {
+            return false;
+        }
+        change.name = entry.substr( colon + 1 );
+        if ( change.name.empty() || change.name.size() > 31 )
+        {
+            return false;
+        }
+        changes.push_back( std::move( change ) );
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr( comma + 1 );
+    }
+    if ( changes.empty() )
+    {
+        return false;
+    }
+    out.insert( out.end(), changes.begin(), changes.end() );
+    std::stable_sort( out.begin(), out.end(), []( const SymbolChange& a, const SymbolChange& b ) { return a.at_event < b.at_event; } );
+    return true;
+}
+
+template <typename Rep, typename Period>
+bool parsePositiveDuration( std::string_view text, std::chrono::duration<Rep, Period>& out )
+{
+    Rep count = 0;
+    if ( !parseNumber( text, count ) || count <= 0 )
+    {
+        return false;
+    }
+    out = std::chrono::duration<Rep, Period>( count );
+    return true;
+}
+
+}  // namespace
+
+std::string MarketMicroStructure::simOptionsUsage( const char* program )
+{
+    std::string usage = "usage: ";
+    usage += program;
+    usage +=
+        " [options]\n"
+        "  --help                      print this message\n"
+        "  --events=N                  number of events to generate (default 1000000)\n"
+        "  --engine=hft|sim|fixed      matching engine: HFTToolset (default), simulation-layer book, or compile-time universe\n"
+        "  --seed=N                    random-flow seed, printed every run for replay (default 0 = random)\n"
+        "  --flow=uniform|hawkes       order flow: i.i.d. uniform (default) or clustered Hawkes arrivals\n"
+        "  --flow-scenario=PATH        fit the Hawkes flow to a recorded scenario file (implies --flow=hawkes)\n"
+        "  --flow-pacing               release Hawkes events at their simulated times\n"
+        "  --warmup-events=N           synthetic events run before the timed region (default 200000, 0 = off)\n"
+        "  --prefault-orders=N         per-symbol orders pre-sized and pre-faulted, sim engine (default 16384)\n"
+        "  --prefetch-distance=K       claim events in batches and prefetch K events ahead, sim engine (default 0 = off)\n"
+        "  --mlock                     lock all current and future pages into RAM\n"
+        "  --producer-core=N           pin the producer thread to core N\n"
+        "  --loop-core=N               pin the EventLoop thread to core N\n"
+        "  --calibrate                 measure host jitter on both cores before and after the run\n"
+        "  --calibrate-ms=N            calibration window per phase in milliseconds (default 500)\n"
+        "  --calibrate-threshold-ns=N  smallest gap counted as an interruption (default 200)\n"
+        "  --memory-report             print per-subsystem memory, peak RSS and page faults at exit\n"
+        "  --scaling-bench             measure add/cancel/match latency over book depth and symbol count, then exit\n"
+        "  --bench-depths=A,B,...      resting orders per configuration (default 1000,100000,10000000)\n"
+        "  --bench-symbols=A,B,...     symbols per configuration (default 3,100,1000,10000)\n"
+        "  --bench-samples=N           measured operations per op type and configuration (default 200000)\n"
+        "  --stress=all|A,B,...        replay stress scenarios and compare with their baselines, then exit\n"
+        "                              (flash_crash, quote_stuffing, opening_burst, cancel_storm, book_depletion, hot_symbol)\n"
+        "  --stress-events=N           measured events per scenario (default 200000)\n"
+        "  --stress-symbols=N          override each scenario's symbol count\n"
+        "  --stress-seed=N             scenario generator seed (default 42)\n"
+        "  --stress-save=DIR           also write each generated scenario to DIR/<name>.scenario\n"
+        "  --l3-replay=PATH            rebuild books from a recorded L3 feed, check its snapshots, then exit\n"
+        "  --replay-threads=N          L3 replay workers / scenario replay partitions (default: one per hardware thread)\n"
+        "  --partitioned-replay=PATH   replay a scenario file with one engine per symbol partition, merge the outputs, then exit\n"
+        "  --replay-first-core=N       pin replay partition p to core N+p (default: unpinned)\n"
+        "  --shards=N                  run the simulation on N symbol shards, each with its own ring and loop thread (sim engine)\n"
+        "  --rebalance-window=N        routed events between shard load checks and hot-symbol migrations, 0 = off (default 65536)\n"
+        "  --sequenced                 with --shards: merge every shard's reports and fills into one stream in global sequence order\n"
+        "  --replica-publish=NAME      publish every inbound event to shared memory NAME for a hot standby (sim engine)\n"
+        "  --replica=NAME              run as the hot standby of the primary publishing NAME, then exit\n"
+        "  --replica-max-lag=N         events the primary may run ahead of its standby (default 4096)\n"
+        "  --takeover-timeout-ms=N     primary heartbeat age at which the standby takes over (default 500)\n"
+        "  --journal=DIR               write block-compressed event and trade journals to DIR (sim engine)\n"
+        "  --journal-workers=N         journal compression threads per journal (default 2)\n"
+        "  --journal-info=PATH         decode and check every block of a journal, then exit\n"
+        "  --journal-find=PATH         look records up in a journal through its .idx sidecar, then exit\n"
+        "  --find-order=ID             with --journal-find: records referencing order ID\n"
+        "  --find-time=FROM[,TO]       with --journal-find: records with FROM <= time < TO, in ns (default TO = FROM + 1s)\n"
+        "  --book-file=PATH            keep the sim engine's books in a mapped file; an existing file is resumed\n"
+        "  --book-file-mb=N            capacity of a new book file in MiB (default 1024, allocated sparsely)\n"
+        "  --list=EVENT:NAME[,...]     list NAME once EVENT timed events are pushed, while matching runs (sim engine)\n"
+        "  --delist=EVENT:NAME[,...]   delist NAME once EVENT timed events are pushed, dropping its resting orders\n";
+    return usage;
+}
+
+std::expected<SimOptions, std::string> MarketMicroStructure::parseSimOptions( int argc, char** argv )
+{
+    SimOptions options;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::string_view arg   = argv[i];
+        std::string_view value = {};
+        if ( auto eq = arg.find( '=' ); eq != std::string_view::npos )
+        {
+            value = arg.substr( eq + 1 );
+            arg   = arg.substr( 0, eq );
+        }
+
+        bool ok = true;
+        if ( arg == "--help" || arg == "-h" )
+        {
+            options.show_help = true;
+        }
+        else if ( arg == "--events" )
+        {
+            ok = parseNumber( value, options.events );
+        }
+        else if ( arg == "--engine" )
+        {
+            ok             = value == "hft" || value == "sim" || value == "fixed";
+            options.engine = value == "sim" ? EngineBackend::Sim : value == "fixed" ? EngineBackend::Fixed : EngineBackend::HFTToolset;
+        }
+        else if ( arg == "--seed" )
+        {
+            ok = parseNumber( value, options.seed );
+        }
+        else if ( arg == "--flow" )
+        {
+            ok           = value == "uniform" || value == "hawkes";
+            options.flow = value == "hawkes" ? FlowModel::Hawkes : FlowModel::Uniform;
+        }
+        else if ( arg == "--flow-scenario" )
+        {
+            ok                    = !value.empty();
+            options.flow_scenario = value;
+            options.flow          = FlowModel::Hawkes;
+        }
+        else if ( arg == "--flow-pacing" )
+        {
+            options.flow_pacing = true;
+        }
+        else if ( arg == "--warmup-events" )
+        {
+            ok = parseNumber( value, options.warmup_events );
+        }
+        else if ( arg == "--prefault-orders" )
+        {
+            ok = parseNumber( value, options.prefault_orders );
+        }
+        else if ( arg == "--prefetch-distance" )
+        {
+            ok = parseNumber( value, options.prefetch_distance );
+        }
+        else if ( arg == "--mlock" )
+        {
+            options.lock_memory = true;
+        }
+        else if ( arg == "--producer-core" )
+        {
+            ok = parseNumber( value, options.producer_core );
+        }
+        else if ( arg == "--loop-core" )
+        {
+            ok = parseNumber( value, options.loop_core );
+        }
+        else if ( arg == "--calibrate" )
+        {
+            options.calibrate = true;
+        }
+        else if ( arg == "--calibrate-ms" )
+        {
+            ok = parsePositiveDuration( value, options.calibrate_duration );
+        }
+        else if ( arg == "--calibrate-threshold-ns" )
+        {
+            ok = parsePositiveDuration( value, options.calibrate_threshold );
+        }
+        else if ( arg == "--memory-report" )
+        {
+            options.memory_report = true;
+        }
+        else if ( arg == "--scaling-bench" )
+        {
+            options.scaling_bench = true;
+        }
+        else if ( arg == "--bench-depths" )
+        {
+            ok = parseSizeList( value, options.scaling.depths );
+        }
+        else if ( arg == "--bench-symbols" )
+        {
+            ok = parseSizeList( value, options.scaling.symbol_counts );
+        }
+        else if ( arg == "--bench-samples" )
+        {
+            ok = parseNumber( value, options.scaling.samples ) && options.scaling.samples > 0;
+        }
+        else if ( arg == "--stress" )
+        {
+            options.stress_bench = true;
+            options.stress_names.clear();
+            ok = !value.empty();
+            for ( std::string_view rest = value == "all" ? std::string_view{} : value; ok && !rest.empty(); )
+            {
+                const auto comma = rest.find( ',' );
+                const auto name  = rest.substr( 0, comma );
+                ok               = findStressScenario( name ) != nullptr;
+                options.stress_names.emplace_back( name );
+                rest = comma == std::string_view::npos ? std::string_view{} : rest.substr( comma + 1 );
+            }
+        }
+        else if ( arg == "--stress-events" )
+        {
+            ok = parseNumber( value, options.stress.events ) && options.stress.events > 0;
+        }
+        else if ( arg == "--stress-symbols" )
+        {
+            ok = parseNumber( value, options.stress.symbols ) && options.stress.symbols > 0;
+        }
+        else if ( arg == "--stress-seed" )
+        {
+            ok = parseNumber( value, options.stress.seed );
+        }
+        else if ( arg == "--stress-save" )
+        {
+            ok                      = !value.empty();
+            options.stress_save_dir = value;
+        }
+        else if ( arg == "--l3-replay" )
+        {
+            ok                = !value.empty();
+            options.l3_replay = value;
+        }
+        else if ( arg == "--replay-threads" )
+        {
+            ok = parseNumber( value, options.replay_threads ) && options.replay_threads > 0;
+        }
+        else if ( arg == "--partitioned-replay" )
+        {
+            ok                         = !value.empty();
+            options.partitioned_replay = value;
+        }
+        else if ( arg == "--replay-first-core" )
+        {
+            ok = parseNumber( value, options.replay_first_core ) && options.replay_first_core >= 0;
+        }
+        else if ( arg == "--shards" )
+        {
+            ok = parseNumber( value, options.shards ) && options.shards > 0;
+        }
+        else if ( arg == "--rebalance-window" )
+        {
+            ok = parseNumber( value, options.rebalance_window );
+        }
+        else if ( arg == "--sequenced" )
+        {
+            options.sequenced = true;
+        }
+        else if ( arg == "--replica-publish" )
+        {
+            ok                      = !value.empty();
+            options.replica_publish = value;
+        }
+        else if ( arg == "--replica" )
+        {
+            ok              = !value.empty();
+            options.replica = value;
+        }
+        else if ( arg == "--replica-max-lag" )
+        {
+            ok = parseNumber( value, options.replication.max_lag ) && options.replication.max_lag > 0;
+        }
+        else if ( arg == "--takeover-timeout-ms" )
+        {
+            ok = parsePositiveDuration( value, options.replication.takeover_timeout );
+        }
+        else if ( arg == "--journal" )
+        {
+            ok                  = !value.empty();
+            options.journal_dir = value;
+        }
+        else if ( arg == "--journal-workers" )
+        {
+            ok = parseNumber( value, options.journal.workers ) && options.journal.workers > 0;
+        }
+        else if ( arg == "--journal-info" )
+        {
+            ok                   = !value.empty();
+            options.journal_info = value;
+        }
+        else if ( arg == "--journal-find" )
+        {
+            ok                   = !value.empty();
+            options.journal_find = value;
+        }
+        else if ( arg == "--find-order" )
+        {
+            std::uint64_t id   = 0;
+            ok                 = parseNumber( value, id );
+            options.find_order = id;
+        }
+        else if ( arg == "--find-time" )
+        {
+            const auto comma   = value.find( ',' );
+            std::uint64_t from = 0;
+            std::uint64_t to   = 0;
+            ok                 = parseNumber( value.substr( 0, comma ), from );
+            if ( comma == std::string_view::npos )
+            {
+                to = from + 1'000'000'000;
+            }
+            else
+            {
+                ok = ok && parseNumber( value.substr( comma + 1 ), to ) && to > from;
+            }
+            options.find_from = from;
+            options.find_to   = to;
+        }
+        else if ( arg == "--book-file" )
+        {
+            ok                = !value.empty();
+            options.book_file = value;
+        }
+        else if ( arg == "--book-file-mb" )
+        {
+            ok = parseNumber( value, options.book_file_mb ) && options.book_file_mb > 0;
+        }
+        else if ( arg == "--list" || arg == "--delist" )
+        {
+            ok = parseSymbolChanges( value, arg == "--list", options.symbol_changes );
+        }
+        else
+        {
+            return std::unexpected( "unknown option '" + std::string( arg ) + "'\n" + simOptionsUsage( argv[0] ) );
+        }
+
+        if ( !ok )
+        {
+            return std::unexpected( "invalid value for '" + std::string( arg ) + "'\n" + simOptionsUsage( argv[0] ) );
+        }
+    }
+
+    return options;
+}
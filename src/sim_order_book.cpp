@@ -0,0 +1,697 @@
+// ============================================================================
+// MarketMicrostructureEngine — Simulation Order Book Implementation
+//
+// Matching walks the opposite ladder from its best level outward, consuming
+// each level's FIFO from the head.  A level that empties triggers a scan for
+// the next non-empty level in the same direction; on the dense ladder this is
+// a short linear walk over adjacent Level structs.
+//
+// An order that takes at least the whole best level goes through sweep():
+// a prefix sum over the ladder's contiguous quantity array (level_sweep.h)
+// sizes the fill up front, the fully consumed levels are removed in bulk,
+// and only the final partially filled level is walked order by order.
+//
+// Internally every price is a tick count and every quantity a lot count;
+// the book converts to HFTToolset units only where values leave it.
+//
+// Cancels are lazy: cancel() marks the node as a tombstone and takes its
+// quantity off the level in O(1), leaving it linked.  Matching unlinks
+// tombstones it meets at the head of a level (or frees them with a swept
+// level).  Once tombstones outnumber live orders a compaction sweep starts:
+// every later submit() and cancel() reaps the tombstones among the next
+// CompactionStepNodes nodes of the pool until the sweep reaches its end, so
+// the cost is spread over events instead of landing on one cancel.
+// Level::count and the level quantity only ever count live orders.
+//
+// Matching and cancel read and write only the hot Node; cold_ is written
+// once when an order rests and read only for trade reports (maker trader)
+// and restingOrder().
+// ============================================================================
+
+#include <level_sweep.h>
+#include <prefetch.h>
+#include <sim_order_book.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+// 64-bit id plus 32-bit ticks, lots and links: two nodes per cache line.
+static_assert( sizeof( SimOrderBook::Node ) == 32 );
+
+SimOrderBook::SimOrderBook( SymbolIndex symbol, SymbolSpec spec, OrderIndex& index, BookStorage storage )
+    : symbol_( symbol ),
+      spec_( spec ),
+      index_( &index ),
+      nodes_( storage ),
+      cold_( storage ),
+      bids_( storage, true ),
+      asks_( storage, false ),
+      market_data_{}
+{
+}
+
+void SimOrderBook::rebind( OrderIndex& index, BookStorage storage )
+{
+    index_      = &index;
+    trade_sink_ = nullptr;
+    nodes_.rebind( storage );
+    cold_.rebind( storage );
+    for ( Ladder* ladder : { &bids_, &asks_ } )
+    {
+        ladder->levels.rebind( storage );
+        ladder->qty.rebind( storage );
+    }
+}
+
+std::optional<Ticks> SimOrderBook::toTicks( OrderPrice price ) const
+{
+    if ( price < 0 || price % spec_.tick_size != 0 )
+    {
+        return std::nullopt;
+    }
+    const auto ticks = static_cast<std::uint64_t>( price / spec_.tick_size );
+    if ( ticks > std::numeric_limits<Ticks>::max() )
+    {
+        return std::nullopt;
+    }
+    return static_cast<Ticks>( ticks );
+}
+
+std::optional<NodeQty> SimOrderBook::toLots( OrderQty quantity ) const
+{
+    if ( quantity <= 0 || quantity % spec_.lot_size != 0 )
+    {
+        return std::nullopt;
+    }
+    const auto lots = static_cast<std::uint64_t>( quantity / spec_.lot_size );
+    if ( lots > std::numeric_limits<NodeQty>::max() )
+    {
+        return std::nullopt;
+    }
+    return static_cast<NodeQty>( lots );
+}
+
+std::optional<OrderPrice> SimOrderBook::bestPrice( const Ladder& ladder ) const
+{
+    if ( ladder.best < 0 )
+    {
+        return std::nullopt;
+    }
+    return toPrice( static_cast<Ticks>( ladder.base + ladder.best ) );
+}
+
+std::optional<std::pair<std::size_t, std::int64_t>> SimOrderBook::ladderGrowth( const Ladder& ladder, Ticks ticks )
+{
+    const auto price = static_cast<std::int64_t>( ticks );
+    const auto size  = static_cast<std::int64_t>( ladder.levels.size() );
+    if ( size > 0 && price >= ladder.base && price < ladder.base + size )
+    {
+        return std::pair{ std::size_t{ 0 }, ladder.base };
+    }
+
+    const std::int64_t lo = size > 0 ? std::min( ladder.base, price ) : price;
+    const std::int64_t hi = size > 0 ? std::max( ladder.base + size, price + 1 ) : price + 1;
+    const auto span       = static_cast<std::size_t>( hi - lo );
+    if ( span > MaxLadderLevels )
+    {
+        return std::nullopt;
+    }
+
+    // Leave head-room on both sides so a drifting price does not regrow on
+    // every new extreme; never below tick 0.
+    const std::size_t new_size  = std::min( MaxLadderLevels, std::max<std::size_t>( MinLadderLevels, span * 2 ) );
+    const std::int64_t new_base = std::max<std::int64_t>( 0, lo - static_cast<std::int64_t>( ( new_size - span ) / 2 ) );
+    return std::pair{ new_size, new_base };
+}
+
+bool SimOrderBook::ensureRange( Ladder& ladder, Ticks ticks )
+{
+    const auto growth = ladderGrowth( ladder, ticks );
+    if ( !growth )
+    {
+        return false;
+    }
+    const auto [new_size, new_base] = *growth;
+    if ( new_size == 0 )
+    {
+        return true;
+    }
+    const std::int64_t shift = ladder.base - new_base;
+
+    BookVector<Level> grown( ladder.levels.storage() );
+    BookVector<std::uint64_t> grown_qty( ladder.qty.storage() );
+    grown.assign( new_size, Level{} );
+    grown_qty.assign( new_size, 0 );
+    for ( std::size_t i = 0; i < ladder.levels.size(); ++i )
+    {
+        const auto to = static_cast<std::size_t>( static_cast<std::int64_t>( i ) + shift );
+        grown[to]     = ladder.levels[i];
+        grown_qty[to] = ladder.qty[i];
+    }
+    ladder.levels.swap( grown );
+    ladder.qty.swap( grown_qty );
+    if ( ladder.best >= 0 )
+    {
+        ladder.best += shift;
+    }
+    ladder.base = new_base;
+    return true;
+}
+
+void SimOrderBook::levelFilled( Ladder& ladder, std::int64_t idx )
+{
+    ++ladder.non_empty;
+    if ( ladder.best < 0 || ( ladder.bid ? idx > ladder.best : idx < ladder.best ) )
+    {
+        ladder.best = idx;
+    }
+}
+
+void SimOrderBook::levelEmptied( Ladder& ladder, std::int64_t idx )
+{
+    --ladder.non_empty;
+    if ( idx != ladder.best )
+    {
+        return;
+    }
+    if ( ladder.non_empty == 0 )
+    {
+        ladder.best = -1;
+        return;
+    }
+
+    const std::int64_t step = ladder.bid ? -1 : 1;
+    for ( std::int64_t i = idx + step;; i += step )
+    {
+        if ( ladder.levels[static_cast<std::size_t>( i )].count > 0 )
+        {
+            ladder.best = i;
+            return;
+        }
+    }
+}
+
+NodeIndex SimOrderBook::allocateNode()
+{
+    if ( free_head_ != NilNode )
+    {
+        const NodeIndex node = free_head_;
+        free_head_           = nodes_[node].next;
+        return node;
+    }
+    nodes_.emplace_back();
+    cold_.emplace_back();
+    return static_cast<NodeIndex>( nodes_.size() - 1 );
+}
+
+void SimOrderBook::freeNode( NodeIndex node )
+{
+    nodes_[node].tombstone = false;
+    nodes_[node].next      = free_head_;
+    free_head_             = node;
+}
+
+void SimOrderBook::unlink( Level& level, NodeIndex node )
+{
+    Node& n = nodes_[node];
+    if ( n.prev != NilNode )
+    {
+        nodes_[n.prev].next = n.next;
+    }
+    else
+    {
+        level.head = n.next;
+    }
+    if ( n.next != NilNode )
+    {
+        nodes_[n.next].prev = n.prev;
+    }
+    else
+    {
+        level.tail = n.prev;
+    }
+}
+
+void SimOrderBook::recordFill( const Order& taker, NodeIndex maker_idx, OrderPrice price, NodeQty fill, Timestamp now )
+{
+    const OrderQty fill_qty = static_cast<OrderQty>( fill ) * spec_.lot_size;
+
+    // The only read of the cold table on the matching path.
+    if ( trade_sink_ && *trade_sink_ )
+    {
+        ( *trade_sink_ )( SimTrade{ .symbol         = symbol_,
+                                    .maker_id       = nodes_[maker_idx].id,
+                                    .taker_id       = taker.id,
+                                    .maker_trader   = cold_[maker_idx].trader_id,
+                                    .taker_trader   = taker.trader_id,
+                                    .price          = price,
+                                    .quantity       = fill_qty,
+                                    .aggressor_side = taker.side,
+                                    .time           = now } );
+    }
+
+    MarketDataState& md = market_data_;
+    md.last_trade_price = price;
+    md.last_trade_qty   = fill_qty;
+    md.traded_volume   += fill_qty;
+    ++md.trade_count;
+}
+
+NodeQty SimOrderBook::sweep( Ladder& ladder, const Order& order, std::optional<Ticks> limit, NodeQty remaining, Timestamp now )
+{
+    // Levels the order may reach: from best up to the limit (or the ladder end).
+    const auto best   = static_cast<std::size_t>( ladder.best );
+    const bool is_ask = !ladder.bid;
+    std::size_t reach = is_ask ? ladder.levels.size() - best : best + 1;
+    if ( limit )
+    {
+        const std::int64_t limit_idx = static_cast<std::int64_t>( *limit ) - ladder.base;
+        reach = std::min( reach, static_cast<std::size_t>( is_ask ? limit_idx - ladder.best + 1 : ladder.best - limit_idx + 1 ) );
+    }
+
+    const std::uint64_t* qty = ladder.qty.data() + best;
+    const SweepResult swept  = is_ask ? sweepAscending( qty, reach, remaining ) : sweepDescending( qty, reach, remaining );
+
+    // Bulk-remove the fully consumed levels: every maker fills completely, so
+    // the whole FIFO is spliced onto the free list instead of being unlinked
+    // node by node.
+    const std::int64_t step = is_ask ? 1 : -1;
+    std::int64_t last       = ladder.best;
+    for ( std::size_t k = 0; k < swept.levels; ++k )
+    {
+        const std::int64_t idx = ladder.best + static_cast<std::int64_t>( k ) * step;
+        Level& level           = ladder.levels[static_cast<std::size_t>( idx )];
+        if ( level.count == 0 )
+        {
+            continue;
+        }
+
+        // Tombstones in the FIFO go to the free list with the filled makers.
+        const OrderPrice price = toPrice( static_cast<Ticks>( ladder.base + idx ) );
+        for ( NodeIndex n = level.head; n != NilNode; n = nodes_[n].next )
+        {
+            Node& maker = nodes_[n];
+            if ( maker.tombstone )
+            {
+                maker.tombstone = false;
+                --tombstones_;
+                continue;
+            }
+            recordFill( order, n, price, maker.open(), now );
+            index_->erase( maker.id );
+        }
+        nodes_[level.tail].next = free_head_;
+        free_head_              = level.head;
+        resting_               -= level.count;
+        --ladder.non_empty;
+
+        level                                       = Level{};
+        ladder.qty[static_cast<std::size_t>( idx )] = 0;
+        last                                        = idx;
+    }
+
+    // levelEmptied() resumes the best-level scan past the swept range.
+    ++ladder.non_empty;
+    ladder.best = last;
+    levelEmptied( ladder, last );
+    return remaining - static_cast<NodeQty>( swept.volume );
+}
+
+NodeQty SimOrderBook::match( const Order& order, std::optional<Ticks> limit, NodeQty remaining, Timestamp now )
+{
+    const bool is_buy = order.side == Side::Buy;
+    Ladder& book_side = is_buy ? asks_ : bids_;
+
+    while ( remaining > 0 && book_side.best >= 0 )
+    {
+        const auto level_ticks = static_cast<Ticks>( book_side.base + book_side.best );
+        if ( limit && ( is_buy ? level_ticks > *limit : level_ticks < *limit ) )
+        {
+            break;
+        }
+
+        const std::int64_t level_idx = book_side.best;
+        std::uint64_t& level_qty     = book_side.qty[static_cast<std::size_t>( level_idx )];
+        if ( remaining >= level_qty )
+        {
+            // Takes at least the whole best level: size the sweep in one pass.
+            remaining = sweep( book_side, order, limit, remaining, now );
+            continue;
+        }
+
+        // Partial fill of the best level: walk its FIFO, reaping any
+        // tombstones met on the way.
+        const OrderPrice level_price = toPrice( level_ticks );
+        Level& level                 = book_side.levels[static_cast<std::size_t>( level_idx )];
+        while ( remaining > 0 )
+        {
+            const NodeIndex maker_idx = level.head;
+            Node& maker               = nodes_[maker_idx];
+            if ( maker.tombstone )
+            {
+                unlink( level, maker_idx );
+                freeNode( maker_idx );
+                --tombstones_;
+                continue;
+            }
+
+            const NodeQty fill = std::min( remaining, maker.open() );
+            recordFill( order, maker_idx, level_price, fill, now );
+            remaining -= fill;
+
+            if ( fill == maker.open() )
+            {
+                index_->erase( maker.id );
+                unlink( level, maker_idx );
+                freeNode( maker_idx );
+                level_qty -= fill;
+                --level.count;
+                --resting_;
+            }
+            else
+            {
+                maker.filled_qty += fill;
+                level_qty        -= fill;
+            }
+        }
+    }
+    return remaining;
+}
+
+SimOrderBook::SubmitResult SimOrderBook::submit( const Order& order, Timestamp now )
+{
+    const auto lots = toLots( order.quantity );
+    if ( !lots )
+    {
+        return SubmitResult::Rejected;
+    }
+
+    // Market orders carry no meaningful price and skip the tick check.
+    std::optional<Ticks> limit;
+    Ladder& own_side = order.side == Side::Buy ? bids_ : asks_;
+    if ( order.type == OrderType::Limit )
+    {
+        limit = toTicks( order.price );
+        if ( !limit || !ensureRange( own_side, *limit ) )
+        {
+            return SubmitResult::Rejected;
+        }
+    }
+
+    const NodeQty quantity  = *lots;
+    const NodeQty remaining = match( order, limit, quantity, now );
+    SubmitResult result     = SubmitResult::Filled;
+
+    if ( remaining > 0 && limit )
+    {
+        rest( order, *limit, quantity, quantity - remaining, now );
+        result = SubmitResult::Rested;
+    }
+    else if ( remaining > 0 )
+    {
+        result = SubmitResult::Expired;
+    }
+
+    refreshTopOfBook();
+    if ( compacting_ )
+    {
+        compactStep();
+    }
+    return result;
+}
+
+std::array<std::size_t, 4> SimOrderBook::submitAllocations( const Order& order ) const
+{
+    // Market orders never rest; an off-grid limit is rejected first.
+    std::array<std::size_t, 4> bytes{};
+    const std::optional<Ticks> limit = order.type == OrderType::Limit ? toTicks( order.price ) : std::nullopt;
+    if ( !limit )
+    {
+        return bytes;
+    }
+    const Ladder& own_side = order.side == Side::Buy ? bids_ : asks_;
+    if ( const auto growth = ladderGrowth( own_side, *limit ); growth && growth->first != 0 )
+    {
+        bytes[0] = growth->first * sizeof( Level );
+        bytes[1] = growth->first * sizeof( std::uint64_t );
+    }
+    if ( free_head_ == NilNode )
+    {
+        bytes[2] = nodes_.appendBytes();
+        bytes[3] = cold_.appendBytes();
+    }
+    return bytes;
+}
+
+void SimOrderBook::rest( const Order& order, Ticks price, NodeQty quantity, NodeQty filled, Timestamp accept_time )
+{
+    Ladder& own_side = order.side == Side::Buy ? bids_ : asks_;
+
+    const NodeIndex node_idx = allocateNode();
+    Node& node               = nodes_[node_idx];
+    node.id                  = order.id;
+    node.price               = price;
+    node.quantity            = quantity;
+    node.filled_qty          = filled;
+    node.side                = order.side;
+
+    ColdOrder& cold  = cold_[node_idx];
+    cold.trader_id   = order.trader_id;
+    cold.submit_time = order.submit_time;
+    cold.accept_time = accept_time;
+    cold.cl_ord_id   = order.cl_ord_id;
+    cold.tif         = order.tif;
+
+    const std::int64_t level_idx = static_cast<std::int64_t>( price ) - own_side.base;
+    Level& level                 = own_side.levels[static_cast<std::size_t>( level_idx )];
+    node.prev                    = level.tail;
+    node.next                    = NilNode;
+    if ( level.tail != NilNode )
+    {
+        nodes_[level.tail].next = node_idx;
+    }
+    else
+    {
+        level.head = node_idx;
+    }
+    level.tail                                         = node_idx;
+    own_side.qty[static_cast<std::size_t>( level_idx )] += quantity - filled;
+    if ( level.count++ == 0 )
+    {
+        levelFilled( own_side, level_idx );
+    }
+
+    index_->insert( order.id, { symbol_, node_idx } );
+    ++resting_;
+}
+
+void SimOrderBook::cancel( NodeIndex node_idx )
+{
+    // Lazy: mark the node and take its quantity off the level; its FIFO
+    // neighbours are not touched until matching or compact() reaps it.
+    Node& node                   = nodes_[node_idx];
+    Ladder& side                 = node.side == Side::Buy ? bids_ : asks_;
+    const std::int64_t level_idx = static_cast<std::int64_t>( node.price ) - side.base;
+    Level& level                 = side.levels[static_cast<std::size_t>( level_idx )];
+
+    node.tombstone = true;
+    side.qty[static_cast<std::size_t>( level_idx )] -= node.open();
+    --level.count;
+    --resting_;
+    ++tombstones_;
+    if ( level.count == 0 )
+    {
+        levelEmptied( side, level_idx );
+    }
+    refreshTopOfBook();
+
+    if ( !compacting_ && tombstones_ >= CompactionMinTombstones && tombstones_ > resting_ )
+    {
+        compacting_     = true;
+        compact_cursor_ = 0;
+    }
+    if ( compacting_ )
+    {
+        compactStep();
+    }
+}
+
+void SimOrderBook::compactStep()
+{
+    const NodeIndex end = static_cast<NodeIndex>( std::min<std::size_t>( nodes_.size(), std::size_t{ compact_cursor_ } + CompactionStepNodes ) );
+    for ( NodeIndex n = compact_cursor_; n < end && tombstones_ > 0; ++n )
+    {
+        const Node& node = nodes_[n];
+        if ( !node.tombstone )
+        {
+            continue;
+        }
+        Ladder& side                 = node.side == Side::Buy ? bids_ : asks_;
+        const std::int64_t level_idx = static_cast<std::int64_t>( node.price ) - side.base;
+        unlink( side.levels[static_cast<std::size_t>( level_idx )], n );
+        freeNode( n );
+        --tombstones_;
+    }
+    compact_cursor_ = end;
+    compacting_     = end < nodes_.size() && tombstones_ > 0;
+}
+
+void SimOrderBook::compact()
+{
+    compact_cursor_ = 0;
+    compacting_     = true;
+    while ( compacting_ )
+    {
+        compactStep();
+    }
+}
+
+void SimOrderBook::prefetchLevels( Side side, OrderPrice price ) const
+{
+    // Own level (where a remainder would rest) and the opposite best level
+    // (where matching would start).
+    const Ladder& own = side == Side::Buy ? bids_ : asks_;
+    if ( const auto ticks = toTicks( price ) )
+    {
+        const std::int64_t idx = static_cast<std::int64_t>( *ticks ) - own.base;
+        if ( idx >= 0 && static_cast<std::size_t>( idx ) < own.levels.size() )
+        {
+            prefetchForWrite( &own.levels[static_cast<std::size_t>( idx )] );
+        }
+    }
+
+    const Ladder& opposite = side == Side::Buy ? asks_ : bids_;
+    if ( opposite.best >= 0 )
+    {
+        prefetchForWrite( &opposite.levels[static_cast<std::size_t>( opposite.best )] );
+    }
+}
+
+void SimOrderBook::prefetchMatchHead( Side side ) const
+{
+    const Ladder& opposite = side == Side::Buy ? asks_ : bids_;
+    if ( opposite.best >= 0 )
+    {
+        prefetchNode( opposite.levels[static_cast<std::size_t>( opposite.best )].head );
+    }
+}
+
+void SimOrderBook::prefetchNode( NodeIndex node ) const
+{
+    if ( node < nodes_.size() )
+    {
+        prefetchForWrite( &nodes_[node] );
+    }
+}
+
+Order SimOrderBook::restingOrder( NodeIndex node_idx, const Symbol& symbol ) const
+{
+    const Node& node      = nodes_[node_idx];
+    const ColdOrder& cold = cold_[node_idx];
+
+    Order order{};
+    order.id          = node.id;
+    order.trader_id   = cold.trader_id;
+    order.symbol      = symbol;
+    order.side        = node.side;
+    order.type        = OrderType::Limit;
+    order.tif         = cold.tif;
+    order.price       = toPrice( node.price );
+    order.quantity    = static_cast<OrderQty>( node.quantity ) * spec_.lot_size;
+    order.filled_qty  = static_cast<OrderQty>( node.filled_qty ) * spec_.lot_size;
+    order.status      = node.filled_qty > 0 ? OrderStatus::PartiallyFilled : OrderStatus::New;
+    order.submit_time = cold.submit_time;
+    order.accept_time = cold.accept_time;
+    order.cl_ord_id   = cold.cl_ord_id;
+    return order;
+}
+
+std::vector<Order> SimOrderBook::exportOrders( const Symbol& symbol ) const
+{
+    std::vector<Order> orders;
+    orders.reserve( resting_ );
+    for ( const Ladder* ladder : { &bids_, &asks_ } )
+    {
+        const std::int64_t step = ladder->bid ? -1 : 1;
+        const auto size         = static_cast<std::int64_t>( ladder->levels.size() );
+        for ( std::int64_t i = ladder->best; i >= 0 && i < size; i += step )
+        {
+            for ( NodeIndex n = ladder->levels[static_cast<std::size_t>( i )].head; n != NilNode; n = nodes_[n].next )
+            {
+                if ( !nodes_[n].tombstone )
+                {
+                    orders.push_back( restingOrder( n, symbol ) );
+                }
+            }
+        }
+    }
+    return orders;
+}
+
+bool SimOrderBook::restore( const Order& order )
+{
+    // Same checks as submit(): a snapshot, a migration or a book file is no
+    // more trusted than an order.  A filled part is zero or whole lots.
+    const auto price  = toTicks( order.price );
+    const auto lots   = toLots( order.quantity );
+    const auto filled = order.filled_qty == 0 ? std::optional<NodeQty>( 0 ) : toLots( order.filled_qty );
+    if ( !price || !lots || !filled || *filled >= *lots )
+    {
+        return false;
+    }
+    Ladder& own_side = order.side == Side::Buy ? bids_ : asks_;
+    if ( !ensureRange( own_side, *price ) )
+    {
+        return false;
+    }
+
+    rest( order, *price, *lots, *filled, order.accept_time );
+    refreshTopOfBook();
+    return true;
+}
+
+void SimOrderBook::restoreTradeState( const MarketDataState& state )
+{
+    MarketDataState& md = market_data_;
+    md.last_trade_price = state.last_trade_price;
+    md.last_trade_qty   = state.last_trade_qty;
+    md.traded_volume    = state.traded_volume;
+    md.trade_count      = state.trade_count;
+}
+
+void SimOrderBook::refreshTopOfBook()
+{
+    MarketDataState& md = market_data_;
+
+    const auto top = [this]( const Ladder& ladder ) -> std::pair<OrderPrice, OrderQty>
+    {
+        if ( ladder.best < 0 )
+        {
+            return {};
+        }
+        const std::uint64_t lots = ladder.qty[static_cast<std::size_t>( ladder.best )];
+        return { toPrice( static_cast<Ticks>( ladder.base + ladder.best ) ), static_cast<OrderQty>( lots ) * spec_.lot_size };
+    };
+    const auto [bid, bid_qty] = top( bids_ );
+    const auto [ask, ask_qty] = top( asks_ );
+
+    if ( bid != md.best_bid || bid_qty != md.best_bid_qty || ask != md.best_ask || ask_qty != md.best_ask_qty )
+    {
+        md.best_bid     = bid;
+        md.best_bid_qty = bid_qty;
+        md.best_ask     = ask;
+        md.best_ask_qty = ask_qty;
+        ++md.tob_updates;
+    }
+}
+
+SimOrderBook::MemoryUsage SimOrderBook::memoryUsage() const
+{
+    return { .orders      = nodes_.capacity() * sizeof( Node ) + cold_.capacity() * sizeof( ColdOrder ),
+             .levels      = ( bids_.levels.capacity() + asks_.levels.capacity() ) * ( sizeof( Level ) + sizeof( std::uint64_t ) ),
+             .market_data = sizeof( MarketDataState ) };
+}
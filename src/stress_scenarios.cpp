@@ -0,0 +1,483 @@
+// ============================================================================
+// MarketMicrostructureEngine — Stress Scenario Library Implementation
+//
+// Scenarios are generated with VectorRng's scalar draws, so a config gives
+// the same events on every platform and standard library.  Replay feeds
+// the engine directly on the calling thread and times every measured
+// event in TscClock ticks, like the scaling benchmark, so the numbers are
+// the engine's own cost with no ring or thread hand-off.
+// ============================================================================
+
+#include <market/matching_engine.h>
+#include <sim_matching_engine.h>
+#include <stress_scenarios.h>
+#include <tsc_clock.h>
+#include <vector_rng.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <type_traits>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+constexpr Price MidPrice    = 10'000;
+constexpr Quantity OrderQty = 100;
+
+// Baselines: --engine=sim, default parameters, 200K events, -O3, measured on
+// the development host (x86-64, invariant TSC).  Hardware differs, so the
+// check is deliberately loose: 0.5x the throughput or 2x the p99.
+constexpr double MinThroughputRatio = 0.5;
+constexpr double MaxP99Ratio        = 2.0;
+
+constexpr std::array<StressScenarioInfo, 6> Library = { {
+    { "flash_crash", "bids pulled while marketable sells sweep one book, then a refill", 3, 50, 4, { 3'100'000.0, 680 } },
+    { "quote_stuffing", "one participant adds and cancels at the top of one book", 3, 50, 4, { 5'600'000.0, 320 } },
+    { "opening_burst", "an empty book meets a dense wave of crossing orders", 3, 0, 0, { 2'500'000.0, 750 } },
+    { "cancel_storm", "most resting liquidity cancelled and re-quoted wider after news", 3, 50, 4, { 4'300'000.0, 430 } },
+    { "book_depletion", "marketable buys consume the ask side of one book", 3, 50, 4, { 5'000'000.0, 470 } },
+    { "hot_symbol", "thousands of small books, nine events in ten on one", 5'000, 5, 2, { 1'700'000.0, 2'300 } },
+} };
+
+/// @brief Appends events to a Scenario while tracking which ids rest where,
+/// so cancels target real orders.
+class ScenarioBuilder
+{
+public:
+    ScenarioBuilder( std::size_t symbols, std::uint64_t seed ) : rng_( seed ), live_( symbols * 2 )
+    {
+        scenario_.symbols.reserve( symbols );
+        for ( std::size_t s = 0; s < symbols; ++s )
+        {
+            scenario_.symbols.push_back( "SYM" + std::to_string( s ) );
+        }
+    }
+
+    VectorRng& rng() { return rng_; }
+    std::uint32_t symbols() const { return static_cast<std::uint32_t>( scenario_.symbols.size() ); }
+    std::uint32_t randomSymbol() { return rng_.below( symbols() ); }
+    Side randomSide() { return rng_.below( 2 ) == 0 ? Side::Buy : Side::Sell; }
+    std::size_t events() const { return scenario_.events.size(); }
+
+    void wait( Timestamp ns ) { time_ += ns; }
+
+    void add( std::uint32_t symbol, Side side, Price price, Quantity qty = OrderQty )
+    {
+        const OrderId id = emit( ScenarioEventKind::Add, symbol, side, price, qty );
+        live_[slot( symbol, side )].push_back( id );
+    }
+
+    /// @brief Passive add @p offset ticks behind the mid.
+    void quote( std::uint32_t symbol, Side side, Price offset ) { add( symbol, side, side == Side::Buy ? MidPrice - offset : MidPrice + offset ); }
+
+    /// @brief Taker priced @p reach ticks through the mid; it replays as a
+    /// market order, so the price is only recorded in the scenario.
+    void take( std::uint32_t symbol, Side side, Price reach, Quantity qty = OrderQty )
+    {
+        emit( ScenarioEventKind::Trade, symbol, side, side == Side::Buy ? MidPrice + reach : MidPrice - reach, qty );
+    }
+
+    /// @brief Cancels a random live order of @p symbol / @p side; false if none.
+    bool cancel( std::uint32_t symbol, Side side )
+    {
+        auto& ids = live_[slot( symbol, side )];
+        if ( ids.empty() )
+        {
+            return false;
+        }
+        const std::uint32_t pick = rng_.below( static_cast<std::uint32_t>( ids.size() ) );
+        const OrderId id         = ids[pick];
+        ids[pick]                = ids.back();
+        ids.pop_back();
+
+        ScenarioEvent ev;
+        ev.time     = time_;
+        ev.kind     = ScenarioEventKind::Cancel;
+        ev.symbol   = symbol;
+        ev.side     = side;
+        ev.order_id = id;
+        scenario_.events.push_back( ev );
+        return true;
+    }
+
+    /// @brief Cancels the order added last on @p symbol / @p side.
+    void cancelNewest( std::uint32_t symbol, Side side )
+    {
+        auto& ids = live_[slot( symbol, side )];
+        assert( !ids.empty() );
+        ScenarioEvent ev;
+        ev.time     = time_;
+        ev.kind     = ScenarioEventKind::Cancel;
+        ev.symbol   = symbol;
+        ev.side     = side;
+        ev.order_id = ids.back();
+        ids.pop_back();
+        scenario_.events.push_back( ev );
+    }
+
+    /// @brief levels x orders_per_level passive orders per side on every symbol.
+    void seedBooks( std::size_t levels, std::size_t orders_per_level )
+    {
+        for ( std::uint32_t s = 0; s < symbols(); ++s )
+        {
+            for ( std::size_t level = 1; level <= levels; ++level )
+            {
+                for ( std::size_t n = 0; n < orders_per_level; ++n )
+                {
+                    quote( s, Side::Buy, static_cast<Price>( level ) );
+                    quote( s, Side::Sell, static_cast<Price>( level ) );
+                }
+            }
+        }
+    }
+
+    /// @brief One event of ordinary flow on @p symbol: half passive adds
+    /// within @p levels of the mid, four in ten cancels, one in ten small
+    /// marketable orders.
+    void background( std::uint32_t symbol, std::size_t levels )
+    {
+        const std::uint32_t roll = rng_.below( 10 );
+        const Side side          = randomSide();
+        if ( roll < 5 || ( roll < 9 && !cancel( symbol, side ) ) )
+        {
+            quote( symbol, side, 1 + static_cast<Price>( rng_.below( static_cast<std::uint32_t>( std::max<std::size_t>( levels, 1 ) ) ) ) );
+        }
+        else if ( roll >= 9 )
+        {
+            take( symbol, side, 1, 1 + rng_.below( OrderQty ) );
+        }
+    }
+
+    Scenario finish() { return std::move( scenario_ ); }
+
+private:
+    static std::size_t slot( std::uint32_t symbol, Side side ) { return symbol * 2 + ( side == Side::Buy ? 0 : 1 ); }
+
+    OrderId emit( ScenarioEventKind kind, std::uint32_t symbol, Side side, Price price, Quantity qty )
+    {
+        ScenarioEvent ev;
+        ev.time     = time_;
+        ev.kind     = kind;
+        ev.symbol   = symbol;
+        ev.side     = side;
+        ev.price    = price;
+        ev.quantity = qty;
+        ev.order_id = next_id_++;
+        scenario_.events.push_back( ev );
+        return ev.order_id;
+    }
+
+    VectorRng rng_;
+    Scenario scenario_;
+    std::vector<std::vector<OrderId>> live_;  // [symbol * 2 + side]
+    Timestamp time_{ 0 };
+    OrderId next_id_{ 1 };
+};
+
+// Each generator appends exactly `events` measured events after setup.
+
+void flashCrash( ScenarioBuilder& b, std::size_t events, std::size_t levels, std::size_t per_level )
+{
+    const std::size_t calm  = events / 5;
+    const std::size_t crash = events * 2 / 5;
+    const std::size_t end   = b.events() + events;
+
+    for ( std::size_t i = 0; i < calm; ++i, b.wait( 1'000 ) )
+    {
+        b.background( b.randomSymbol(), levels );
+    }
+    // Crash on SYM0: each step pulls a bid and sells through the whole
+    // ladder with enough size to clear about one level.
+    const Quantity sweep = static_cast<Quantity>( per_level ) * OrderQty;
+    for ( std::size_t i = 0; i < crash; ++i, b.wait( 200 ) )
+    {
+        if ( i % 2 == 0 && b.cancel( 0, Side::Buy ) )
+        {
+            continue;
+        }
+        b.take( 0, Side::Sell, static_cast<Price>( levels ) + 5, sweep );
+    }
+    // Refill: bids come back level by level, buyers lift the asks.
+    while ( b.events() < end )
+    {
+        if ( b.rng().below( 4 ) == 0 )
+        {
+            b.take( 0, Side::Buy, 1, OrderQty );
+        }
+        else
+        {
+            b.quote( 0, Side::Buy, 1 + static_cast<Price>( b.rng().below( static_cast<std::uint32_t>( levels ) ) ) );
+        }
+        b.wait( 500 );
+    }
+}
+
+void quoteStuffing( ScenarioBuilder& b, std::size_t events, std::size_t levels )
+{
+    const std::size_t end = b.events() + events;
+    while ( b.events() < end )
+    {
+        if ( b.rng().below( 10 ) == 0 || end - b.events() < 2 )
+        {
+            b.background( b.randomSymbol(), levels );
+            b.wait( 1'000 );
+            continue;
+        }
+        // Add at the best bid, cancel it 50 ns later.
+        b.quote( 0, Side::Buy, 1 );
+        b.wait( 50 );
+        b.cancelNewest( 0, Side::Buy );
+        b.wait( 50 );
+    }
+}
+
+void openingBurst( ScenarioBuilder& b, std::size_t events, std::size_t levels )
+{
+    // The burst is half the events: crossing orders on both sides within
+    // `band` ticks of the mid, with gaps widening from 20 ns to 200 ns.
+    const std::size_t burst = events / 2;
+    const auto band         = static_cast<std::uint32_t>( std::max<std::size_t>( levels, 10 ) );
+    for ( std::size_t i = 0; i < burst; ++i )
+    {
+        const Side side    = b.randomSide();
+        const Price offset = static_cast<Price>( b.rng().below( 2 * band + 1 ) ) - band;
+        b.add( b.randomSymbol(), side, MidPrice + offset, 1 + b.rng().below( OrderQty ) );
+        b.wait( 20 + 180 * i / burst );
+    }
+    for ( std::size_t i = burst; i < events; ++i, b.wait( 1'000 ) )
+    {
+        b.background( b.randomSymbol(), band );
+    }
+}
+
+void cancelStorm( ScenarioBuilder& b, std::size_t events, std::size_t levels )
+{
+    const std::size_t before = events / 5;
+    const std::size_t storm  = events * 3 / 5;
+    for ( std::size_t i = 0; i < before; ++i, b.wait( 1'000 ) )
+    {
+        b.background( b.randomSymbol(), levels );
+    }
+    // News: three events in four cancel resting liquidity anywhere; the
+    // rest re-quote between `levels` and 2 * `levels` ticks out.
+    for ( std::size_t i = 0; i < storm; ++i, b.wait( 100 ) )
+    {
+        const std::uint32_t symbol = b.randomSymbol();
+        const Side side            = b.randomSide();
+        if ( b.rng().below( 4 ) != 0 && b.cancel( symbol, side ) )
+        {
+            continue;
+        }
+        b.quote( symbol, side, static_cast<Price>( levels + 1 + b.rng().below( static_cast<std::uint32_t>( levels ) ) ) );
+    }
+    for ( std::size_t i = before + storm; i < events; ++i, b.wait( 1'000 ) )
+    {
+        b.background( b.randomSymbol(), 2 * levels );
+    }
+}
+
+void bookDepletion( ScenarioBuilder& b, std::size_t events, std::size_t levels )
+{
+    // Nine in ten events buy through every ask level of SYM0; the rest add
+    // bids.  No asks are added, so the side runs dry part way through.
+    for ( std::size_t i = 0; i < events; ++i, b.wait( 300 ) )
+    {
+        if ( b.rng().below( 10 ) == 0 )
+        {
+            b.quote( 0, Side::Buy, 1 + static_cast<Price>( b.rng().below( static_cast<std::uint32_t>( levels ) ) ) );
+        }
+        else
+        {
+            b.take( 0, Side::Buy, 2 * static_cast<Price>( levels ), OrderQty );
+        }
+    }
+}
+
+void hotSymbol( ScenarioBuilder& b, std::size_t events, std::size_t levels )
+{
+    for ( std::size_t i = 0; i < events; ++i, b.wait( 100 ) )
+    {
+        b.background( b.rng().below( 10 ) == 0 ? b.randomSymbol() : 0, levels );
+    }
+}
+
+std::uint64_t quantile( const std::vector<std::uint64_t>& sorted, double q, double ticks_per_ns )
+{
+    const auto idx = static_cast<std::size_t>( q * static_cast<double>( sorted.size() - 1 ) );
+    return static_cast<std::uint64_t>( static_cast<double>( sorted[idx] ) / ticks_per_ns );
+}
+
+/// @brief HFTToolset::MatchingEngine needs an HFTToolset::Clock; the sim
+/// engines stamp with the process's TscClock like the simulation does.
+template <typename Engine>
+Engine makeEngine( Clock& clock, TscClock& tsc )
+{
+    if constexpr ( std::is_same_v<Engine, MatchingEngine> )
+    {
+        return Engine( clock );
+    }
+    else
+    {
+        return Engine( tsc );
+    }
+}
+
+template <typename Engine>
+StressResult replay( const StressScenario& stress, Clock& clock, TscClock& tsc )
+{
+    Engine engine = makeEngine<Engine>( clock, tsc );
+    std::vector<Symbol> symbols;
+    symbols.reserve( stress.scenario.symbols.size() );
+    for ( const auto& name : stress.scenario.symbols )
+    {
+        engine.add_symbol( name.c_str() );
+        symbols.emplace_back( name.c_str() );
+    }
+
+    const auto dispatch = [&]( const ScenarioEvent& ev )
+    {
+        const EngineEvent event = toEngineEvent( ev, symbols[ev.symbol] );
+        if ( event.type == EventType::NewOrder )
+        {
+            engine.process_new_order( event.order );
+        }
+        else
+        {
+            engine.process_cancel( event.cancel );
+        }
+    };
+
+    const auto& events = stress.scenario.events;
+    for ( std::size_t i = 0; i < stress.setup_events; ++i )
+    {
+        dispatch( events[i] );
+    }
+
+    std::vector<std::uint64_t> ticks;
+    ticks.reserve( events.size() - stress.setup_events );
+    const std::uint64_t start = tsc.ticks();
+    for ( std::size_t i = stress.setup_events; i < events.size(); ++i )
+    {
+        const std::uint64_t t0 = tsc.ticks();
+        dispatch( events[i] );
+        ticks.push_back( tsc.ticks() - t0 );
+    }
+    const std::uint64_t elapsed = tsc.ticks() - start;
+
+    const double ticks_per_ns = tsc.ticksPerNs();
+    StressResult r;
+    r.name   = stress.info->name;
+    r.events = ticks.size();
+    if ( ticks.empty() )
+    {
+        return r;
+    }
+    double sum = 0.0;
+    for ( auto t : ticks )
+    {
+        sum += static_cast<double>( t );
+    }
+    std::sort( ticks.begin(), ticks.end() );
+    r.events_per_sec = static_cast<double>( ticks.size() ) * 1e9 * ticks_per_ns / static_cast<double>( elapsed );
+    r.mean_ns        = sum / static_cast<double>( ticks.size() ) / ticks_per_ns;
+    r.p50_ns         = quantile( ticks, 0.50, ticks_per_ns );
+    r.p99_ns         = quantile( ticks, 0.99, ticks_per_ns );
+    r.p999_ns        = quantile( ticks, 0.999, ticks_per_ns );
+    r.max_ns         = quantile( ticks, 1.0, ticks_per_ns );
+    return r;
+}
+
+}  // namespace
+
+std::span<const StressScenarioInfo> MarketMicroStructure::stressScenarios()
+{
+    return Library;
+}
+
+const StressScenarioInfo* MarketMicroStructure::findStressScenario( std::string_view name )
+{
+    const auto it = std::find_if( Library.begin(), Library.end(), [name]( const auto& info ) { return info.name == name; } );
+    return it == Library.end() ? nullptr : &*it;
+}
+
+StressScenario MarketMicroStructure::makeStressScenario( const StressScenarioInfo& info, const StressConfig& config )
+{
+    const std::size_t symbols   = config.symbols != 0 ? config.symbols : info.symbols;
+    const std::size_t levels    = config.levels != 0 ? config.levels : info.levels;
+    const std::size_t per_level = config.orders_per_level != 0 ? config.orders_per_level : info.orders_per_level;
+
+    ScenarioBuilder b( symbols, config.seed );
+    b.seedBooks( levels, per_level );
+    const std::size_t setup = b.events();
+
+    // Dispatch on the library's order.
+    switch ( &info - Library.data() )
+    {
+    case 0: flashCrash( b, config.events, levels, per_level ); break;
+    case 1: quoteStuffing( b, config.events, levels ); break;
+    case 2: openingBurst( b, config.events, levels ); break;
+    case 3: cancelStorm( b, config.events, levels ); break;
+    case 4: bookDepletion( b, config.events, levels ); break;
+    case 5: hotSymbol( b, config.events, levels ); break;
+    default: assert( false && "scenario not from stressScenarios()" );
+    }
+
+    return { .info = &info, .scenario = b.finish(), .setup_events = setup };
+}
+
+template <typename Engine>
+std::vector<StressResult> MarketMicroStructure::runStressBenchmark( std::span<const std::string> names, const StressConfig& config,
+                                                                    const std::string& save_dir, Clock& clock, TscClock& tsc,
+                                                                    std::ostream& out )
+{
+    // Baselines were recorded with the simulation engine at default sizes.
+    const bool comparable = std::is_same_v<Engine, SimMatchingEngine> && config.events == StressConfig{}.events && config.symbols == 0
+                            && config.levels == 0 && config.orders_per_level == 0;
+
+    std::vector<StressResult> results;
+    for ( const auto& info : stressScenarios() )
+    {
+        if ( !names.empty() && std::find( names.begin(), names.end(), info.name ) == names.end() )
+        {
+            continue;
+        }
+
+        const StressScenario stress = makeStressScenario( info, config );
+        if ( !save_dir.empty() )
+        {
+            const std::string path = save_dir + "/" + std::string( info.name ) + ".scenario";
+            if ( auto saved = saveScenario( path, stress.scenario ); !saved )
+            {
+                out << "[Stress] " << saved.error() << "\n";
+            }
+        }
+
+        StressResult r = replay<Engine>( stress, clock, tsc );
+        if ( comparable && info.baseline.events_per_sec > 0.0 )
+        {
+            r.within_baseline = r.events_per_sec >= MinThroughputRatio * info.baseline.events_per_sec
+                                && static_cast<double>( r.p99_ns ) <= MaxP99Ratio * static_cast<double>( info.baseline.p99_ns );
+        }
+
+        out << "[Stress] scenario=" << r.name << " setup_events=" << stress.setup_events << " events=" << r.events
+            << " events_per_sec=" << static_cast<std::uint64_t>( r.events_per_sec ) << " mean_ns=" << static_cast<std::uint64_t>( r.mean_ns )
+            << " p50_ns=" << r.p50_ns << " p99_ns=" << r.p99_ns << " p999_ns=" << r.p999_ns << " max_ns=" << r.max_ns;
+        if ( r.within_baseline )
+        {
+            out << " baseline_events_per_sec=" << static_cast<std::uint64_t>( info.baseline.events_per_sec )
+                << " baseline_p99_ns=" << info.baseline.p99_ns << " verdict=" << ( *r.within_baseline ? "ok" : "regressed" );
+        }
+        out << "\n";
+        results.push_back( r );
+        tsc.checkDrift();
+    }
+    return results;
+}
+
+template std::vector<StressResult> MarketMicroStructure::runStressBenchmark<MatchingEngine>( std::span<const std::string>, const StressConfig&,
+                                                                                            const std::string&, Clock&, TscClock&, std::ostream& );
+template std::vector<StressResult> MarketMicroStructure::runStressBenchmark<SimMatchingEngine>( std::span<const std::string>, const StressConfig&,
+                                                                                               const std::string&, Clock&, TscClock&, std::ostream& );
@@ -0,0 +1,142 @@
+// ============================================================================
+// MarketMicrostructureEngine — Per-Symbol Arena Implementation
+// ============================================================================
+
+#include <symbol_arena.h>
+#include <warmup.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+std::size_t alignUp( std::size_t value, std::size_t alignment )
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+}  // namespace
+
+SymbolArena::SymbolArena( MemoryAccount& account, std::size_t first_chunk_size )
+    : upstream_( account ), next_chunk_size_( std::max<std::size_t>( first_chunk_size, SmallBlockMax ) )
+{
+}
+
+SymbolArena::~SymbolArena()
+{
+    release();
+}
+
+void SymbolArena::reset()
+{
+    current_ = 0;
+    offset_  = 0;
+    free_lists_.fill( nullptr );
+}
+
+void SymbolArena::release()
+{
+    for ( const auto& chunk : chunks_ )
+    {
+        upstream_.deallocate( chunk.data, chunk.size, alignof( std::max_align_t ) );
+    }
+    chunks_.clear();
+    reserved_bytes_ = 0;
+    reset();
+}
+
+void SymbolArena::prefault( std::size_t bytes )
+{
+    // Append chunks without moving the bump position, so live allocations
+    // are untouched and the new chunks are used once the current one fills.
+    const std::size_t saved_current = current_;
+    const std::size_t saved_offset  = offset_;
+    while ( reserved_bytes_ < bytes )
+    {
+        addChunk( bytes - reserved_bytes_ );
+    }
+    current_ = saved_current;
+    offset_  = saved_offset;
+
+    for ( const auto& chunk : chunks_ )
+    {
+        prefaultPages( chunk.data, chunk.size );
+    }
+}
+
+std::size_t SymbolArena::usedBytes() const
+{
+    std::size_t used = offset_;
+    for ( std::size_t i = 0; i < current_ && i < chunks_.size(); ++i )
+    {
+        used += chunks_[i].size;
+    }
+    return used;
+}
+
+void* SymbolArena::do_allocate( std::size_t bytes, std::size_t alignment )
+{
+    bytes = std::max<std::size_t>( bytes, sizeof( FreeBlock ) );
+    if ( bytes <= SmallBlockMax && alignment <= SizeClassGranularity )
+    {
+        auto& head = free_lists_[sizeClass( bytes )];
+        if ( head )
+        {
+            FreeBlock* block = head;
+            head             = block->next;
+            return block;
+        }
+        // Size and alignment both at the class granularity, so the block
+        // can be recycled by any request of its class, whatever alignment
+        // (up to SizeClassGranularity) that request asks for.
+        return bump( alignUp( bytes, SizeClassGranularity ), SizeClassGranularity );
+    }
+    return bump( bytes, alignment );
+}
+
+void SymbolArena::do_deallocate( void* p, std::size_t bytes, std::size_t alignment )
+{
+    bytes = std::max<std::size_t>( bytes, sizeof( FreeBlock ) );
+    if ( bytes <= SmallBlockMax && alignment <= SizeClassGranularity )
+    {
+        auto& head  = free_lists_[sizeClass( bytes )];
+        auto* block = static_cast<FreeBlock*>( p );
+        block->next = head;
+        head        = block;
+    }
+    // Large blocks are reclaimed wholesale by reset()/release().
+}
+
+void* SymbolArena::bump( std::size_t bytes, std::size_t alignment )
+{
+    while ( current_ < chunks_.size() )
+    {
+        const Chunk& chunk = chunks_[current_];
+        const auto base    = reinterpret_cast<std::uintptr_t>( chunk.data );
+        const auto start   = alignUp( base + offset_, alignment ) - base;
+        if ( start + bytes <= chunk.size )
+        {
+            offset_ = start + bytes;
+            return chunk.data + start;
+        }
+        // Chunk exhausted (or kept from a previous session): move on.
+        ++current_;
+        offset_ = 0;
+    }
+
+    addChunk( bytes + alignment );
+    return bump( bytes, alignment );
+}
+
+void SymbolArena::addChunk( std::size_t min_bytes )
+{
+    const std::size_t size = std::max( next_chunk_size_, alignUp( min_bytes, SymbolArena::DefaultChunkSize ) );
+    auto* data             = static_cast<std::byte*>( upstream_.allocate( size, alignof( std::max_align_t ) ) );
+    chunks_.push_back( { data, size } );
+    current_         = chunks_.size() - 1;
+    offset_          = 0;
+    reserved_bytes_ += size;
+    next_chunk_size_ = std::min( next_chunk_size_ * 2, MaxChunkSize );
+}
@@ -0,0 +1,123 @@
+// ============================================================================
+// MarketMicrostructureEngine — TSC Clock Implementation
+//
+// Each anchor pairs one CLOCK_MONOTONIC reading with the midpoint of the two
+// TSC reads that bracket it, keeping the tightest of several attempts, so a
+// preemption during calibration does not skew the rate or the offset.
+// ============================================================================
+
+#include <tsc_clock.h>
+
+#include <algorithm>
+#include <ctime>
+#include <limits>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <cpuid.h>
+#endif
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+struct Anchor
+{
+    std::uint64_t tsc{ 0 };
+    Timestamp ns{ 0 };
+};
+
+Anchor takeAnchor()
+{
+    Anchor best;
+    std::uint64_t best_window = std::numeric_limits<std::uint64_t>::max();
+    for ( int attempt = 0; attempt < 16; ++attempt )
+    {
+        const std::uint64_t before = readTsc();
+        const Timestamp ns         = TscClock::monotonicNow();
+        const std::uint64_t after  = readTsc();
+        if ( after - before < best_window )
+        {
+            best_window = after - before;
+            best        = { before + ( after - before ) / 2, ns };
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+TscClock::TscClock() : TscClock( Config{} ) {}
+
+TscClock::TscClock( Config config ) : config_( config ), use_tsc_( invariantTscAvailable() )
+{
+    if ( use_tsc_ )
+    {
+        calibrate();
+    }
+}
+
+bool TscClock::invariantTscAvailable()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if ( __get_cpuid( 0x80000000, &eax, &ebx, &ecx, &edx ) == 0 || eax < 0x80000007 )
+    {
+        return false;
+    }
+    __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx );
+    return ( edx & ( 1u << 8 ) ) != 0;
+#else
+    return false;
+#endif
+}
+
+Timestamp TscClock::monotonicNow()
+{
+    timespec ts{};
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return static_cast<Timestamp>( ts.tv_sec ) * 1'000'000'000ULL + static_cast<Timestamp>( ts.tv_nsec );
+}
+
+void TscClock::calibrate()
+{
+    const Anchor start = takeAnchor();
+    const auto wait_ns = static_cast<Timestamp>( std::chrono::nanoseconds( config_.calibration ).count() );
+    while ( monotonicNow() - start.ns < wait_ns )
+    {
+    }
+    const Anchor end = takeAnchor();
+
+    const double ns    = static_cast<double>( end.ns - start.ns );
+    ticks_per_ns_      = ns > 0 ? static_cast<double>( end.tsc - start.tsc ) / ns : 1.0;
+    ns_per_tick_fixed_ = static_cast<std::uint64_t>( static_cast<double>( std::uint64_t{ 1 } << FixedShift ) / ticks_per_ns_ );
+    tsc_base_          = end.tsc;
+    ns_base_           = end.ns;
+}
+
+TscClock::DriftSample TscClock::sampleDrift()
+{
+    if ( !use_tsc_ )
+    {
+        return {};
+    }
+
+    const Anchor anchor = takeAnchor();
+    DriftSample sample;
+    sample.drift_ns = static_cast<std::int64_t>( toNanoseconds( anchor.tsc ) - anchor.ns );
+    ++drift_stats_.checks;
+    drift_stats_.max_drift_ns = std::max( drift_stats_.max_drift_ns, sample.drift_ns < 0 ? -sample.drift_ns : sample.drift_ns );
+    return sample;
+}
+
+TscClock::DriftSample TscClock::checkDrift()
+{
+    DriftSample sample = sampleDrift();
+    if ( sample.drift_ns > config_.max_drift.count() || -sample.drift_ns > config_.max_drift.count() )
+    {
+        calibrate();
+        sample.recalibrated = true;
+        ++drift_stats_.recalibrations;
+    }
+    return sample;
+}
@@ -0,0 +1,262 @@
+// ============================================================================
+// MarketMicrostructureEngine — Vectorized Random Generation Implementation
+//
+// AVX2 path: one step is the xoshiro256** update on four 256-bit rows, and
+// the bounded mapping runs _mm256_mul_epu32 on the even and (shifted) odd
+// 32-bit words, giving all eight 64-bit products per block.  The high
+// halves are the results; a block whose low halves all clear the rejection
+// threshold (every block, barring a ~bound / 2^32 chance per word) is
+// stored as is.  Rejected words are redrawn one at a time from a spare
+// block, in word order, by the same code on both paths.
+// ============================================================================
+
+#include <vector_rng.h>
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+using namespace MarketMicroStructure;
+
+namespace
+{
+constexpr std::uint64_t SplitMixGamma = 0x9E3779B97F4A7C15ULL;
+
+/// @brief Output @p index of the SplitMix64 sequence started at @p seed.
+constexpr std::uint64_t splitMixAt( std::uint64_t seed, std::uint64_t index )
+{
+    std::uint64_t z = seed + ( index + 1 ) * SplitMixGamma;
+    z               = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z               = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    return z ^ ( z >> 31 );
+}
+
+/// @brief Lemire's multiply-shift for one word; false if the word must be redrawn.
+inline bool boundedWord( std::uint32_t word, std::uint32_t bound, std::uint32_t threshold, std::uint32_t& out )
+{
+    const std::uint64_t product = static_cast<std::uint64_t>( word ) * bound;
+    out                         = static_cast<std::uint32_t>( product >> 32 );
+    return static_cast<std::uint32_t>( product ) >= threshold;
+}
+
+#if defined( __AVX2__ )
+inline __m256i load( const std::array<std::uint64_t, VectorRng::Lanes>& row )
+{
+    return _mm256_load_si256( reinterpret_cast<const __m256i*>( row.data() ) );
+}
+
+inline void store( std::array<std::uint64_t, VectorRng::Lanes>& row, __m256i x )
+{
+    _mm256_store_si256( reinterpret_cast<__m256i*>( row.data() ), x );
+}
+
+template <int K>
+inline __m256i rotlLanes( __m256i x )
+{
+    return _mm256_or_si256( _mm256_slli_epi64( x, K ), _mm256_srli_epi64( x, 64 - K ) );
+}
+#endif
+
+}  // namespace
+
+VectorRng::VectorRng( std::uint64_t seed, std::uint64_t stream ) : seed_( seed ), stream_( stream )
+{
+    for ( std::size_t lane = 0; lane < Lanes; ++lane )
+    {
+        const std::uint64_t first = ( stream * Lanes + lane ) * 4;
+        std::uint64_t any         = 0;
+        for ( std::size_t word = 0; word < 4; ++word )
+        {
+            state_[word][lane] = splitMixAt( seed, first + word );
+            any |= state_[word][lane];
+        }
+        // xoshiro's one forbidden state; SplitMix64 is a bijection, so this
+        // needs a vanishingly unlucky seed, but it must never happen.
+        if ( any == 0 )
+        {
+            state_[0][lane] = SplitMixGamma;
+        }
+    }
+}
+
+void VectorRng::step( std::uint64_t* out )
+{
+#if defined( __AVX2__ )
+    __m256i s0 = load( state_[0] );
+    __m256i s1 = load( state_[1] );
+    __m256i s2 = load( state_[2] );
+    __m256i s3 = load( state_[3] );
+
+    const __m256i times5 = _mm256_add_epi64( _mm256_slli_epi64( s1, 2 ), s1 );
+    const __m256i r      = rotlLanes<7>( times5 );
+    const __m256i result = _mm256_add_epi64( _mm256_slli_epi64( r, 3 ), r );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), result );
+
+    const __m256i t = _mm256_slli_epi64( s1, 17 );
+    s2              = _mm256_xor_si256( s2, s0 );
+    s3              = _mm256_xor_si256( s3, s1 );
+    s1              = _mm256_xor_si256( s1, s2 );
+    s0              = _mm256_xor_si256( s0, s3 );
+    s2              = _mm256_xor_si256( s2, t );
+    s3              = rotlLanes<45>( s3 );
+
+    store( state_[0], s0 );
+    store( state_[1], s1 );
+    store( state_[2], s2 );
+    store( state_[3], s3 );
+#else
+    auto& [s0, s1, s2, s3] = state_;
+    for ( std::size_t lane = 0; lane < Lanes; ++lane )
+    {
+        out[lane] = std::rotl( s1[lane] * 5, 7 ) * 9;
+
+        const std::uint64_t t = s1[lane] << 17;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = std::rotl( s3[lane], 45 );
+    }
+#endif
+}
+
+std::uint32_t VectorRng::spareWord()
+{
+    if ( spare_used_ == BlockWords )
+    {
+        alignas( 32 ) std::uint64_t raw[Lanes];
+        step( raw );
+        std::memcpy( spare_.data(), raw, sizeof( raw ) );
+        spare_used_ = 0;
+    }
+    return spare_[spare_used_++];
+}
+
+void VectorRng::boundedBlock( std::uint32_t* out, std::uint32_t bound, std::uint32_t threshold )
+{
+    alignas( 32 ) std::uint64_t raw[Lanes];
+    step( raw );
+
+    std::uint32_t rejected = 0;  // bit i: word i must be redrawn
+#if defined( __AVX2__ )
+    const __m256i words = _mm256_load_si256( reinterpret_cast<const __m256i*>( raw ) );
+    const __m256i range = _mm256_set1_epi64x( bound );
+    const __m256i even  = _mm256_mul_epu32( words, range );
+    const __m256i odd   = _mm256_mul_epu32( _mm256_srli_epi64( words, 32 ), range );
+    const __m256i high  = _mm256_blend_epi32( _mm256_srli_epi64( even, 32 ), odd, 0xAA );
+    const __m256i low   = _mm256_blend_epi32( even, _mm256_slli_epi64( odd, 32 ), 0xAA );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), high );
+
+    // low >= threshold  <=>  max(low, threshold) == low  (unsigned)
+    const __m256i keep = _mm256_cmpeq_epi32( _mm256_max_epu32( low, _mm256_set1_epi32( static_cast<int>( threshold ) ) ), low );
+    rejected           = ~static_cast<std::uint32_t>( _mm256_movemask_ps( _mm256_castsi256_ps( keep ) ) ) & 0xFF;
+#else
+    std::uint32_t words[BlockWords];
+    std::memcpy( words, raw, sizeof( raw ) );
+    for ( std::size_t i = 0; i < BlockWords; ++i )
+    {
+        rejected |= static_cast<std::uint32_t>( !boundedWord( words[i], bound, threshold, out[i] ) ) << i;
+    }
+#endif
+
+    for ( std::size_t i = 0; rejected != 0; ++i, rejected >>= 1 )
+    {
+        if ( rejected & 1 )
+        {
+            while ( !boundedWord( spareWord(), bound, threshold, out[i] ) )
+                ;
+        }
+    }
+}
+
+std::uint64_t VectorRng::next()
+{
+    if ( scalar_used_ == Lanes )
+    {
+        step( scalar_.data() );
+        scalar_used_ = 0;
+    }
+    return scalar_[scalar_used_++];
+}
+
+std::uint32_t VectorRng::below( std::uint32_t bound )
+{
+    assert( bound > 0 );
+    const std::uint32_t threshold = ( 0u - bound ) % bound;
+    std::uint32_t value;
+    while ( !boundedWord( static_cast<std::uint32_t>( next() >> 32 ), bound, threshold, value ) )
+        ;
+    return value;
+}
+
+double VectorRng::unit()
+{
+    return static_cast<double>( ( next() >> 11 ) + 1 ) * 0x1.0p-53;
+}
+
+void VectorRng::fill( std::uint64_t* out, std::size_t n )
+{
+    std::size_t i = 0;
+    for ( ; i + Lanes <= n; i += Lanes )
+    {
+        step( out + i );
+    }
+    if ( i < n )
+    {
+        alignas( 32 ) std::uint64_t tail[Lanes];
+        step( tail );
+        std::memcpy( out + i, tail, ( n - i ) * sizeof( std::uint64_t ) );
+    }
+}
+
+void VectorRng::fillBounded( std::uint32_t* out, std::size_t n, std::uint32_t bound )
+{
+    assert( bound > 0 );
+    const std::uint32_t threshold = ( 0u - bound ) % bound;  // 2^32 mod bound
+
+    std::size_t i = 0;
+    for ( ; i + BlockWords <= n; i += BlockWords )
+    {
+        boundedBlock( out + i, bound, threshold );
+    }
+    if ( i < n )
+    {
+        std::uint32_t tail[BlockWords];
+        boundedBlock( tail, bound, threshold );
+        std::memcpy( out + i, tail, ( n - i ) * sizeof( std::uint32_t ) );
+    }
+}
+
+void VectorRng::fillUniform( std::int64_t* out, std::size_t n, std::int64_t lo, std::int64_t hi )
+{
+    assert( lo <= hi && static_cast<std::uint64_t>( hi - lo ) < 0xFFFF'FFFFULL );
+    const auto bound              = static_cast<std::uint32_t>( hi - lo + 1 );
+    const std::uint32_t threshold = ( 0u - bound ) % bound;
+
+    for ( std::size_t i = 0; i < n; i += BlockWords )
+    {
+        alignas( 32 ) std::uint32_t block[BlockWords];
+        boundedBlock( block, bound, threshold );
+
+        const std::size_t count = n - i < BlockWords ? n - i : BlockWords;
+#if defined( __AVX2__ )
+        if ( count == BlockWords )
+        {
+            const __m256i base = _mm256_set1_epi64x( lo );
+            const __m128i* src = reinterpret_cast<const __m128i*>( block );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + i ), _mm256_add_epi64( _mm256_cvtepu32_epi64( src[0] ), base ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + i + 4 ), _mm256_add_epi64( _mm256_cvtepu32_epi64( src[1] ), base ) );
+            continue;
+        }
+#endif
+        for ( std::size_t j = 0; j < count; ++j )
+        {
+            out[i + j] = lo + static_cast<std::int64_t>( block[j] );
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// ============================================================================
+// MarketMicrostructureEngine — Warm-Up and Pre-Faulting Implementation
+// ============================================================================
+
+#include <warmup.h>
+
+#include <cerrno>
+#include <cstring>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+void MarketMicroStructure::prefaultPages( void* data, std::size_t bytes )
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    static const auto page = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+#else
+    constexpr std::size_t page = 4096;
+#endif
+    auto* bytes_ptr = static_cast<volatile unsigned char*>( data );
+    for ( std::size_t off = 0; off < bytes; off += page )
+    {
+        bytes_ptr[off] = bytes_ptr[off];
+    }
+}
+
+std::expected<void, std::string> MarketMicroStructure::lockAllMemory()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    if ( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 )
+    {
+        return std::unexpected( std::string( "mlockall failed: " ) + std::strerror( errno ) );
+    }
+    return {};
+#else
+    return std::unexpected( std::string( "mlockall is not supported on this platform" ) );
+#endif
+}
+
+WarmupFlow::WarmupFlow( std::span<const Symbol> symbols, std::uint64_t events ) : symbols_( symbols ), remaining_( events )
+{
+    issued_.reserve( events );
+}
+
+bool WarmupFlow::next( EngineEvent& ev )
+{
+    if ( remaining_ == 0 )
+    {
+        // Clean-up: cancel every id issued.  Ids that already filled or were
+        // cancelled come back as cancel rejects, which is harmless.
+        if ( cleanup_cursor_ == issued_.size() )
+        {
+            return false;
+        }
+        cancel( ev, cleanup_cursor_++ );
+        return true;
+    }
+    --remaining_;
+
+    std::uniform_int_distribution<std::size_t> symbol_dist( 0, symbols_.size() - 1 );
+    std::uniform_int_distribution<int> price_dist( 95, 105 );
+    std::uniform_int_distribution<int> qty_dist( 1, 100 );
+
+    ev = EngineEvent{};
+    if ( issued_.empty() || rng_() % 2 == 0 )
+    {
+        const OrderId id         = FirstWarmupId + issued_.size();
+        const std::size_t symbol = symbol_dist( rng_ );
+        issued_.push_back( symbol );
+
+        ev.type           = EventType::NewOrder;
+        ev.order          = Order{};
+        ev.order.id       = id;
+        ev.order.symbol   = symbols_[symbol];
+        ev.order.side     = rng_() % 2 == 0 ? Side::Buy : Side::Sell;
+        ev.order.type     = OrderType::Limit;
+        ev.order.tif      = TimeInForce::Day;
+        ev.order.price    = price_dist( rng_ );
+        ev.order.quantity = qty_dist( rng_ );
+        ev.order.status   = OrderStatus::New;
+    }
+    else
+    {
+        std::uniform_int_distribution<std::size_t> pick( 0, issued_.size() - 1 );
+        cancel( ev, pick( rng_ ) );
+    }
+    return true;
+}
+
+void WarmupFlow::cancel( EngineEvent& ev, std::size_t issued ) const
+{
+    ev                 = EngineEvent{};
+    ev.type            = EventType::CancelOrder;
+    ev.cancel.order_id = FirstWarmupId + issued;
+    ev.cancel.symbol   = symbols_[issued_[issued]];
+}
@@ -0,0 +1,177 @@
+// ============================================================================
+// MarketMicrostructureEngine — Book File Test
+//
+//   book_file        books kept in a mapped file match a heap engine fed the
+//                    same events, before and after a reattach
+//   storage_rejects  a 256 KiB file too small for the flow refuses orders
+//                    instead of failing an allocation, and still reattaches
+//                    with the same books
+// ============================================================================
+
+#include "test_support.h"
+
+#include <book_file.h>
+
+#include <new>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+TestResult checkBookFile( const std::string& dir, std::span<const SequencedEvent> events )
+{
+    const std::string path = dir + "/books.bin";
+    std::filesystem::remove( path );
+    const std::size_t split = events.size() * 4 / 5;
+
+    StepClock clock;
+    SimMatchingEngine reference( clock );
+    for ( const Symbol& symbol : TestSymbols )
+    {
+        reference.add_symbol( symbol.data );
+    }
+    for ( const SequencedEvent& ev : events.first( split ) )
+    {
+        apply( reference, ev.event );
+    }
+
+    std::uint64_t before = 0;
+    {
+        auto file = MappedBookFile::open( path, SimMatchingEngine::persistentLayout(), std::size_t{ 64 } << 20 );
+        if ( !file )
+        {
+            return std::unexpected( file.error() );
+        }
+        SimMatchingEngine engine( clock );
+        if ( const auto attached = engine.attach( **file ); !attached )
+        {
+            return std::unexpected( attached.error() );
+        }
+        for ( const Symbol& symbol : TestSymbols )
+        {
+            engine.add_symbol( symbol.data );
+        }
+        engine.reserve( 1024 );
+        for ( const SequencedEvent& ev : events.first( split ) )
+        {
+            apply( engine, ev.event );
+        }
+        before = digest( engine );
+        if ( before != digest( reference ) )
+        {
+            return std::unexpected( "a file-backed engine diverged from a heap engine fed the same events" );
+        }
+        ( *file )->flush();
+    }
+
+    // Reattach and keep going: cancels of restored orders go through the
+    // restored order index.
+    std::size_t resting = 0;
+    {
+        auto file = MappedBookFile::open( path, SimMatchingEngine::persistentLayout(), std::size_t{ 64 } << 20 );
+        if ( !file )
+        {
+            return std::unexpected( file.error() );
+        }
+        if ( !( *file )->restored() )
+        {
+            return std::unexpected( "'" + path + "' was not restored" );
+        }
+        SimMatchingEngine engine( clock );
+        if ( const auto attached = engine.attach( **file ); !attached )
+        {
+            return std::unexpected( attached.error() );
+        }
+        if ( digest( engine ) != before )
+        {
+            return std::unexpected( "the restored books differ from the ones written" );
+        }
+        for ( const SequencedEvent& ev : events.subspan( split ) )
+        {
+            apply( engine, ev.event );
+            apply( reference, ev.event );
+        }
+        if ( digest( engine ) != digest( reference ) )
+        {
+            return std::unexpected( "a restored engine diverged from the heap engine" );
+        }
+        for ( SymbolIndex s = 0; s < engine.symbolCount(); ++s )
+        {
+            resting += engine.book( s ).restingOrders();
+        }
+    }
+    return "events=" + str( events.size() ) + " resting=" + str( resting );
+}
+
+TestResult checkStorageRejects( const std::string& dir, std::span<const SequencedEvent> events )
+{
+    const std::string path = dir + "/small_books.bin";
+    std::filesystem::remove( path );
+
+    StepClock clock;
+    std::uint64_t storage_rejects = 0;
+    std::uint64_t written         = 0;
+    for ( int run = 0; run < 2; ++run )
+    {
+        auto file = MappedBookFile::open( path, SimMatchingEngine::persistentLayout(), std::size_t{ 256 } << 10 );
+        if ( !file )
+        {
+            return std::unexpected( file.error() );
+        }
+        SimMatchingEngine engine( clock );
+        if ( const auto attached = engine.attach( **file ); !attached )
+        {
+            return std::unexpected( attached.error() );
+        }
+        if ( run == 1 )
+        {
+            if ( digest( engine ) != written )
+            {
+                return std::unexpected( "the small file's books changed across a reattach" );
+            }
+            break;
+        }
+
+        for ( const Symbol& symbol : TestSymbols )
+        {
+            engine.add_symbol( symbol.data );
+        }
+        engine.reserve( 16'384 );
+        try
+        {
+            for ( const SequencedEvent& ev : events )
+            {
+                apply( engine, ev.event );
+            }
+        }
+        catch ( const std::bad_alloc& )
+        {
+            return std::unexpected( "a full book file failed an allocation mid-event" );
+        }
+        storage_rejects = engine.stats().storage_rejects;
+        written         = digest( engine );
+    }
+    if ( storage_rejects == 0 )
+    {
+        return std::unexpected( "the small book file never ran short; the test no longer covers storage rejects" );
+    }
+    return "file_bytes=" + str( std::size_t{ 256 } << 10 ) + " storage_rejects=" + str( storage_rejects );
+}
+
+}  // namespace
+
+int main( int argc, char** argv )
+{
+    TestReport report;
+    const auto dir = scratchDir( argc, argv, "book_file_test" );
+    if ( !dir )
+    {
+        report.add( "book_file", std::unexpected( dir.error() ) );
+        return report.exitCode();
+    }
+    const auto events = makeEvents( TestSymbols, 60'000, 5 );
+    report.add( "book_file", checkBookFile( *dir, events ) );
+    report.add( "storage_rejects", checkStorageRejects( *dir, events ) );
+    return report.exitCode();
+}
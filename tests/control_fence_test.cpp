@@ -0,0 +1,123 @@
+// ============================================================================
+// MarketMicrostructureEngine — Symbol Control Fence Test
+//
+// --list / --delist style controls posted to a running SimEventLoop, in
+// plain and prefetch dispatch, must leave the same books, stats and symbol
+// table as applying them inline, before the event they are fenced at.
+// ============================================================================
+
+#include "test_support.h"
+
+#include <sim_event_loop.h>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+struct ScheduledControl
+{
+    std::uint64_t at_event;
+    SymbolControl::Kind kind;
+    std::string_view name;
+};
+
+constexpr std::array<ScheduledControl, 5> Controls = { {
+    { 5'000, SymbolControl::Kind::List, "SOLUSD" },
+    { 12'000, SymbolControl::Kind::Delist, "BTCUSD" },
+    { 12'000, SymbolControl::Kind::List, "BTCUSD" },
+    { 20'000, SymbolControl::Kind::Delist, "SOLUSD" },
+    { 27'000, SymbolControl::Kind::Delist, "XAUUSD" },
+} };
+
+/// @brief An engine's symbol table as one line, for comparing two of them.
+std::string symbolState( const SimMatchingEngine& engine )
+{
+    std::string state = "symbols=";
+    const auto table  = engine.symbolTable();
+    for ( SymbolIndex i = 0; i < table->size; ++i )
+    {
+        const SymbolTable::Entry& entry = table->entry( i );
+        state += ( i == 0 ? "" : "," ) + entry.name + ( entry.listed ? "" : "(delisted,dropped=" + str( entry.dropped_orders ) + ")" );
+    }
+    return state;
+}
+
+TestResult checkControlFence()
+{
+    constexpr std::size_t Events = 30'000;
+
+    const std::array<Symbol, 4> flow_symbols = { Symbol( "XAUUSD" ), Symbol( "EURUSD" ), Symbol( "BTCUSD" ), Symbol( "SOLUSD" ) };
+    const auto events                        = makeEvents( flow_symbols, Events, 31 );
+
+    // Reference: controls applied inline, before the event they are fenced at.
+    StepClock clock;
+    SimMatchingEngine reference( clock );
+    for ( const Symbol& symbol : TestSymbols )
+    {
+        reference.add_symbol( symbol.data );
+    }
+    std::size_t next = 0;
+    for ( std::size_t i = 0; i < Events; ++i )
+    {
+        for ( ; next < Controls.size() && Controls[next].at_event <= i; ++next )
+        {
+            if ( Controls[next].kind == SymbolControl::Kind::List )
+            {
+                reference.add_symbol( Controls[next].name );
+            }
+            else
+            {
+                reference.remove_symbol( Controls[next].name );
+            }
+        }
+        apply( reference, events[i].event );
+    }
+    const std::string expected          = symbolState( reference );
+    const std::uint64_t expected_digest = digest( reference );
+
+    auto ring = makeEventLoopBuffer();
+    for ( const std::size_t distance : { std::size_t{ 0 }, std::size_t{ 8 } } )
+    {
+        SimMatchingEngine engine( clock );
+        for ( const Symbol& symbol : TestSymbols )
+        {
+            engine.add_symbol( symbol.data );
+        }
+        SimEventLoop loop( engine );
+        loop.setPrefetchDistance( distance );
+        auto task = loop.runAsync( *ring );
+
+        std::size_t posted = 0;
+        for ( std::size_t i = 0; i < Events; ++i )
+        {
+            for ( ; posted < Controls.size() && Controls[posted].at_event <= i; ++posted )
+            {
+                const auto control = SymbolControl::make( Controls[posted].kind, Controls[posted].name, i );
+                while ( !loop.postControl( control ) )
+                    ;
+            }
+            while ( !ring->push( events[i].event ) )
+                ;
+        }
+        while ( loop.processedCount() != Events || loop.controlsApplied() != posted )
+            ;
+        loop.setWaitForDone();
+        task.join();
+
+        if ( const std::string state = symbolState( engine ); state != expected || digest( engine ) != expected_digest )
+        {
+            return std::unexpected( "prefetch distance " + str( distance ) + ": the loop left other books or " + state + ", inline " + expected );
+        }
+    }
+    return "events=" + str( Events ) + " controls=" + str( Controls.size() ) + " dispatch_modes=2 " + expected;
+}
+
+}  // namespace
+
+int main()
+{
+    TestReport report;
+    report.add( "control_fence", checkControlFence() );
+    return report.exitCode();
+}
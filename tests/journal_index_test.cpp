@@ -0,0 +1,163 @@
+// ============================================================================
+// MarketMicrostructureEngine — Journal Index Test
+//
+// findOrder() and findTime() through a journal's .idx sidecar must return
+// exactly the records a full scan finds: on a closed journal, and on a
+// copy cut mid-block, both with the original sidecar (entries past the
+// last whole block are ignored) and with none (every entry is rebuilt).
+// ============================================================================
+
+#include "test_support.h"
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+OrderId referencedId( const EngineEvent& ev )
+{
+    return ev.type == EventType::CancelOrder ? ev.cancel.order_id : ev.order.id;
+}
+
+/// @brief Compares @p samples order and time lookups through @p index with
+/// a scan of @p events; adds the blocks each lookup decoded to @p decoded.
+std::expected<void, std::string> compareLookups( const JournalIndex& index, JournalReader& reader, std::span<const SequencedEvent> events,
+                                                 std::size_t samples, std::size_t& decoded )
+{
+    std::mt19937_64 rng( 23 );
+    std::vector<std::uint64_t> expected;
+    for ( std::size_t s = 0; s < samples; ++s )
+    {
+        const OrderId id = RandomFlow::MinId + rng() % ( RandomFlow::MaxId - RandomFlow::MinId + 1 );
+        expected.clear();
+        for ( std::uint64_t r = 0; r < events.size(); ++r )
+        {
+            if ( referencedId( events[r].event ) == id )
+            {
+                expected.push_back( r );
+            }
+        }
+        const auto found = index.findOrder( reader, id );
+        if ( !found )
+        {
+            return std::unexpected( found.error() );
+        }
+        if ( found->records != expected )
+        {
+            return std::unexpected( "findOrder( " + str( id ) + " ) found " + str( found->records.size() ) + " records, a scan " + str( expected.size() ) );
+        }
+        decoded += found->blocks_decoded;
+
+        const Timestamp first = events.front().event.event_time;
+        const Timestamp span  = events.back().event.event_time - first;
+        const Timestamp from  = first + rng() % span;
+        const Timestamp to    = from + 1 + rng() % ( span / 50 );
+        expected.clear();
+        for ( std::uint64_t r = 0; r < events.size(); ++r )
+        {
+            if ( events[r].event.event_time >= from && events[r].event.event_time < to )
+            {
+                expected.push_back( r );
+            }
+        }
+        const auto window = index.findTime( reader, from, to );
+        if ( !window )
+        {
+            return std::unexpected( window.error() );
+        }
+        if ( window->records != expected )
+        {
+            return std::unexpected( "findTime( " + str( from ) + ", " + str( to ) + " ) found " + str( window->records.size() ) + " records, a scan "
+                                    + str( expected.size() ) );
+        }
+        decoded += window->blocks_decoded;
+    }
+    return {};
+}
+
+TestResult checkJournalIndex( const std::string& dir, std::span<const SequencedEvent> events )
+{
+    constexpr std::size_t Samples = 100;
+
+    const std::string path = dir + "/events.journal";
+    if ( const auto written = writeJournal( path, events ); !written )
+    {
+        return std::unexpected( written.error() );
+    }
+    auto reader = JournalReader::open( path );
+    if ( !reader )
+    {
+        return std::unexpected( reader.error() );
+    }
+    auto index = JournalIndex::open( path, *reader );
+    if ( !index )
+    {
+        return std::unexpected( index.error() );
+    }
+    if ( index->rebuilt() != 0 || index->blocks() != reader->index().size() )
+    {
+        return std::unexpected( "the sidecar of a closed journal was incomplete" );
+    }
+    std::size_t decoded = 0;
+    if ( const auto same = compareLookups( *index, *reader, events, Samples, decoded ); !same )
+    {
+        return std::unexpected( "closed journal: " + same.error() );
+    }
+
+    const std::string crashed = dir + "/crashed.journal";
+    if ( const auto torn = writeCrashedCopy( path, crashed ); !torn )
+    {
+        return std::unexpected( torn.error() );
+    }
+    auto recovered = JournalReader::open( crashed );
+    if ( !recovered )
+    {
+        return std::unexpected( recovered.error() );
+    }
+    const auto prefix   = events.first( recovered->records() );
+    std::size_t rebuilt = 0;
+    for ( const bool sidecar : { true, false } )
+    {
+        std::error_code ec;
+        if ( sidecar )
+        {
+            std::filesystem::copy_file( JournalIndex::sidecarPath( path ), JournalIndex::sidecarPath( crashed ),
+                                        std::filesystem::copy_options::overwrite_existing, ec );
+        }
+        else
+        {
+            std::filesystem::remove( JournalIndex::sidecarPath( crashed ), ec );
+        }
+        auto partial = JournalIndex::open( crashed, *recovered );
+        if ( !partial )
+        {
+            return std::unexpected( partial.error() );
+        }
+        const std::size_t expected_rebuilt = sidecar ? 0 : recovered->index().size();
+        if ( partial->blocks() != recovered->index().size() || partial->rebuilt() != expected_rebuilt )
+        {
+            return std::unexpected( "recovered journal index has " + str( partial->blocks() ) + " blocks, " + str( partial->rebuilt() ) + " rebuilt" );
+        }
+        rebuilt += partial->rebuilt();
+        if ( const auto same = compareLookups( *partial, *recovered, prefix, Samples / 4, decoded ); !same )
+        {
+            return std::unexpected( std::string( sidecar ? "recovered journal: " : "rebuilt index: " ) + same.error() );
+        }
+    }
+    return "lookups=" + str( 2 * ( Samples + Samples / 2 ) ) + " blocks_decoded=" + str( decoded ) + " rebuilt_entries=" + str( rebuilt );
+}
+
+}  // namespace
+
+int main( int argc, char** argv )
+{
+    TestReport report;
+    const auto dir = scratchDir( argc, argv, "journal_index_test" );
+    if ( !dir )
+    {
+        report.add( "journal_index", std::unexpected( dir.error() ) );
+        return report.exitCode();
+    }
+    report.add( "journal_index", checkJournalIndex( *dir, makeEvents( TestSymbols, 60'000, 5 ) ) );
+    return report.exitCode();
+}
@@ -0,0 +1,151 @@
+// ============================================================================
+// MarketMicrostructureEngine — Journal Test
+//
+//   codec    block_codec.h round-trips zeros, random bytes and real journal
+//            records, and rejects a wrong size or too little room
+//   journal  a closed journal reads back every record through its trailer;
+//            the same file cut mid-block (no trailer) is recovered up to
+//            the last whole block
+// ============================================================================
+
+#include "test_support.h"
+
+#include <block_codec.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+TestResult checkCodec()
+{
+    std::mt19937_64 rng( 7 );
+    std::vector<std::vector<std::uint8_t>> inputs;
+    inputs.emplace_back( 64 * 1024, std::uint8_t{ 0 } );
+    inputs.emplace_back( 64 * 1024 );
+    std::generate( inputs.back().begin(), inputs.back().end(), [&rng] { return static_cast<std::uint8_t>( rng() ); } );
+    const auto events = makeEvents( TestSymbols, 60, 11 );
+    inputs.emplace_back( reinterpret_cast<const std::uint8_t*>( events.data() ),
+                         reinterpret_cast<const std::uint8_t*>( events.data() + events.size() ) );
+    const std::string_view text = "short";
+    inputs.emplace_back( text.begin(), text.end() );
+
+    std::size_t raw_total    = 0;
+    std::size_t stored_total = 0;
+    for ( std::size_t i = 0; i < inputs.size(); ++i )
+    {
+        const auto& input = inputs[i];
+        std::vector<std::uint8_t> stored( blockCompressBound( input.size() ) );
+        const std::size_t size = blockCompress( input.data(), input.size(), stored.data(), stored.size() );
+        if ( size == 0 )
+        {
+            return std::unexpected( "input " + str( i ) + " did not compress within blockCompressBound()" );
+        }
+        std::vector<std::uint8_t> raw( input.size() + 1 );
+        if ( !blockDecompress( stored.data(), size, raw.data(), input.size() ) || !std::equal( input.begin(), input.end(), raw.begin() ) )
+        {
+            return std::unexpected( "input " + str( i ) + " did not round-trip" );
+        }
+        if ( blockDecompress( stored.data(), size, raw.data(), input.size() + 1 ) )
+        {
+            return std::unexpected( "input " + str( i ) + " decoded to a size it was not compressed from" );
+        }
+        raw_total += input.size();
+        stored_total += size;
+    }
+
+    // Random bytes cannot shrink, so half their size is never enough room.
+    const auto& random = inputs[1];
+    std::vector<std::uint8_t> small( random.size() / 2 );
+    if ( blockCompress( random.data(), random.size(), small.data(), small.size() ) != 0 )
+    {
+        return std::unexpected( "random input reported as fitting in half its size" );
+    }
+    return "inputs=" + str( inputs.size() ) + " raw_bytes=" + str( raw_total ) + " stored_bytes=" + str( stored_total );
+}
+
+/// @brief Checks that @p reader holds exactly @p events, byte for byte.
+std::expected<void, std::string> compareRecords( JournalReader& reader, std::span<const SequencedEvent> events )
+{
+    if ( reader.records() != events.size() )
+    {
+        return std::unexpected( "holds " + str( reader.records() ) + " records, expected " + str( events.size() ) );
+    }
+    SequencedEvent record;
+    for ( std::uint64_t r = 0; r < events.size(); ++r )
+    {
+        if ( const auto read = reader.read( r, &record ); !read )
+        {
+            return std::unexpected( read.error() );
+        }
+        if ( std::memcmp( &record, &events[r], sizeof( record ) ) != 0 )
+        {
+            return std::unexpected( "record " + str( r ) + " differs" );
+        }
+    }
+    return {};
+}
+
+TestResult checkJournal( const std::string& dir, std::span<const SequencedEvent> events )
+{
+    const std::string path = dir + "/events.journal";
+    if ( const auto written = writeJournal( path, events ); !written )
+    {
+        return std::unexpected( written.error() );
+    }
+    auto closed = JournalReader::open( path );
+    if ( !closed )
+    {
+        return std::unexpected( closed.error() );
+    }
+    if ( closed->recovered() )
+    {
+        return std::unexpected( "a closed journal was read without its trailer" );
+    }
+    if ( const auto same = compareRecords( *closed, events ); !same )
+    {
+        return std::unexpected( "closed journal " + same.error() );
+    }
+
+    const std::string crashed = dir + "/crashed.journal";
+    const auto torn           = writeCrashedCopy( path, crashed );
+    if ( !torn )
+    {
+        return std::unexpected( torn.error() );
+    }
+    auto recovered = JournalReader::open( crashed );
+    if ( !recovered )
+    {
+        return std::unexpected( recovered.error() );
+    }
+    if ( !recovered->recovered() )
+    {
+        return std::unexpected( "a journal without a trailer was not recovered" );
+    }
+    if ( const auto same = compareRecords( *recovered, events.first( torn->first_record ) ); !same )
+    {
+        return std::unexpected( "recovered journal " + same.error() );
+    }
+    return "records=" + str( events.size() ) + " blocks=" + str( closed->index().size() ) + " cut_at_byte=" + str( torn->offset + torn->stored_bytes / 2 )
+         + " recovered_records=" + str( recovered->records() );
+}
+
+}  // namespace
+
+int main( int argc, char** argv )
+{
+    TestReport report;
+    report.add( "codec", checkCodec() );
+
+    const auto dir = scratchDir( argc, argv, "journal_test" );
+    if ( !dir )
+    {
+        report.add( "journal", std::unexpected( dir.error() ) );
+        return report.exitCode();
+    }
+    report.add( "journal", checkJournal( *dir, makeEvents( TestSymbols, 60'000, 5 ) ) );
+    return report.exitCode();
+}
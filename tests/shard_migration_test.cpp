@@ -0,0 +1,183 @@
+// ============================================================================
+// MarketMicrostructureEngine — Shard Migration Test
+//
+// Shard engines check order ids only against their own orders, so the same
+// id can rest on two shards under different symbols.
+//
+//   collision  a symbol whose ids already rest on the target shard stays
+//              on its old shard with every order, and its held events
+//              (cancels issued mid-migration) still apply there
+//   move       a symbol with fresh ids moves with its queue; its old
+//              shard's copy is dropped, so that shard accepts the same ids
+//              again afterwards
+// ============================================================================
+
+#include "test_support.h"
+
+#include <sharded_engine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+
+using namespace MarketMicroStructure;
+using namespace HFTToolset;
+
+namespace
+{
+/// @brief StepClock for several shard threads at once.
+struct SharedStepClock
+{
+    std::atomic<Timestamp> time{ 0 };
+    Timestamp now() { return time.fetch_add( 1'000, std::memory_order_relaxed ) + 1'000; }
+};
+
+/// @brief A buy below every other price used here: it always rests.
+EngineEvent newOrder( OrderId id, std::string_view symbol )
+{
+    EngineEvent ev;
+    ev.type           = EventType::NewOrder;
+    ev.order          = Order{};
+    ev.order.id       = id;
+    ev.order.symbol   = Symbol( std::string( symbol ).c_str() );
+    ev.order.side     = Side::Buy;
+    ev.order.type     = OrderType::Limit;
+    ev.order.tif      = TimeInForce::Day;
+    ev.order.price    = 90 + static_cast<Price>( id % 10 );
+    ev.order.quantity = 10;
+    ev.order.status   = OrderStatus::New;
+    return ev;
+}
+
+EngineEvent cancel( OrderId id, std::string_view symbol )
+{
+    EngineEvent ev;
+    ev.type            = EventType::CancelOrder;
+    ev.cancel.order_id = id;
+    ev.cancel.symbol   = Symbol( std::string( symbol ).c_str() );
+    return ev;
+}
+
+/// @brief Checks that @p symbol rests exactly the ids [first, last].
+std::expected<void, std::string> expectResting( const ShardedEngine& engine, SymbolIndex symbol, OrderId first, OrderId last )
+{
+    std::vector<OrderId> ids;
+    for ( const Order& order : engine.restingOrders( symbol ) )
+    {
+        ids.push_back( order.id );
+    }
+    std::ranges::sort( ids );
+    std::vector<OrderId> expected;
+    for ( OrderId id = first; id <= last; ++id )
+    {
+        expected.push_back( id );
+    }
+    if ( ids != expected )
+    {
+        return std::unexpected( engine.symbolName( symbol ) + " rests " + str( ids.size() ) + " orders, expected " + str( expected.size() ) );
+    }
+    return {};
+}
+
+constexpr OrderId Orders = 100;
+
+TestResult checkCollision()
+{
+    SharedStepClock clock;
+    ShardedEngine engine( clock, { .shards = 2, .rebalance_window = 0 } );
+    const SymbolIndex a = engine.add_symbol( "XAUUSD" );  // shard 0
+    const SymbolIndex b = engine.add_symbol( "EURUSD" );  // shard 1
+    engine.start();
+
+    for ( OrderId id = 1; id <= Orders; ++id )
+    {
+        engine.route( newOrder( id, "XAUUSD" ) );
+        engine.route( newOrder( id, "EURUSD" ) );
+    }
+    if ( !engine.migrate( a, engine.shardOf( b ) ) )
+    {
+        return std::unexpected( "the migration did not start" );
+    }
+    // Routed while the book is in transit: held, then applied wherever the
+    // book ends up.
+    for ( OrderId id = 1; id <= Orders / 2; ++id )
+    {
+        engine.route( cancel( id, "XAUUSD" ) );
+    }
+    engine.stop();
+
+    if ( engine.migrations().size() != 1 || engine.migrations()[0].restored || engine.shardOf( a ) != 0 )
+    {
+        return std::unexpected( "a migration onto colliding ids was not abandoned" );
+    }
+    if ( const auto same = expectResting( engine, a, Orders / 2 + 1, Orders ); !same )
+    {
+        return std::unexpected( same.error() );
+    }
+    if ( const auto same = expectResting( engine, b, 1, Orders ); !same )
+    {
+        return std::unexpected( same.error() );
+    }
+    if ( engine.stats().cancelled != Orders / 2 )
+    {
+        return std::unexpected( "held cancels: " + str( engine.stats().cancelled ) + " applied, expected " + str( Orders / 2 ) );
+    }
+    const ShardMigration& m = engine.migrations()[0];
+    return "orders=" + str( m.orders ) + " held=" + str( m.held ) + " restored=" + str( m.restored );
+}
+
+TestResult checkMove()
+{
+    SharedStepClock clock;
+    ShardedEngine engine( clock, { .shards = 2, .rebalance_window = 0 } );
+    const SymbolIndex a = engine.add_symbol( "XAUUSD" );  // shard 0
+    const SymbolIndex b = engine.add_symbol( "EURUSD" );  // shard 1
+    const SymbolIndex c = engine.add_symbol( "BTCUSD" );  // shard 0
+    engine.start();
+
+    for ( OrderId id = 1; id <= Orders; ++id )
+    {
+        engine.route( newOrder( id, "XAUUSD" ) );
+        engine.route( newOrder( Orders + id, "EURUSD" ) );
+    }
+    if ( !engine.migrate( a, engine.shardOf( b ) ) )
+    {
+        return std::unexpected( "the migration did not start" );
+    }
+    for ( OrderId id = 1; id <= Orders / 2; ++id )
+    {
+        engine.route( cancel( id, "XAUUSD" ) );
+    }
+    engine.drain();
+    // XAUUSD's ids are free on shard 0 only if its copy was dropped.
+    for ( OrderId id = 1; id <= Orders; ++id )
+    {
+        engine.route( newOrder( id, "BTCUSD" ) );
+    }
+    engine.stop();
+
+    if ( engine.migrations().size() != 1 || !engine.migrations()[0].restored || engine.shardOf( a ) != engine.shardOf( b ) )
+    {
+        return std::unexpected( "a migration onto free ids did not complete" );
+    }
+    for ( const auto& [symbol, first, last] :
+          { std::tuple{ a, Orders / 2 + 1, Orders }, std::tuple{ b, Orders + 1, 2 * Orders }, std::tuple{ c, OrderId{ 1 }, Orders } } )
+    {
+        if ( const auto same = expectResting( engine, symbol, first, last ); !same )
+        {
+            return std::unexpected( same.error() );
+        }
+    }
+    const ShardMigration& m = engine.migrations()[0];
+    return "orders=" + str( m.orders ) + " held=" + str( m.held ) + " restored=" + str( m.restored );
+}
+
+}  // namespace
+
+int main()
+{
+    TestReport report;
+    report.add( "collision", checkCollision() );
+    report.add( "move", checkMove() );
+    return report.exitCode();
+}
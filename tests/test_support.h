@@ -0,0 +1,172 @@
+#pragma once
+// ============================================================================
+// MarketMicrostructureEngine — Test Support
+//
+// Shared by the executables under tests/.  Each test compares one path of
+// the engine against an independent reference (a heap engine, a full scan,
+// an inline application of the same controls) fed the same deterministic
+// events, prints one "[Test]" line per check and exits nonzero if any
+// check failed.
+// ============================================================================
+
+#include <hot_standby.h>
+#include <journal.h>
+#include <random_flow.h>
+#include <sequencer.h>
+#include <sim_matching_engine.h>
+
+#include <common/types.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MarketMicroStructure
+{
+inline constexpr std::array<std::string_view, 4> TestSymbolNames = { "XAUUSD", "EURUSD", "BTCUSD", "SOLUSD" };
+inline const std::array<HFTToolset::Symbol, 3> TestSymbols       = { HFTToolset::Symbol( "XAUUSD" ), HFTToolset::Symbol( "EURUSD" ),
+                                                                     HFTToolset::Symbol( "BTCUSD" ) };
+
+/// A check's summary on success, or what went wrong.
+using TestResult = std::expected<std::string, std::string>;
+
+/// @brief Prints each check's "[Test]" line and counts the failures.
+class TestReport
+{
+public:
+    void add( std::string_view name, const TestResult& result )
+    {
+        std::cout << "[Test] " << name << " ok=" << result.has_value() << " " << ( result ? *result : "error=" + result.error() ) << "\n";
+        failed_ += result ? 0 : 1;
+    }
+
+    /// @brief Process exit code: 0 only if every check passed.
+    int exitCode() const
+    {
+        std::cout << "[Test] failed=" << failed_ << "\n";
+        return failed_ == 0 ? 0 : 1;
+    }
+
+private:
+    std::size_t failed_{ 0 };
+};
+
+/// @brief The scratch directory ctest passes as argv[1], or one under the
+/// system temp directory; created if needed.
+inline std::expected<std::string, std::string> scratchDir( int argc, char** argv, std::string_view name )
+{
+    const std::filesystem::path dir = argc > 1 ? std::filesystem::path( argv[1] ) : std::filesystem::temp_directory_path() / name;
+    std::error_code ec;
+    std::filesystem::create_directories( dir, ec );
+    if ( ec )
+    {
+        return std::unexpected( "cannot create '" + dir.string() + "': " + ec.message() );
+    }
+    return dir.string();
+}
+
+/// @brief Deterministic clock: every read is one microsecond later.
+struct StepClock
+{
+    HFTToolset::Timestamp time{ 0 };
+    HFTToolset::Timestamp now() { return time += 1'000; }
+};
+
+/// @brief @p count uniform-flow events over @p symbols, with event times
+/// that rise by a random 1-20 us step.
+inline std::vector<SequencedEvent> makeEvents( std::span<const HFTToolset::Symbol> symbols, std::size_t count, std::uint64_t seed )
+{
+    RandomFlow flow( symbols, seed );
+    std::mt19937_64 rng( seed );
+    std::vector<SequencedEvent> events( count );
+    HFTToolset::Timestamp time = 1'000'000;
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+        flow.next( events[i].event );
+        time += 1'000 * ( 1 + rng() % 20 );
+        events[i].sequence         = i;
+        events[i].event.event_time = time;
+    }
+    return events;
+}
+
+inline void apply( SimMatchingEngine& engine, const HFTToolset::EngineEvent& ev )
+{
+    if ( ev.type == HFTToolset::EventType::NewOrder )
+    {
+        engine.process_new_order( ev.order );
+    }
+    else
+    {
+        engine.process_cancel( ev.cancel );
+    }
+}
+
+inline std::uint64_t digest( const SimMatchingEngine& engine )
+{
+    return bookDigest( engine, TestSymbolNames );
+}
+
+inline std::string str( std::uint64_t value )
+{
+    return std::to_string( value );
+}
+
+/// @brief Writes @p events to a fresh events journal at @p path, in small
+/// blocks so a few thousand events span many of them.
+inline std::expected<void, std::string> writeJournal( const std::string& path, std::span<const SequencedEvent> events )
+{
+    const JournalConfig config{ .block_bytes = 16 * 1024, .staging_blocks = 4, .workers = 2 };
+    auto writer = JournalWriter::open( path, JournalKind::Events, sizeof( SequencedEvent ), config );
+    if ( !writer )
+    {
+        return std::unexpected( writer.error() );
+    }
+    for ( const SequencedEvent& ev : events )
+    {
+        ( *writer )->append( ev );
+    }
+    return ( *writer )->close();
+}
+
+/// @brief Copies the journal at @p path to @p crashed, cut two thirds of the
+/// way in, halfway through a block: the trailer and the torn block are
+/// gone, as after a crash.  Returns the torn block; every block before it
+/// must be recovered.
+inline std::expected<JournalBlock, std::string> writeCrashedCopy( const std::string& path, const std::string& crashed )
+{
+    auto closed = JournalReader::open( path );
+    if ( !closed )
+    {
+        return std::unexpected( closed.error() );
+    }
+    const std::vector<JournalBlock>& blocks = closed->index();
+    if ( blocks.size() < 3 )
+    {
+        return std::unexpected( "only " + str( blocks.size() ) + " blocks written" );
+    }
+    const JournalBlock torn = blocks[blocks.size() * 2 / 3];
+
+    std::error_code ec;
+    std::filesystem::remove( JournalIndex::sidecarPath( crashed ), ec );
+    std::filesystem::copy_file( path, crashed, std::filesystem::copy_options::overwrite_existing, ec );
+    if ( !ec )
+    {
+        std::filesystem::resize_file( crashed, torn.offset + torn.stored_bytes / 2, ec );
+    }
+    if ( ec )
+    {
+        return std::unexpected( "could not write '" + crashed + "': " + ec.message() );
+    }
+    return torn;
+}
+
+}  // namespace MarketMicroStructure